@@ -0,0 +1,53 @@
+#ifndef KI_CAS_ALLOCATION_TRACKER_H
+#define KI_CAS_ALLOCATION_TRACKER_H
+
+#include "ki_cas_numeric_allocator.h"
+
+#include <array>
+#include <cstdint>
+#include <stddef.h>
+
+namespace KiCAS2 {
+
+/// Number of power-of-two size classes in the allocation histogram
+inline constexpr size_t ALLOCATION_HISTOGRAM_SIZE = 16;
+
+/// Net bytes a thread may allocate or free before updating the shared peak
+inline constexpr int64_t ALLOCATION_PEAK_TOLERANCE_BYTES = 64 * 1024;
+
+/// Counters of tracked allocations from one source, summed over all threads.
+/// Flint does not report the size of memory it frees, so bytes are only counted for GMP.
+struct AllocationStats {
+    /// Bytes currently allocated
+    int64_t live_bytes = 0;
+
+    /// Highest live bytes observed. Each thread publishes its net allocation in batches,
+    /// so the peak may be underestimated by ALLOCATION_PEAK_TOLERANCE_BYTES per thread.
+    int64_t peak_bytes = 0;
+
+    size_t num_allocations = 0;
+    size_t num_reallocations = 0;
+    size_t num_frees = 0;
+
+    /// Allocations and reallocations by new size, where bucket i counts sizes in [2^(i+3), 2^(i+4)).
+    /// The first bucket also counts smaller sizes and the last bucket also counts larger sizes.
+    std::array<size_t, ALLOCATION_HISTOGRAM_SIZE> size_histogram = {};
+
+    /// Number of allocations which have not been freed
+    int64_t liveAllocations() const noexcept;
+};
+
+/// Layer the tracker over the installed numeric allocator, so that GMP and Flint allocations are counted.
+/// Has no effect if already installed. Call before other threads use GMP or Flint.
+/// Memory allocated before installation may still be freed, but counts as negative live memory.
+void install_allocation_tracker() noexcept;
+
+/// Return true if GMP and Flint allocations are routed through the tracker
+bool is_allocation_tracker_installed() noexcept;
+
+/// Sum the counters of every thread for the source, without blocking threads which are allocating
+AllocationStats allocation_stats(AllocationSource source = AllocationSource::Gmp) noexcept;
+
+}  // namespace KiCAS2
+
+#endif // KI_CAS_ALLOCATION_TRACKER_H
@@ -0,0 +1,157 @@
+#ifndef KI_CAS_BIG_NUM_EXPR_H
+#define KI_CAS_BIG_NUM_EXPR_H
+
+#include "ki_cas_big_num_owner.h"
+
+#include <concepts>
+
+// Arithmetic on Int and Rat builds lazy expressions, which are evaluated when assigned or accumulated,
+// so that common shapes map to fused Flint kernels and write into the storage of the destination.
+// Expressions refer to their operands, so they must be evaluated within the full expression creating them.
+
+namespace KiCAS2 {
+
+/// a + b or a - b
+struct IntSum {
+    const fmpz* a;
+    const fmpz* b;
+    bool subtract;
+
+    void evaluate(fmpz* dest) const;
+    void accumulate(fmpz* dest, bool subtract_sum) const;
+};
+
+/// a * b, which accumulates with fmpz_addmul or fmpz_submul
+struct IntProduct {
+    const fmpz* a;
+    const fmpz* b;
+
+    bool aliases(const fmpz* dest) const noexcept;
+    void evaluate(fmpz* dest) const;
+    void accumulate(fmpz* dest, bool subtract_product) const;
+};
+
+/// a * b for a word b, which accumulates with fmpz_addmul_ui or fmpz_submul_ui
+struct IntProductUi {
+    const fmpz* a;
+    ulong b;
+
+    bool aliases(const fmpz* dest) const noexcept;
+    void evaluate(fmpz* dest) const;
+    void accumulate(fmpz* dest, bool subtract_product) const;
+};
+
+template<typename T> concept IntProductExpression = std::same_as<T, IntProduct> || std::same_as<T, IntProductUi>;
+
+/// c + product, c - product, or product - c, evaluated by setting the destination to c and accumulating the product
+template<IntProductExpression Product> struct IntProductSum {
+    Product product;
+    const fmpz* c;
+    bool subtract_product;
+    bool negate;
+
+    void evaluate(fmpz* dest) const;
+    void accumulate(fmpz* dest, bool subtract_sum) const;
+};
+
+/// a*b + c*d or a*b - c*d, evaluated with fmpz_fmma or fmpz_fmms
+struct IntProductPair {
+    IntProduct first;
+    IntProduct second;
+    bool subtract;
+
+    void evaluate(fmpz* dest) const;
+    void accumulate(fmpz* dest, bool subtract_sum) const;
+};
+
+inline IntSum operator+(const Int& a, const Int& b) noexcept { return {a.get(), b.get(), false}; }
+inline IntSum operator-(const Int& a, const Int& b) noexcept { return {a.get(), b.get(), true}; }
+inline IntProduct operator*(const Int& a, const Int& b) noexcept { return {a.get(), b.get()}; }
+template<std::unsigned_integral Word> IntProductUi operator*(const Int& a, Word b) noexcept { return {a.get(), static_cast<ulong>(b)}; }
+template<std::unsigned_integral Word> IntProductUi operator*(Word a, const Int& b) noexcept { return {b.get(), static_cast<ulong>(a)}; }
+
+template<IntProductExpression Product> IntProductSum<Product> operator+(const Int& c, const Product& product) noexcept {
+    return {product, c.get(), false, false};
+}
+
+template<IntProductExpression Product> IntProductSum<Product> operator+(const Product& product, const Int& c) noexcept {
+    return {product, c.get(), false, false};
+}
+
+template<IntProductExpression Product> IntProductSum<Product> operator-(const Int& c, const Product& product) noexcept {
+    return {product, c.get(), true, false};
+}
+
+template<IntProductExpression Product> IntProductSum<Product> operator-(const Product& product, const Int& c) noexcept {
+    return {product, c.get(), true, true};
+}
+
+inline IntProductPair operator+(const IntProduct& first, const IntProduct& second) noexcept { return {first, second, false}; }
+inline IntProductPair operator-(const IntProduct& first, const IntProduct& second) noexcept { return {first, second, true}; }
+
+/// a + b or a - b
+struct RatSum {
+    const fmpq* a;
+    const fmpq* b;
+    bool subtract;
+
+    void evaluate(fmpq* dest) const;
+    void accumulate(fmpq* dest, bool subtract_sum) const;
+};
+
+/// a + b or a - b for an integer b, evaluated with fmpq_add_fmpz or fmpq_sub_fmpz
+struct RatIntSum {
+    const fmpq* a;
+    const fmpz* b;
+    bool subtract;
+
+    void evaluate(fmpq* dest) const;
+    void accumulate(fmpq* dest, bool subtract_sum) const;
+};
+
+/// a * b, which accumulates with fmpq_addmul or fmpq_submul
+struct RatProduct {
+    const fmpq* a;
+    const fmpq* b;
+
+    bool aliases(const fmpq* dest) const noexcept;
+    void evaluate(fmpq* dest) const;
+    void accumulate(fmpq* dest, bool subtract_product) const;
+};
+
+/// a * b for an integer b, evaluated with fmpq_mul_fmpz
+struct RatIntProduct {
+    const fmpq* a;
+    const fmpz* b;
+
+    void evaluate(fmpq* dest) const;
+    void accumulate(fmpq* dest, bool subtract_product) const;
+};
+
+/// c + a*b, c - a*b, or a*b - c, evaluated by setting the destination to c and accumulating the product
+struct RatProductSum {
+    RatProduct product;
+    const fmpq* c;
+    bool subtract_product;
+    bool negate;
+
+    void evaluate(fmpq* dest) const;
+    void accumulate(fmpq* dest, bool subtract_sum) const;
+};
+
+inline RatSum operator+(const Rat& a, const Rat& b) noexcept { return {a.get(), b.get(), false}; }
+inline RatSum operator-(const Rat& a, const Rat& b) noexcept { return {a.get(), b.get(), true}; }
+inline RatIntSum operator+(const Rat& a, const Int& b) noexcept { return {a.get(), b.get(), false}; }
+inline RatIntSum operator+(const Int& a, const Rat& b) noexcept { return {b.get(), a.get(), false}; }
+inline RatIntSum operator-(const Rat& a, const Int& b) noexcept { return {a.get(), b.get(), true}; }
+inline RatProduct operator*(const Rat& a, const Rat& b) noexcept { return {a.get(), b.get()}; }
+inline RatIntProduct operator*(const Rat& a, const Int& b) noexcept { return {a.get(), b.get()}; }
+inline RatIntProduct operator*(const Int& a, const Rat& b) noexcept { return {b.get(), a.get()}; }
+inline RatProductSum operator+(const Rat& c, const RatProduct& product) noexcept { return {product, c.get(), false, false}; }
+inline RatProductSum operator+(const RatProduct& product, const Rat& c) noexcept { return {product, c.get(), false, false}; }
+inline RatProductSum operator-(const Rat& c, const RatProduct& product) noexcept { return {product, c.get(), true, false}; }
+inline RatProductSum operator-(const RatProduct& product, const Rat& c) noexcept { return {product, c.get(), true, true}; }
+
+}  // namespace KiCAS2
+
+#endif // KI_CAS_BIG_NUM_EXPR_H
@@ -0,0 +1,225 @@
+#ifndef KI_CAS_BIG_NUM_OWNER_H
+#define KI_CAS_BIG_NUM_OWNER_H
+
+#ifdef _MSC_VER
+#include <malloc.h>  // MSC dependencies for GMP
+#endif
+
+#include <gmp.h>
+#include <flint/fmpq.h>
+#include <flint/fmpz.h>
+
+#include <utility>
+
+namespace KiCAS2 {
+
+/// A lazily evaluated integer expression, which writes its value to a destination or accumulates into it.
+/// See ki_cas_big_num_expr.h.
+template<typename T> concept IntExpression = requires(const T& expr, fmpz* dest, bool subtract) {
+    expr.evaluate(dest);
+    expr.accumulate(dest, subtract);
+};
+
+/// A lazily evaluated rational expression, which writes its value to a destination or accumulates into it.
+/// See ki_cas_big_num_expr.h.
+template<typename T> concept RatExpression = requires(const T& expr, fmpq* dest, bool subtract) {
+    expr.evaluate(dest);
+    expr.accumulate(dest, subtract);
+};
+
+/// Move-only owner of an fmpz, which is cleared on destruction.
+/// Holds only the fmpz word, and values which fit in the word are handled inline without calling Flint.
+/// A moved-from Int is zero.
+class Int {
+public:
+    constexpr Int() noexcept = default;
+
+    explicit Int(slong val) {
+        if(val >= COEFF_MIN && val <= COEFF_MAX) [[likely]] this->val = val;
+        else fmpz_set_si(&this->val, val);
+    }
+
+    /// Evaluate an expression
+    template<IntExpression Expr> Int(const Expr& expr) {
+        expr.evaluate(&val);
+    }
+
+    Int(Int&& other) noexcept : val(std::exchange(other.val, 0)) {}
+
+    Int& operator=(Int&& other) noexcept {
+        const fmpz taken = std::exchange(other.val, 0);
+        if(COEFF_IS_MPZ(val)) _fmpz_clear_mpz(val);
+        val = taken;
+        return *this;
+    }
+
+    Int(const Int&) = delete;
+    Int& operator=(const Int&) = delete;
+
+    /// Evaluate an expression, reusing the storage of the current value
+    template<IntExpression Expr> Int& operator=(const Expr& expr) {
+        expr.evaluate(&val);
+        return *this;
+    }
+
+    template<IntExpression Expr> Int& operator+=(const Expr& expr) {
+        expr.accumulate(&val, false);
+        return *this;
+    }
+
+    template<IntExpression Expr> Int& operator-=(const Expr& expr) {
+        expr.accumulate(&val, true);
+        return *this;
+    }
+
+    Int& operator+=(const Int& other) {
+        fmpz_add(&val, &val, &other.val);
+        return *this;
+    }
+
+    Int& operator-=(const Int& other) {
+        fmpz_sub(&val, &val, &other.val);
+        return *this;
+    }
+
+    ~Int() {
+        if(COEFF_IS_MPZ(val)) _fmpz_clear_mpz(val);
+    }
+
+    /// Take ownership of an fmpz, which the caller must no longer clear
+    static Int adopt(fmpz val) noexcept {
+        Int result;
+        result.val = val;
+        return result;
+    }
+
+    /// Give up ownership of the fmpz, which the caller must clear
+    fmpz release() noexcept {
+        return std::exchange(val, 0);
+    }
+
+    /// Copy the value, which allocates if it does not fit in the fmpz word
+    Int clone() const {
+        if(isSmall()) return adopt(val);
+        Int result;
+        fmpz_set(&result.val, &val);
+        return result;
+    }
+
+    /// The owned value, for passing to Flint as an fmpz_t
+    fmpz* get() noexcept { return &val; }
+
+    /// The owned value, for passing to Flint as a const fmpz_t
+    const fmpz* get() const noexcept { return &val; }
+
+    /// Return true if the value is stored in the fmpz word rather than a GMP integer
+    bool isSmall() const noexcept { return !COEFF_IS_MPZ(val); }
+
+private:
+    fmpz val = 0;
+};
+
+static_assert(sizeof(Int) == sizeof(fmpz), "Int must hold only the fmpz word");
+
+/// Move-only owner of an fmpq, which is cleared on destruction.
+/// Holds only the fmpq words, and values whose parts fit in their words are handled inline without calling Flint.
+/// A moved-from Rat is zero.
+class Rat {
+public:
+    constexpr Rat() noexcept = default;
+
+    /// Evaluate an expression
+    template<RatExpression Expr> Rat(const Expr& expr) {
+        expr.evaluate(&val);
+    }
+
+    Rat(Rat&& other) noexcept
+        : val{std::exchange(other.val.num, 0), std::exchange(other.val.den, 1)} {}
+
+    Rat& operator=(Rat&& other) noexcept {
+        const fmpz taken_num = std::exchange(other.val.num, 0);
+        const fmpz taken_den = std::exchange(other.val.den, 1);
+        if(COEFF_IS_MPZ(val.num)) _fmpz_clear_mpz(val.num);
+        if(COEFF_IS_MPZ(val.den)) _fmpz_clear_mpz(val.den);
+        val = {taken_num, taken_den};
+        return *this;
+    }
+
+    Rat(const Rat&) = delete;
+    Rat& operator=(const Rat&) = delete;
+
+    /// Evaluate an expression, reusing the storage of the current value
+    template<RatExpression Expr> Rat& operator=(const Expr& expr) {
+        expr.evaluate(&val);
+        return *this;
+    }
+
+    template<RatExpression Expr> Rat& operator+=(const Expr& expr) {
+        expr.accumulate(&val, false);
+        return *this;
+    }
+
+    template<RatExpression Expr> Rat& operator-=(const Expr& expr) {
+        expr.accumulate(&val, true);
+        return *this;
+    }
+
+    Rat& operator+=(const Rat& other) {
+        fmpq_add(&val, &val, &other.val);
+        return *this;
+    }
+
+    Rat& operator-=(const Rat& other) {
+        fmpq_sub(&val, &val, &other.val);
+        return *this;
+    }
+
+    ~Rat() {
+        if(COEFF_IS_MPZ(val.num)) _fmpz_clear_mpz(val.num);
+        if(COEFF_IS_MPZ(val.den)) _fmpz_clear_mpz(val.den);
+    }
+
+    /// Take ownership of an fmpq, which the caller must no longer clear
+    static Rat adopt(fmpq val) noexcept {
+        Rat result;
+        result.val = val;
+        return result;
+    }
+
+    /// Give up ownership of the fmpq, which the caller must clear
+    fmpq release() noexcept {
+        return fmpq{std::exchange(val.num, 0), std::exchange(val.den, 1)};
+    }
+
+    /// Copy the value, which allocates if a part does not fit in its fmpz word
+    Rat clone() const {
+        if(isSmall()) return adopt(val);
+        Rat result;
+        fmpq_set(&result.val, &val);
+        return result;
+    }
+
+    /// The owned value, for passing to Flint as an fmpq_t
+    fmpq* get() noexcept { return &val; }
+
+    /// The owned value, for passing to Flint as a const fmpq_t
+    const fmpq* get() const noexcept { return &val; }
+
+    /// The numerator, for passing to Flint as a const fmpz_t
+    const fmpz* numerator() const noexcept { return &val.num; }
+
+    /// The denominator, for passing to Flint as a const fmpz_t
+    const fmpz* denominator() const noexcept { return &val.den; }
+
+    /// Return true if the numerator and denominator are stored in their fmpz words rather than GMP integers
+    bool isSmall() const noexcept { return !COEFF_IS_MPZ(val.num) && !COEFF_IS_MPZ(val.den); }
+
+private:
+    fmpq val = {0, 1};
+};
+
+static_assert(sizeof(Rat) == sizeof(fmpq), "Rat must hold only the fmpq words");
+
+}  // namespace KiCAS2
+
+#endif // KI_CAS_BIG_NUM_OWNER_H
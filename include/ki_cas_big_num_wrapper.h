@@ -9,6 +9,9 @@
 #include <flint/fmpq.h>
 #include <flint/fmpz.h>
 
+#include "ki_cas_big_num_owner.h"
+#include "ki_cas_native_rational.h"
+#include "ki_cas_output_sink.h"
 #include "ki_cas_typesetting_flags.h"
 #include <string>
 #include <string_view>
@@ -42,6 +45,16 @@ size_t fmpz_sizeinbase10upperbound(const fmpz_t val) noexcept;
 /// Take the absolute value of an fmpq_t in place
 void fmpq_abs_inplace(fmpq_t val) noexcept;
 
+/// Raise an fmpq_t to a power, with word arithmetic when the power is predicted to fit, or with Flint otherwise
+void fmpq_pow_ui(fmpq_t result, const fmpq_t base, ulong power);
+
+/// Returns true if the base has no exact rational root, in which case the result is unchanged.
+/// Roots of word-sized rationals are taken with word arithmetic, and others with Flint.
+bool ckd_root(fmpq_t result, const fmpq_t base, ulong root);
+
+/// Returns true if the power is not an exact rational, in which case the result is unchanged, as ckd_root
+bool ckd_pow(fmpq_t result, const fmpq_t base, NativeRational exponent);
+
 /// Set an mpz_t from a string.
 void mpz_init_set_strview(mpz_t f, std::string_view str);
 
@@ -60,6 +73,24 @@ void write_big_int(std::string& str, const fmpz_t val);
 /// Append an fmpz to the end of the string
 void write_big_int(std::string& str, const fmpz val);
 
+/// Append an mpz_t to the sink
+void write_big_int(SinkRef sink, const mpz_t val);
+template<OutputSink Sink> void write_big_int(Sink& sink, const mpz_t val) {
+    write_big_int(SinkRef(sink), val);
+}
+
+/// Append an fmpz_t to the sink
+void write_big_int(SinkRef sink, const fmpz_t val);
+template<OutputSink Sink> void write_big_int(Sink& sink, const fmpz_t val) {
+    write_big_int(SinkRef(sink), val);
+}
+
+/// Append an fmpz to the sink
+void write_big_int(SinkRef sink, const fmpz val);
+template<OutputSink Sink> void write_big_int(Sink& sink, const fmpz val) {
+    write_big_int(SinkRef(sink), val);
+}
+
 /// Append an mpz_t to the end of the string, handling the sign to write an addition term
 void write_big_int_term(std::string& str, const mpz_t val);
 
@@ -72,6 +103,18 @@ template<bool typeset_fraction=false> void write_big_rational(std::string& str,
 /// Append an fmpq to the end of the string
 template<bool typeset_fraction=false> void write_big_rational(std::string& str, const fmpq val);
 
+/// Append an fmpq_t to the sink
+template<bool typeset_fraction=false> void write_big_rational(SinkRef sink, const fmpq_t val);
+template<bool typeset_fraction=false, OutputSink Sink> void write_big_rational(Sink& sink, const fmpq_t val) {
+    write_big_rational<typeset_fraction>(SinkRef(sink), val);
+}
+
+/// Append an fmpq to the sink
+template<bool typeset_fraction=false> void write_big_rational(SinkRef sink, const fmpq val);
+template<bool typeset_fraction=false, OutputSink Sink> void write_big_rational(Sink& sink, const fmpq val) {
+    write_big_rational<typeset_fraction>(SinkRef(sink), val);
+}
+
 /// Append an fmpq to the end of the string, handling the sign to write an addition term
 template<bool typeset_fraction=false> void write_big_rational_term(std::string& str, const fmpq val);
 
@@ -79,9 +122,11 @@ template<bool typeset_fraction=false> void write_big_rational_term(std::string&
 void write_big_rational_in_decimal_fmt(std::string& str, const fmpq val);
 
 /// Create an fmpq_t from a string of the form `(['0'-'9']+ '.' ['0'-'9']*) | ['0'-'9']* '.' ['0'-'9']+`..
+/// Temporaries use the arena of an enclosing GmpArenaScope, while the result is allocated outside of it.
 fmpq fmpq_from_decimal_str(std::string_view str);
 
 /// Create an fmpq_t from a string of the form `(['0'-'9']+ '.' ['0'-'9']*) | ['0'-'9']* '.' ['0'-'9']+`..
+/// Temporaries use the arena of an enclosing GmpArenaScope, while the result is allocated outside of it.
 fmpq fmpq_from_decimal_str(std::string_view str, size_t decimal_index);
 
 /// Create an fmpz from a string of the form `['0'-'9']+ 'e' ('+')? ['0'-'9']+`.
@@ -90,9 +135,26 @@ fmpz fmpz_from_scientific_str(std::string_view str);
 /// Create an fmpq_t from a string of the form:
 /// `['0'-'9']+ ('.' ['0'-'9']*)? 'e' ('+' | '-')? ['0'-'9']+`.
 /// or `'.' ['0'-'9']+ 'e' ('+' | '-')? ['0'-'9']+`
+/// Temporaries use the arena of an enclosing GmpArenaScope, while the result is allocated outside of it.
 fmpq fmpq_from_scientific_str(std::string_view str);
 
+/// Create an Int from a string, as fmpz_from_strview
+Int int_from_strview(std::string_view str);
+
+/// Create an Int from a string, as fmpz_from_scientific_str
+Int int_from_scientific_str(std::string_view str);
+
+/// Create a Rat from a string, as fmpq_from_decimal_str
+Rat rat_from_decimal_str(std::string_view str);
+
+/// Create a Rat from a string, as fmpq_from_decimal_str
+Rat rat_from_decimal_str(std::string_view str, size_t decimal_index);
+
+/// Create a Rat from a string, as fmpq_from_scientific_str
+Rat rat_from_scientific_str(std::string_view str);
+
 #if !defined(NDEBUG) && defined(TEST_GMP_LEAKS)
+// Free blocks kept by the GMP pool count as live, so trim or remove the pool before checking
 bool isAllGmpMemoryFreed() noexcept;  /// Return if all allocated GMP memory has been freed
 bool isAllGmpMemoryFreed_resetIfNot() noexcept;  /// Return if freed and reset to avoid cascading test failures
 #define LEAK_CHECK_REQUIRE(x) REQUIRE(x)
@@ -0,0 +1,95 @@
+#ifndef KI_CAS_BINARY_FORMAT_H
+#define KI_CAS_BINARY_FORMAT_H
+
+#ifdef _MSC_VER
+#include <malloc.h>  // MSC dependencies for GMP
+#endif
+
+#include <gmp.h>
+#include <flint/fmpq.h>
+#include <flint/fmpz.h>
+
+#include "ki_cas_native_rational.h"
+#include "ki_cas_output_sink.h"
+#include <stddef.h>
+#include <string_view>
+
+// Compact binary encoding of numbers, which is the same on every target:
+//   native integer: unsigned LEB128 varint
+//   NativeRational: numerator varint, then denominator varint
+//   fmpz: varint of (number of magnitude bytes << 1 | is_negative), then the magnitude as little-endian bytes
+//         with high zero bytes omitted, so that loading is a copy of the bytes into the limbs
+//   fmpq: numerator fmpz, then denominator fmpz
+// Readers consume bytes from the front of the view, and return true if the input is truncated or malformed,
+// in which case the view and result are unspecified.
+
+namespace KiCAS2 {
+
+/// Largest number of bytes in the varint encoding of a size_t
+inline constexpr size_t BINARY_VARINT_MAX_BYTES = (8*sizeof(size_t) + 6) / 7;
+
+/// Number of bytes of the encoding
+size_t binary_size(size_t val) noexcept;
+size_t binary_size(NativeRational val) noexcept;
+size_t binary_size(const fmpz_t val) noexcept;
+size_t binary_size(const fmpq_t val) noexcept;
+
+void write_binary_native_int(SinkRef sink, size_t val);
+template<OutputSink Sink> void write_binary_native_int(Sink& sink, size_t val) {
+    write_binary_native_int(SinkRef(sink), val);
+}
+
+void write_binary_native_rational(SinkRef sink, NativeRational val);
+template<OutputSink Sink> void write_binary_native_rational(Sink& sink, NativeRational val) {
+    write_binary_native_rational(SinkRef(sink), val);
+}
+
+void write_binary_big_int(SinkRef sink, const fmpz_t val);
+template<OutputSink Sink> void write_binary_big_int(Sink& sink, const fmpz_t val) {
+    write_binary_big_int(SinkRef(sink), val);
+}
+
+void write_binary_big_rational(SinkRef sink, const fmpq_t val);
+template<OutputSink Sink> void write_binary_big_rational(Sink& sink, const fmpq_t val) {
+    write_binary_big_rational(SinkRef(sink), val);
+}
+
+/// Write an array of numbers, preparing the sink once for the total size
+void write_binary_native_ints(SinkRef sink, const size_t* vals, size_t num_vals);
+template<OutputSink Sink> void write_binary_native_ints(Sink& sink, const size_t* vals, size_t num_vals) {
+    write_binary_native_ints(SinkRef(sink), vals, num_vals);
+}
+
+void write_binary_native_rationals(SinkRef sink, const NativeRational* vals, size_t num_vals);
+template<OutputSink Sink> void write_binary_native_rationals(Sink& sink, const NativeRational* vals, size_t num_vals) {
+    write_binary_native_rationals(SinkRef(sink), vals, num_vals);
+}
+
+void write_binary_big_ints(SinkRef sink, const fmpz* vals, size_t num_vals);
+template<OutputSink Sink> void write_binary_big_ints(Sink& sink, const fmpz* vals, size_t num_vals) {
+    write_binary_big_ints(SinkRef(sink), vals, num_vals);
+}
+
+void write_binary_big_rationals(SinkRef sink, const fmpq* vals, size_t num_vals);
+template<OutputSink Sink> void write_binary_big_rationals(Sink& sink, const fmpq* vals, size_t num_vals) {
+    write_binary_big_rationals(SinkRef(sink), vals, num_vals);
+}
+
+bool read_binary_native_int(size_t* result, std::string_view& bytes) noexcept;
+bool read_binary_native_rational(NativeRational* result, std::string_view& bytes) noexcept;
+
+/// The result must be initialised, and its storage is reused
+bool read_binary_big_int(fmpz_t result, std::string_view& bytes);
+
+/// The result must be initialised, and its storage is reused. The value is not checked to be canonical.
+bool read_binary_big_rational(fmpq_t result, std::string_view& bytes);
+
+/// Read an array of numbers into initialised results
+bool read_binary_native_ints(size_t* result, size_t num_vals, std::string_view& bytes) noexcept;
+bool read_binary_native_rationals(NativeRational* result, size_t num_vals, std::string_view& bytes) noexcept;
+bool read_binary_big_ints(fmpz* result, size_t num_vals, std::string_view& bytes);
+bool read_binary_big_rationals(fmpq* result, size_t num_vals, std::string_view& bytes);
+
+}  // namespace KiCAS2
+
+#endif // KI_CAS_BINARY_FORMAT_H
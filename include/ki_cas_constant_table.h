@@ -0,0 +1,80 @@
+#ifndef KI_CAS_CONSTANT_TABLE_H
+#define KI_CAS_CONSTANT_TABLE_H
+
+#ifdef _MSC_VER
+#include <malloc.h>  // MSC dependencies for GMP
+#endif
+
+#include <gmp.h>
+#include <flint/fmpz.h>
+
+#include "ki_cas_big_num_owner.h"
+#include "ki_cas_output_sink.h"
+#include <stddef.h>
+#include <stdint.h>
+#include <string_view>
+
+// Read-only tables of integer constants, such as factorials or Bernoulli numerators, which are mapped rather than
+// loaded. The limbs are stored in the native limb format, so entries are read in place as mpz views, and a copy is
+// made only when an entry is materialised for modification. The layout is:
+//   header: magic "KICASCT", format version, limb size in bytes, endianness, number of entries
+//   index: for each entry, the offset of its limbs from the start of the limb area, and its signed limb count
+//   limbs: the magnitudes of the entries, least significant limb first
+// Tables are not portable between targets with different limb sizes or endianness, which is detected on mapping.
+
+namespace KiCAS2 {
+
+inline constexpr uint32_t CONSTANT_TABLE_VERSION = 1;
+
+/// Write a table of the values to the sink, which should be a file or a buffer that is later mapped
+void write_constant_table(SinkRef sink, const fmpz* vals, size_t num_vals);
+template<OutputSink Sink> void write_constant_table(Sink& sink, const fmpz* vals, size_t num_vals) {
+    write_constant_table(SinkRef(sink), vals, num_vals);
+}
+
+/// A mapped table of integer constants. Views are valid while the table is mapped.
+class ConstantTable {
+public:
+    /// Location of the limbs of an entry in the table format
+    struct IndexEntry;
+
+    ConstantTable() noexcept = default;
+    ~ConstantTable();
+    ConstantTable(ConstantTable&& other) noexcept;
+    ConstantTable& operator=(ConstantTable&& other) noexcept;
+    ConstantTable(const ConstantTable&) = delete;
+    ConstantTable& operator=(const ConstantTable&) = delete;
+
+    /// Map a table file. Returns true if the file cannot be mapped or is not a valid table for this target.
+    /// Mapping reads the header and validates the index, but not the limbs, which are paged in as entries are used.
+    bool map(const char* path);
+
+    /// Use a table held in caller-owned memory aligned to a limb, which must outlive the table.
+    /// Returns true if the bytes are not a valid table for this target.
+    bool view(std::string_view bytes);
+
+    /// Unmap the table, invalidating all views
+    void reset() noexcept;
+
+    size_t size() const noexcept { return num_entries; }
+
+    /// Read-only view of an entry, reading the mapped limbs in place, for passing to GMP as a const mpz_t.
+    /// GMP functions which write to a read-only view are undefined.
+    MP_INT entry(size_t i) const noexcept;
+
+    /// Copy an entry into an owned integer, which may be modified
+    Int materialise(size_t i) const;
+
+private:
+    bool validate(const char* begin, size_t num_bytes) noexcept;
+
+    const IndexEntry* index = nullptr;
+    const mp_limb_t* limbs = nullptr;
+    size_t num_entries = 0;
+    void* mapping = nullptr;
+    size_t mapping_size = 0;
+};
+
+}  // namespace KiCAS2
+
+#endif // KI_CAS_CONSTANT_TABLE_H
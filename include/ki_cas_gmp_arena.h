@@ -0,0 +1,58 @@
+#ifndef KI_CAS_GMP_ARENA_H
+#define KI_CAS_GMP_ARENA_H
+
+#include <stddef.h>
+
+namespace KiCAS2 {
+
+/// Layer the arena over the installed numeric allocator, so that new GMP allocations on threads with an open
+/// GmpArenaScope are served by a thread-local arena. All other GMP allocations, and all Flint allocations,
+/// pass through to the allocator beneath. Has no effect if already installed. Call before other threads use GMP.
+void install_gmp_arena() noexcept;
+
+/// Return true if GMP allocations are routed through the arena, directly or beneath another layer
+bool is_gmp_arena_installed() noexcept;
+
+/// While alive, new GMP allocations on this thread bump-allocate from a thread-local arena,
+/// which rewinds to its state at construction when the scope ends, without freeing individual allocations.
+/// Values allocated within the scope must not outlive it, so results are allocated within a GmpArenaBypass.
+/// Flint integers must not be promoted within the scope, since Flint caches their limbs across calls.
+/// Scopes may be nested. Has no effect unless the arena is installed.
+class GmpArenaScope {
+public:
+    GmpArenaScope() noexcept;
+    ~GmpArenaScope();
+    GmpArenaScope(const GmpArenaScope&) = delete;
+    GmpArenaScope& operator=(const GmpArenaScope&) = delete;
+
+private:
+    size_t block_index;
+    size_t used;
+    bool was_allocating;
+};
+
+/// While alive, new GMP allocations on this thread bypass any open GmpArenaScope
+class GmpArenaBypass {
+public:
+    GmpArenaBypass() noexcept;
+    ~GmpArenaBypass();
+    GmpArenaBypass(const GmpArenaBypass&) = delete;
+    GmpArenaBypass& operator=(const GmpArenaBypass&) = delete;
+
+private:
+    bool was_allocating;
+};
+
+/// Allocation counts for the calling thread while the arena is installed
+struct GmpArenaStats {
+    size_t arena_allocations = 0;  ///< Allocations and reallocations served by the arena
+    size_t heap_allocations = 0;  ///< Allocations and reallocations passed through to the prior memory functions
+    size_t reserved_bytes = 0;  ///< Capacity of the arena blocks held by the thread
+};
+
+/// Return the allocation counts of the calling thread
+GmpArenaStats gmp_arena_stats() noexcept;
+
+}  // namespace KiCAS2
+
+#endif // KI_CAS_GMP_ARENA_H
@@ -0,0 +1,63 @@
+#ifndef KI_CAS_GMP_POOL_H
+#define KI_CAS_GMP_POOL_H
+
+#include <stddef.h>
+
+namespace KiCAS2 {
+
+/// Largest GMP allocation served by the pool, in limbs. Each limb count up to this is its own size class.
+inline constexpr size_t GMP_POOL_MAX_LIMBS = 16;
+
+/// Freed blocks a thread keeps per size class before returning a batch to the shared reclaim lists
+inline constexpr size_t GMP_POOL_THREAD_CACHE_BLOCKS = 64;
+
+/// Blocks moved at once between a thread and the shared reclaim lists
+inline constexpr size_t GMP_POOL_TRANSFER_BLOCKS = 32;
+
+/// Freed blocks kept per size class in the shared reclaim lists, beyond which blocks are freed
+inline constexpr size_t GMP_POOL_RECLAIM_BLOCKS = 4096;
+
+/// Layer the pool over the installed numeric allocator, so that GMP limb buffers of up to GMP_POOL_MAX_LIMBS limbs
+/// are recycled through per-thread free lists rather than the allocator beneath. Blocks are allocated individually
+/// from the allocator beneath, so GMP may free memory allocated before or after the pool is installed.
+/// Flint allocations pass through. Install before the GMP arena, since blocks from an arena must not be kept.
+/// Has no effect if already installed. Call before other threads use GMP.
+/// Returns true if the pool could not be installed because the arena is already installed.
+bool install_gmp_pool() noexcept;
+
+/// Return true if GMP allocations are routed through the pool, directly or beneath another layer
+bool is_gmp_pool_installed() noexcept;
+
+/// Return the free blocks of the calling thread and the shared reclaim lists to the allocator beneath.
+/// Called when a NumericAllocatorScope removes the pool. Blocks cached by other threads reach the reclaim lists on exit.
+void trim_gmp_pool() noexcept;
+
+/// While alive, GMP allocations and frees on this thread bypass the pool, for comparing against the allocator beneath
+class GmpPoolBypass {
+public:
+    GmpPoolBypass() noexcept;
+    ~GmpPoolBypass();
+    GmpPoolBypass(const GmpPoolBypass&) = delete;
+    GmpPoolBypass& operator=(const GmpPoolBypass&) = delete;
+
+private:
+    bool was_bypassing;
+};
+
+/// Allocation counts for the calling thread while the pool is installed
+struct GmpPoolStats {
+    size_t thread_hits = 0;  ///< Allocations served from the free lists of the thread
+    size_t reclaim_hits = 0;  ///< Allocations served from a batch taken from the shared reclaim lists
+    size_t misses = 0;  ///< Allocations of a pooled size passed to the allocator beneath
+    size_t unpooled = 0;  ///< Allocations too large or irregular to pool, or made within a GmpPoolBypass
+
+    /// Fraction of allocations of a pooled size which did not reach the allocator beneath
+    double hitRate() const noexcept;
+};
+
+/// Return the allocation counts of the calling thread
+GmpPoolStats gmp_pool_stats() noexcept;
+
+}  // namespace KiCAS2
+
+#endif // KI_CAS_GMP_POOL_H
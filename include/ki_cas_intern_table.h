@@ -0,0 +1,132 @@
+#ifndef KI_CAS_INTERN_TABLE_H
+#define KI_CAS_INTERN_TABLE_H
+
+#include "ki_cas_big_num_owner.h"
+#include "ki_cas_native_rational.h"
+#include "ki_cas_numeric_hash.h"
+
+#include <atomic>
+#include <mutex>
+#include <vector>
+
+// Hash-consing of numeric constants, so that equal values share one immutable, reference-counted instance.
+// Integers are interned as rationals with a denominator of 1, so an fmpz, an fmpq and a NativeRational
+// of equal value intern to the same instance.
+
+namespace KiCAS2 {
+
+/// An interned value, which is never modified while referenced
+struct InternNode {
+    std::atomic<size_t> refs;
+    size_t hash;
+    fmpq val;
+};
+
+/// A shared reference to an interned value. Handles to equal values from the same table point to the same node,
+/// so values compare by pointer. Handles must be destroyed before the table which interned them.
+class InternedNumber {
+public:
+    constexpr InternedNumber() noexcept = default;
+    InternedNumber(const InternedNumber& other) noexcept;
+    InternedNumber(InternedNumber&& other) noexcept;
+    InternedNumber& operator=(const InternedNumber& other) noexcept;
+    InternedNumber& operator=(InternedNumber&& other) noexcept;
+    ~InternedNumber();
+
+    /// The interned value, which is canonical, for passing to Flint as a const fmpq_t
+    const fmpq* get() const noexcept { return &node->val; }
+
+    /// The numerator, for passing to Flint as a const fmpz_t
+    const fmpz* numerator() const noexcept { return &node->val.num; }
+
+    /// The denominator, for passing to Flint as a const fmpz_t
+    const fmpz* denominator() const noexcept { return &node->val.den; }
+
+    /// Return true if the value is an integer, in which case numerator() is the value
+    bool isInteger() const noexcept { return fmpz_is_one(&node->val.den); }
+
+    /// The numeric_hash of the value, which is cached in the node
+    size_t hash() const noexcept { return node->hash; }
+
+    /// Return true if the handle refers to a value
+    explicit operator bool() const noexcept { return node != nullptr; }
+
+    friend bool operator==(const InternedNumber& a, const InternedNumber& b) noexcept { return a.node == b.node; }
+    friend bool operator!=(const InternedNumber& a, const InternedNumber& b) noexcept { return a.node != b.node; }
+
+private:
+    explicit InternedNumber(InternNode* node) noexcept : node(node) {}
+
+    InternNode* node = nullptr;
+
+    friend class InternTable;
+};
+
+inline size_t numeric_hash(const InternedNumber& val) noexcept { return val.hash(); }
+
+/// Contents of an intern table
+struct InternStats {
+    size_t values = 0;  ///< Interned values with at least one handle
+    size_t references = 0;  ///< Handles to interned values
+    size_t bytes = 0;  ///< Memory owned by the interned values, including nodes and GMP limbs
+    size_t bytes_saved = 0;  ///< GMP memory which the handles beyond the first would own as separate copies
+};
+
+/// Number of independently locked shards of an intern table, selected by the upper half of the hash
+inline constexpr size_t INTERN_TABLE_SHARDS = 64;
+
+/// A concurrent intern table. Lookups of values already interned are lock-free, and inserts lock only one shard.
+/// Values whose handles are all destroyed are reclaimed when their shard grows, or by collect().
+class InternTable {
+public:
+    InternTable();
+    ~InternTable();
+    InternTable(const InternTable&) = delete;
+    InternTable& operator=(const InternTable&) = delete;
+
+    InternedNumber intern(const fmpz* val);
+
+    /// Intern a canonical rational
+    InternedNumber intern(const fmpq* val);
+
+    /// Intern a rational, which need not be canonicalised
+    InternedNumber intern(NativeRational val);
+
+    /// Intern an integer, taking its storage if the value is not yet interned
+    InternedNumber intern(Int&& val);
+
+    /// Intern a canonical rational, taking its storage if the value is not yet interned
+    InternedNumber intern(Rat&& val);
+
+    /// Reclaim values whose handles are all destroyed, once no lookups are in progress
+    void collect();
+
+    InternStats stats() const;
+
+private:
+    struct Slots;
+
+    /// Lookups traverse the slots without locking. Memory unlinked from the slots is retired until
+    /// a moment when no lookup is in progress on the shard.
+    struct alignas(64) Shard {
+        std::atomic<Slots*> slots;
+        std::atomic<size_t> active_readers = 0;
+        mutable std::mutex mutex;
+        size_t occupied = 0;
+        std::vector<InternNode*> retired_nodes;
+        std::vector<Slots*> retired_slots;
+    };
+
+    InternedNumber find(const fmpq* val, size_t hash) noexcept;
+    InternedNumber insert(fmpq* val, size_t hash, bool take_storage);
+    static void sweep(Shard& shard);
+    static void grow(Shard& shard);
+    static void freeRetiredIfQuiescent(Shard& shard);
+    Shard& shardFor(size_t hash) noexcept;
+
+    Shard shards[INTERN_TABLE_SHARDS];
+};
+
+}  // namespace KiCAS2
+
+#endif // KI_CAS_INTERN_TABLE_H
@@ -6,10 +6,13 @@
 #endif
 
 #include <cinttypes>
+#include "ki_cas_big_num_owner.h"
+#include "ki_cas_output_sink.h"
 #include "ki_cas_test_hooks.h"
 #include <gmp.h>
 #include <flint/fmpz.h>
 #include <intx/intx.hpp>
+#include <bit>
 
 namespace KiCAS2 {
 
@@ -17,13 +20,74 @@ typedef intx::uint128 uint128_t;
 typedef intx::uint256 uint256_t;
 typedef intx::uint512 uint512_t;
 
+/// A read-only mpz over a copy of an intx value held on the stack, built with mpz_roinit_n, so no memory is allocated.
+/// The view points into itself, so it is neither copied nor moved. GMP functions which write to it are undefined.
+template<typename uintx_t> class MpzView {
+public:
+    explicit MpzView(const uintx_t& val, bool is_negative = false) noexcept : limbs(val) {
+        // A 64-bit word is stored as two 32-bit limbs, least significant first, so big-endian words are swapped
+        if constexpr(sizeof(mp_limb_t) != sizeof(uint64_t) && std::endian::native == std::endian::big)
+            for(unsigned i = 0; i < uintx_t::num_words; i++) limbs[i] = std::rotl(limbs[i], 32);
+
+        // mpz_roinit_n discards high zero limbs, so zero has size 0 regardless of sign
+        constexpr mp_size_t num_limbs = sizeof(uintx_t) / sizeof(mp_limb_t);
+        mpz_roinit_n(&view, reinterpret_cast<const mp_limb_t*>(&limbs[0]), is_negative ? -num_limbs : num_limbs);
+    }
+
+    MpzView(const MpzView&) = delete;
+    MpzView& operator=(const MpzView&) = delete;
+
+    /// The view, for passing to GMP as a const mpz_t
+    mpz_srcptr get() const noexcept { return &view; }
+
+private:
+    uintx_t limbs;
+    MP_INT view;
+};
+
+/// Read-only view of the value as an mpz, which does not allocate
+template<typename uintx_t> MpzView<uintx_t> mpz_view(const uintx_t& val, bool is_negative = false) noexcept {
+    return MpzView<uintx_t>(val, is_negative);
+}
+
 template<bool is_negative=false> void mpz_init_set_uint128(mpz_t lhs, uint128_t rhs);
 template<bool is_negative=false> void mpz_init_set_uint256(mpz_t lhs, uint256_t rhs);
 template<bool is_negative=false> void mpz_init_set_uint512(mpz_t lhs, uint512_t rhs);
+
+/// Convert to an fmpz, which is small if the value fits in a coefficient and otherwise promoted once to the exact size
+template<unsigned N, bool is_negative=false> fmpz uintN_to_fmpz(const intx::uint<N>& val);
 template<bool is_negative=false> fmpz u128_to_fmpz(uint128_t val);
 template<bool is_negative=false> fmpz u256_to_fmpz(uint256_t val);
+template<bool is_negative=false> fmpz u512_to_fmpz(const uint512_t& val);
+template<bool is_negative=false> Int u128_to_int(uint128_t val);
+template<bool is_negative=false> Int u256_to_int(uint256_t val);
+template<bool is_negative=false> Int u512_to_int(const uint512_t& val);
+
+/// Copy the magnitude of the value into a fixed-width integer and set is_negative to its sign.
+/// Returns true if the magnitude does not fit, in which case the outputs are unchanged.
+bool mpz_get_uint128(uint128_t* result, bool* is_negative, mpz_srcptr val) noexcept;
+bool mpz_get_uint256(uint256_t* result, bool* is_negative, mpz_srcptr val) noexcept;
+bool mpz_get_uint512(uint512_t* result, bool* is_negative, mpz_srcptr val) noexcept;
+bool fmpz_get_uint128(uint128_t* result, bool* is_negative, const fmpz_t val) noexcept;
+bool fmpz_get_uint256(uint256_t* result, bool* is_negative, const fmpz_t val) noexcept;
+bool fmpz_get_uint512(uint512_t* result, bool* is_negative, const fmpz_t val) noexcept;
+
+/// Set an integer from a string of the form `['0' - '9']+` with at most 38 digits, converted 19 digits at a time
+uint128_t knownfit_str2uint128(std::string_view str) noexcept;
+
+/// Set an integer from a string of the form `['0' - '9']+` with at most 77 digits, converted 19 digits at a time
+uint256_t knownfit_str2uint256(std::string_view str) noexcept;
+
 void write_uint128(std::string& str, uint128_t val);
 void write_uint256(std::string& str, uint256_t val);
+void write_uint128(SinkRef sink, uint128_t val);
+template<OutputSink Sink> void write_uint128(Sink& sink, uint128_t val) {
+    write_uint128(SinkRef(sink), val);
+}
+void write_uint256(SinkRef sink, uint256_t val);
+template<OutputSink Sink> void write_uint256(Sink& sink, uint256_t val) {
+    write_uint256(SinkRef(sink), val);
+}
 
 }
 
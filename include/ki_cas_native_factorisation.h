@@ -0,0 +1,50 @@
+#ifndef KI_CAS_NATIVE_FACTORISATION_H
+#define KI_CAS_NATIVE_FACTORISATION_H
+
+#include <stddef.h>
+#include <stdint.h>
+
+// Prime factorisation of words, for radical simplification such as sqrt(n) = k*sqrt(m).
+// Small words are factored by a smallest-prime-factor sieve. Larger words are trial divided by small primes, then
+// split by Pollard-Brent rho, with primality proved by deterministic Miller-Rabin. Recent factorisations of larger
+// words are memoised in a cache shared between threads.
+
+namespace KiCAS2 {
+
+/// Prime factorisation of a word, with the primes in increasing order
+struct NativeFactorisation {
+    /// The most distinct primes dividing a word, since the product of the first 16 primes exceeds 64 bits
+    static constexpr size_t MAX_FACTORS = sizeof(size_t) == 8 ? 15 : 9;
+
+    size_t primes[MAX_FACTORS];
+    uint8_t exponents[MAX_FACTORS];
+    uint8_t num_factors;
+};
+
+/// Factorise a nonzero word. One has no factors.
+void factorise(NativeFactorisation* result, size_t n) noexcept;
+
+/// Returns true if the word is prime
+bool is_prime(size_t n) noexcept;
+
+/// Returns the square-free m such that n = k^2 * m, setting k. Zero is 1^2 * 0.
+size_t square_free_part(size_t n, size_t* k) noexcept;
+
+/// Returns the m free of power-th powers such that n = k^power * m, setting k. Zero is 1^power * 0.
+size_t power_free_part(size_t n, size_t power, size_t* k) noexcept;
+
+/// Lookups of the factorisation cache, which only holds words too large for the sieve
+struct NativeFactorCacheStats {
+    size_t hits = 0;
+    size_t misses = 0;
+};
+
+/// Counts of cache lookups since the last clear
+NativeFactorCacheStats native_factor_cache_stats() noexcept;
+
+/// Empty the factorisation cache and reset its counts
+void clear_native_factor_cache() noexcept;
+
+}  // namespace KiCAS2
+
+#endif // KI_CAS_NATIVE_FACTORISATION_H
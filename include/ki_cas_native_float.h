@@ -1,30 +1,93 @@
 #ifndef KI_CAS_NATIVE_FLOAT_H
 #define KI_CAS_NATIVE_FLOAT_H
 
+#include "ki_cas_output_sink.h"
+#include <concepts>
+#include <cstdint>
+#include <limits>
 #include <string>
 
 namespace KiCAS2 {
 
 typedef long double FloatingPoint;
 
-/// Set the precision when converting floats to strings
+/// Notation used when converting floats to strings
+enum class FloatStyle : uint8_t {
+    General,     ///< Fixed or scientific, whichever is shorter, with `precision` significant digits
+    Fixed,       ///< Fixed notation with `precision` digits after the decimal point
+    Scientific,  ///< Scientific notation with `precision` digits after the decimal point
+    Shortest,    ///< The shortest representation which parses back to the same value, ignoring `precision`
+};
+
+/// Largest precision used when converting floats to strings, beyond which every digit of an exact binary float is zero.
+/// Larger precisions are clamped to it, which only omits trailing zeros.
+inline constexpr size_t MAX_FLOAT_PRECISION = std::numeric_limits<FloatingPoint>::max_exponent10 + 1
+    + std::numeric_limits<FloatingPoint>::digits - std::numeric_limits<FloatingPoint>::min_exponent;
+
+/// Formatting options when converting floats to strings
+struct FloatFormat {
+    size_t precision = 6;
+    FloatStyle style = FloatStyle::General;
+};
+
+/// Set the default format for the calling thread when converting floats to strings
+void set_float_format(FloatFormat format) noexcept;
+
+/// Get the default format for the calling thread when converting floats to strings
+FloatFormat get_float_format() noexcept;
+
+/// Set the default precision for the calling thread when converting floats to strings
 void set_float_string_precision(size_t precision_val) noexcept;
 
-/// Get the precision when converting floats to strings
+/// Get the default precision for the calling thread when converting floats to strings
 size_t get_float_string_precision() noexcept;
 
-/// Append a float to the end of the string
+/// Append a float to the end of the string using the thread's default format
 void write_float(std::string& str, FloatingPoint val);
 
+/// Append a float to the end of the string
+void write_float(std::string& str, FloatingPoint val, FloatFormat format);
+
+/// Append a float to the sink using the thread's default format
+void write_float(SinkRef sink, FloatingPoint val);
+template<OutputSink Sink> void write_float(Sink& sink, FloatingPoint val) {
+    write_float(SinkRef(sink), val);
+}
+
+/// Append a float to the sink
+void write_float(SinkRef sink, FloatingPoint val, FloatFormat format);
+template<OutputSink Sink> void write_float(Sink& sink, FloatingPoint val, FloatFormat format) {
+    write_float(SinkRef(sink), val, format);
+}
+
+/// Append the shortest string which parses back to the same value.
+/// Integers and short decimals take a fast path which bypasses the general algorithm.
+template<std::floating_point T> void write_float_shortest(std::string& str, T val);
+
+/// Append the shortest string which parses back to the same value to the sink
+template<std::floating_point T> void write_float_shortest(SinkRef sink, T val);
+template<std::floating_point T, OutputSink Sink> void write_float_shortest(Sink& sink, T val) {
+    write_float_shortest(SinkRef(sink), val);
+}
+
 /// Append a float to the end of the string, handling the sign to write an addition term
 void write_float_term(std::string& str, FloatingPoint val);
 
+/// Append a float to the end of the string, handling the sign to write an addition term
+void write_float_term(std::string& str, FloatingPoint val, FloatFormat format);
+
 /// Parse a string to a floating point number
 FloatingPoint strdecimal2floatingpoint(std::string_view str) noexcept;
 
 /// Parse a string to a floating point number
 FloatingPoint strscientific2floatingpoint(std::string_view str) noexcept;
 
+/// Parse a string to the nearest double
+double strdecimal2double(std::string_view str) noexcept;
+
+/// Parse a string to the nearest double
+double strscientific2double(std::string_view str) noexcept;
+
 }
 
 #endif // KI_CAS_NATIVE_FLOAT_H
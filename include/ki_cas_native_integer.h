@@ -1,6 +1,7 @@
 #ifndef KI_CAS_NATIVE_INTEGER_H
 #define KI_CAS_NATIVE_INTEGER_H
 
+#include "ki_cas_output_sink.h"
 #include <stdint.h>
 #include <stddef.h>
 #include <string>
@@ -19,15 +20,36 @@ size_t knownfit_mul(size_t a, size_t b) noexcept;
 /// Incudes debug assertion that the calculation does not underflow
 size_t knownfit_sub(size_t a, size_t b) noexcept;
 
-/// Returns true if no pure integer root exists
+/// Returns true if no pure integer root exists, in which case the result is unspecified
 bool ckd_sqrt(size_t* result, size_t arg) noexcept;
 
-/// Returns true if no pure integer root exists
+/// Returns true if no pure integer root exists, in which case the result is unspecified
 bool ckd_cbrt(size_t* result, size_t arg) noexcept;
 
-/// Returns true if no pure integer root exists
+/// Set each result and is_inexact flag as the single-argument ckd_sqrt. Candidates are screened by their residues
+/// before any root is taken. Returns the number which pass the screen, to measure the filter pass rate.
+size_t ckd_sqrt(size_t* results, bool* is_inexact, const size_t* args, size_t num_args) noexcept;
+
+/// Set each result and is_inexact flag as the single-argument ckd_cbrt. Candidates are screened by their residues
+/// before any root is taken. Returns the number which pass the screen, to measure the filter pass rate.
+size_t ckd_cbrt(size_t* results, bool* is_inexact, const size_t* args, size_t num_args) noexcept;
+
+/// Returns true if no pure integer root exists, in which case the result is unspecified
 bool ckd_nrt(size_t* result, size_t arg, size_t power) noexcept;
 
+/// The largest integer whose power does not exceed the argument, found by Newton iteration without floating point
+size_t floor_nrt(size_t arg, size_t power) noexcept;
+
+/// Returns the largest exponent k > 1 such that arg = root^k, setting the root, or 0 if there is none.
+/// Zero and one are powers of any exponent, so are reported as 0.
+size_t is_perfect_power(size_t* root, size_t arg) noexcept;
+
+/// Set the largest exponent and root of each argument, as the single-argument is_perfect_power
+void is_perfect_power(size_t* exponents, size_t* roots, const size_t* args, size_t num_args) noexcept;
+
+/// Returns true if base^power does not fit, decided by table lookup without computing the power
+bool pow_overflows(size_t base, size_t power) noexcept;
+
 /// Returns true if the calculation overflows
 bool ckd_pow(size_t* result, size_t base, size_t power) noexcept;
 
@@ -37,6 +59,12 @@ size_t knownfit_pow(size_t base, size_t power) noexcept;
 /// Append an integer to the end of the string
 void write_native_int(std::string& str, size_t val);
 
+/// Append an integer to the sink
+void write_native_int(SinkRef sink, size_t val);
+template<OutputSink Sink> void write_native_int(Sink& sink, size_t val) {
+    write_native_int(SinkRef(sink), val);
+}
+
 /// Set an integer from a string of the form `['0' - '9']+`. Returns true if the value is too large to fit.
 bool ckd_str2int(size_t* result, std::string_view str) noexcept;
 
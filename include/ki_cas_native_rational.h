@@ -1,6 +1,7 @@
 #ifndef KI_CAS_NATIVE_RATIONAL_H
 #define KI_CAS_NATIVE_RATIONAL_H
 
+#include "ki_cas_output_sink.h"
 #include "ki_cas_typesetting_flags.h"
 #include <stddef.h>
 #include <string>
@@ -82,9 +83,27 @@ bool ckd_sub(NativeRational* result, size_t a, NativeRational b) noexcept;
 /// reduction is performed if required to fit, but the result is NOT canonicalised
 bool ckd_sub(NativeRational* result, NativeRational a, NativeRational b) noexcept;
 
+/// Returns true if the calculation overflows, which is decided before any multiplication
+/// reduction is performed if required to fit, but the result is NOT canonicalised unless the base is
+bool ckd_pow(NativeRational* result, NativeRational base, size_t power) noexcept;
+
+/// Returns true if the base has no exact rational root, in which case the result is unspecified.
+/// The result is canonical if the base is.
+bool ckd_root(NativeRational* result, NativeRational base, size_t root) noexcept;
+
+/// Returns true if the power is not an exact rational or does not fit, in which case the result is unspecified.
+/// The root is taken before the power, e.g. (8/27)^(2/3) = (2/3)^2 = 4/9.
+bool ckd_pow(NativeRational* result, NativeRational base, NativeRational exponent) noexcept;
+
 /// Append a rational to the end of the string
 template<bool typeset_fraction=false> void write_native_rational(std::string& str, NativeRational val);
 
+/// Append a rational to the sink
+template<bool typeset_fraction=false> void write_native_rational(SinkRef sink, NativeRational val);
+template<bool typeset_fraction=false, OutputSink Sink> void write_native_rational(Sink& sink, NativeRational val) {
+    write_native_rational<typeset_fraction>(SinkRef(sink), val);
+}
+
 /// Append a rational to the end of the string, handling the sign to write an addition term
 template<bool typeset_fraction=false> void write_native_rational_term(std::string& str, NativeRational val);
 
@@ -0,0 +1,92 @@
+#ifndef KI_CAS_NUMBER_BATCH_WRITER_H
+#define KI_CAS_NUMBER_BATCH_WRITER_H
+
+#ifdef _MSC_VER
+#include <malloc.h>  // MSC dependencies for GMP
+#endif
+
+#include <gmp.h>
+#include <flint/fmpq.h>
+#include <flint/fmpz.h>
+
+#include "ki_cas_native_rational.h"
+#include "ki_cas_output_sink.h"
+#include "ki_cas_test_hooks.h"
+#include <cstdint>
+#include <string>
+#include <string_view>
+#include <vector>
+
+namespace KiCAS2 {
+
+/// Collects a sequence of numbers and writes them with a single allocation.
+/// The size of the output is bounded from limb counts before writing, so the destination
+/// is grown once and trimmed once, regardless of the number of entries.
+/// Big numbers and text are referenced rather than copied, and must outlive the call to write.
+class NumberBatchWriter {
+public:
+    /// Reserve space for a number of entries
+    void reserve(size_t num_entries);
+
+    /// Remove all entries
+    void clear() noexcept;
+
+    /// Number of entries added
+    size_t size() const noexcept;
+
+    /// Add a number to the batch
+    void add(size_t val);
+    void add(NativeRational val);
+    void add(const fmpz_t val);
+    void add(const fmpq_t val);
+
+    /// Add a number as a term of a sum, written as " + x" or " - |x|".
+    /// The leading entry of the batch is written as "x" or "-|x|".
+    void addTerm(size_t val);
+    void addTerm(NativeRational val);
+    void addTerm(const fmpz_t val);
+    void addTerm(const fmpq_t val);
+
+    /// Add literal text to the batch
+    void addText(std::string_view text);
+
+    /// Return an overestimate of the number of bytes required to write the batch
+    size_t sizeUpperBound() const noexcept;
+
+    /// Append the batch to the end of the string
+    void write(std::string& str) const;
+
+    /// Append the batch to the sink
+    void write(SinkRef sink) const;
+    template<OutputSink Sink> void write(Sink& sink) const { write(SinkRef(sink)); }
+
+PRIVATE:
+    enum class Kind : uint8_t {
+        NativeInt,
+        NativeRat,
+        BigInt,
+        BigRat,
+        Text,
+    };
+
+    struct Entry {
+        Kind kind;
+        bool is_term;
+        union {
+            size_t native_int;
+            NativeRational native_rat;
+            const fmpz* big_int;
+            const fmpq* big_rat;
+            struct {
+                const char* data;
+                size_t size;
+            } text;
+        };
+    };
+
+    std::vector<Entry> entries;
+};
+
+}  // namespace KiCAS2
+
+#endif // KI_CAS_NUMBER_BATCH_WRITER_H
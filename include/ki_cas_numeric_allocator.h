@@ -0,0 +1,68 @@
+#ifndef KI_CAS_NUMERIC_ALLOCATOR_H
+#define KI_CAS_NUMERIC_ALLOCATOR_H
+
+#include <cstdint>
+#include <stddef.h>
+
+namespace KiCAS2 {
+
+/// The library requesting memory from a NumericAllocator
+enum class AllocationSource : uint8_t {
+    Gmp,
+    Flint,
+};
+
+/// Memory functions shared by GMP and Flint. Flint does not report the size of memory it reallocates or frees,
+/// so old sizes are 0 for Flint. Memory for Flint must come from std::malloc, since Flint may free memory
+/// it allocated before the allocator was installed. The functions must abort rather than return nullptr.
+struct NumericAllocator {
+    void* (*allocate)(size_t size, AllocationSource source);
+    void* (*reallocate)(void* p, size_t old_size, size_t new_size, AllocationSource source);
+    void (*deallocate)(void* p, size_t old_size, AllocationSource source) noexcept;
+
+    /// Called when a NumericAllocatorScope removes the layer, to return memory it keeps to the allocator beneath
+    void (*release)() noexcept = nullptr;
+
+    bool operator==(const NumericAllocator&) const noexcept = default;
+};
+
+/// Maximum number of allocators layered over the base allocator by layer_numeric_allocator
+inline constexpr size_t MAX_NUMERIC_ALLOCATOR_LAYERS = 8;
+
+/// The allocator using std::malloc, std::realloc and std::free, which is used until another is installed
+NumericAllocator default_numeric_allocator() noexcept;
+
+/// Route GMP and Flint allocations through the allocator, replacing any installed allocators.
+/// The allocator state is constant initialised, so this may be called from static initialisers.
+/// Call before other threads use GMP or Flint. Memory allocated earlier may be freed through the allocator.
+void install_numeric_allocator(const NumericAllocator& allocator) noexcept;
+
+/// Route GMP and Flint allocations through the allocator, which passes what it does not handle itself
+/// to the returned allocator. Otherwise behaves as install_numeric_allocator.
+NumericAllocator layer_numeric_allocator(const NumericAllocator& allocator) noexcept;
+
+/// While alive, allocators layered over those installed at construction stay installed. When the scope ends,
+/// they are released and removed from the top down, restoring the allocator installed at construction.
+/// Memory allocated through a removed layer is later freed through the allocators beneath.
+/// Scopes must end in reverse order of construction, and the base allocator must not be replaced within a scope.
+/// Call before other threads use GMP or Flint, and end the scope after they stop.
+class NumericAllocatorScope {
+public:
+    NumericAllocatorScope() noexcept;
+    ~NumericAllocatorScope();
+    NumericAllocatorScope(const NumericAllocatorScope&) = delete;
+    NumericAllocatorScope& operator=(const NumericAllocatorScope&) = delete;
+
+private:
+    size_t depth;
+};
+
+/// Return the allocator which GMP and Flint allocations are currently routed to
+NumericAllocator numeric_allocator() noexcept;
+
+/// Return true if GMP and Flint allocations pass through the allocator, directly or beneath another layer
+bool is_numeric_allocator_installed(const NumericAllocator& allocator) noexcept;
+
+}  // namespace KiCAS2
+
+#endif // KI_CAS_NUMERIC_ALLOCATOR_H
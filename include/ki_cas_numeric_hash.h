@@ -0,0 +1,170 @@
+#ifndef KI_CAS_NUMERIC_HASH_H
+#define KI_CAS_NUMERIC_HASH_H
+
+#include "ki_cas_big_num_owner.h"
+#include "ki_cas_kmpz.h"
+#include "ki_cas_native_rational.h"
+
+#include <concepts>
+#include <inttypes.h>
+#include <type_traits>
+
+// Hashing which depends only on the value, so that equal values hash equal in every tier,
+// e.g. 3 as a size_t, NativeRational(6, 2), an fmpz, an fmpq or a uint256_t.
+// An integer is hashed from its sign and the 64-bit words of its magnitude, least significant first,
+// and a rational with a denominator other than 1 combines the hashes of its canonical numerator and denominator.
+
+namespace KiCAS2 {
+
+inline constexpr uint64_t NUMERIC_HASH_NEGATIVE_SEED = 0x9e3779b97f4a7c15;
+
+/// Finaliser of splitmix64, which maps 0 to 0
+constexpr uint64_t numeric_hash_mix(uint64_t x) noexcept {
+    x ^= x >> 30;
+    x *= 0xbf58476d1ce4e5b9;
+    x ^= x >> 27;
+    x *= 0x94d049bb133111eb;
+    x ^= x >> 31;
+    return x;
+}
+
+/// Seed of an integer with the given number of significant words, which continues with each word in turn
+constexpr uint64_t numeric_hash_seed(size_t num_words, bool is_negative) noexcept {
+    return numeric_hash_mix(num_words + (is_negative ? NUMERIC_HASH_NEGATIVE_SEED : 0));
+}
+
+/// Hash of an integer given its magnitude, which fits in a word
+constexpr size_t numeric_hash_word(uint64_t magnitude, bool is_negative = false) noexcept {
+    if(magnitude == 0) return 0;
+    return static_cast<size_t>(numeric_hash_mix(numeric_hash_seed(1, is_negative) ^ magnitude));
+}
+
+/// Hash of an integer given its magnitude as words, least significant first, with any high zero words ignored
+size_t numeric_hash_words(const uint64_t* words, size_t num_words, bool is_negative = false) noexcept;
+
+/// Hash of an integer given its magnitude as GMP limbs, least significant first, with any high zero limbs ignored
+size_t numeric_hash_limbs(const mp_limb_t* limbs, size_t num_limbs, bool is_negative = false) noexcept;
+
+/// Combine the hashes of a canonical numerator and denominator. A denominator of 1 gives the hash of the numerator.
+constexpr size_t numeric_hash_rational(size_t num_hash, size_t den_hash) noexcept {
+    if(den_hash == numeric_hash_word(1)) return num_hash;
+    return num_hash ^ static_cast<size_t>(numeric_hash_mix(den_hash + NUMERIC_HASH_NEGATIVE_SEED));
+}
+
+template<std::integral T> constexpr size_t numeric_hash(T val) noexcept {
+    if constexpr(std::is_signed_v<T>){
+        const uint64_t magnitude = val < 0 ? uint64_t(0) - static_cast<uint64_t>(val) : static_cast<uint64_t>(val);
+        return numeric_hash_word(magnitude, val < 0);
+    }else{
+        return numeric_hash_word(val);
+    }
+}
+
+/// The rational need not be canonicalised
+size_t numeric_hash(NativeRational val) noexcept;
+
+size_t numeric_hash(const uint128_t& val, bool is_negative = false) noexcept;
+size_t numeric_hash(const uint256_t& val, bool is_negative = false) noexcept;
+size_t numeric_hash(const uint512_t& val, bool is_negative = false) noexcept;
+size_t numeric_hash(mpz_srcptr val) noexcept;
+
+inline size_t numeric_hash(const fmpz* val) noexcept {
+    if(!COEFF_IS_MPZ(*val)) [[likely]] return numeric_hash(*val);
+    return numeric_hash(COEFF_TO_PTR(*val));
+}
+
+/// The rational must be canonical
+inline size_t numeric_hash(const fmpq* val) noexcept {
+    return numeric_hash_rational(numeric_hash(&val->num), numeric_hash(&val->den));
+}
+
+inline size_t numeric_hash(const Int& val) noexcept { return numeric_hash(val.get()); }
+
+/// The rational must be canonical
+inline size_t numeric_hash(const Rat& val) noexcept { return numeric_hash(val.get()); }
+
+inline bool numeric_equal(const fmpz* a, const fmpz* b) noexcept { return fmpz_equal(a, b); }
+
+/// The rationals must be canonical
+inline bool numeric_equal(const fmpq* a, const fmpq* b) noexcept { return fmpq_equal(a, b); }
+
+/// The rational must be canonical
+inline bool numeric_equal(const fmpq* a, const fmpz* b) noexcept {
+    return fmpz_is_one(&a->den) && fmpz_equal(&a->num, b);
+}
+
+template<std::integral T> bool numeric_equal(const fmpz* a, T b) noexcept {
+    if constexpr(std::is_signed_v<T>) return fmpz_cmp_si(a, static_cast<slong>(b)) == 0;
+    else return fmpz_cmp_ui(a, static_cast<ulong>(b)) == 0;
+}
+
+/// The rational must be canonical
+template<std::integral T> bool numeric_equal(const fmpq* a, T b) noexcept {
+    return fmpz_is_one(&a->den) && numeric_equal(&a->num, b);
+}
+
+/// The NativeRational need not be canonicalised
+inline bool numeric_equal(const fmpz* a, NativeRational b) noexcept {
+    if(b.den != 1) b.reduceInPlace();
+    return b.den == 1 && numeric_equal(a, b.num);
+}
+
+/// The rational must be canonical, but the NativeRational need not be
+inline bool numeric_equal(const fmpq* a, NativeRational b) noexcept {
+    if(b.den != 1) b.reduceInPlace();
+    return numeric_equal(&a->num, b.num) && numeric_equal(&a->den, b.den);
+}
+
+/// An Int or canonical Rat with its hash, which is computed once for keys hashed repeatedly, such as huge values in
+/// memoisation tables. The value is immutable so that the hash stays valid.
+template<typename Number> requires std::same_as<Number, Int> || std::same_as<Number, Rat> class Hashed {
+public:
+    explicit Hashed(Number&& val) noexcept : val(std::move(val)), hash_val(numeric_hash(this->val)) {}
+
+    const Number& value() const noexcept { return val; }
+    size_t hash() const noexcept { return hash_val; }
+
+    friend bool operator==(const Hashed& a, const Hashed& b) noexcept {
+        if(a.hash_val != b.hash_val) return false;
+        if constexpr(std::same_as<Number, Int>) return fmpz_equal(a.val.get(), b.val.get());
+        else return fmpq_equal(a.val.get(), b.val.get());
+    }
+
+private:
+    Number val;
+    size_t hash_val;
+};
+
+/// Hash functor for unordered containers, which accepts any numeric tier for heterogeneous lookup with NumericEqual
+struct NumericHash {
+    using is_transparent = void;
+
+    template<typename T> size_t operator()(const T& val) const noexcept { return numeric_hash(val); }
+    template<typename Number> size_t operator()(const Hashed<Number>& val) const noexcept { return val.hash(); }
+};
+
+/// Equality functor for unordered containers, which compares values across tiers for heterogeneous lookup with
+/// NumericHash. At least one operand must be an Int, Rat, Hashed or Flint value.
+struct NumericEqual {
+    using is_transparent = void;
+
+    template<typename A, typename B> bool operator()(const A& a, const B& b) const noexcept {
+        if constexpr(requires { a.hash(); b.hash(); }) if(a.hash() != b.hash()) return false;
+
+        if constexpr(requires { numeric_equal(operand(a), operand(b)); }) return numeric_equal(operand(a), operand(b));
+        else return numeric_equal(operand(b), operand(a));
+    }
+
+private:
+    static const fmpz* operand(const Int& val) noexcept { return val.get(); }
+    static const fmpq* operand(const Rat& val) noexcept { return val.get(); }
+    template<typename Number> static auto operand(const Hashed<Number>& val) noexcept { return operand(val.value()); }
+    static const fmpz* operand(const fmpz* val) noexcept { return val; }
+    static const fmpq* operand(const fmpq* val) noexcept { return val; }
+    static NativeRational operand(NativeRational val) noexcept { return val; }
+    template<std::integral T> static T operand(T val) noexcept { return val; }
+};
+
+}  // namespace KiCAS2
+
+#endif // KI_CAS_NUMERIC_HASH_H
@@ -0,0 +1,153 @@
+#ifndef KI_CAS_OUTPUT_SINK_H
+#define KI_CAS_OUTPUT_SINK_H
+
+#include <cassert>
+#include <concepts>
+#include <cstring>
+#include <memory>
+#include <stddef.h>
+#include <string>
+#include <string_view>
+#include <vector>
+
+namespace KiCAS2 {
+
+/// A destination for written numbers.
+/// `prepare(n)` returns a pointer to at least n writable bytes at the end of the output,
+/// or nullptr if the sink cannot accept n more bytes.
+/// `commit(end)` marks the bytes up to `end` as written and discards the rest of the prepared region.
+template<typename T>
+concept OutputSink = requires(T& sink, size_t n, char* end) {
+    { sink.prepare(n) } -> std::same_as<char*>;
+    { sink.commit(end) };
+};
+
+/// Non-owning reference to any OutputSink, through which the writers are compiled once rather than for each sink.
+/// Each writer taking a SinkRef has a template overload which accepts any sink and forwards to it.
+class SinkRef {
+public:
+    template<OutputSink Sink> requires (!std::same_as<Sink, SinkRef>)
+    explicit SinkRef(Sink& sink) noexcept
+        : sink(std::addressof(sink)),
+          prepare_sink([](void* erased, size_t n) -> char* { return static_cast<Sink*>(erased)->prepare(n); }),
+          commit_sink([](void* erased, char* end) { static_cast<Sink*>(erased)->commit(end); }) {}
+
+    char* prepare(size_t n) { return prepare_sink(sink, n); }
+    void commit(char* end) { commit_sink(sink, end); }
+
+private:
+    void* sink;
+    char* (*prepare_sink)(void* erased, size_t n);
+    void (*commit_sink)(void* erased, char* end);
+};
+
+/// Sink appending to a std::string
+class StringSink {
+public:
+    explicit StringSink(std::string& str) noexcept : str(str) {}
+
+    char* prepare(size_t n) {
+        const size_t start_index = str.size();
+        str.resize(start_index + n);
+        return str.data() + start_index;
+    }
+
+    void commit(char* end) noexcept {
+        assert(end >= str.data() && end <= str.data() + str.size());
+        str.resize(end - str.data());
+    }
+
+private:
+    std::string& str;
+};
+
+/// Sink writing to a fixed caller-owned buffer. Output stops once a write does not fit.
+/// Writers prepare for their worst-case size, so overflow may be reported
+/// when the exact output would have fit in the remaining space.
+class SpanSink {
+public:
+    SpanSink(char* begin, char* end) noexcept;
+    SpanSink(char* begin, size_t capacity) noexcept;
+    char* prepare(size_t n) noexcept;
+    void commit(char* end) noexcept;
+
+    /// Return true if any write was dropped for lack of space
+    bool overflowed() const noexcept;
+
+    /// The bytes written so far
+    std::string_view view() const noexcept;
+
+private:
+    char* const begin;
+    char* cursor;
+    char* const end;
+    bool has_overflowed = false;
+};
+
+/// Sink writing to a chain of blocks which are never moved, so prior output is never copied
+class ArenaSink {
+public:
+    explicit ArenaSink(size_t block_size = 4096) noexcept;
+    char* prepare(size_t n);
+    void commit(char* end) noexcept;
+
+    /// Total number of bytes written
+    size_t size() const noexcept;
+
+    /// Number of blocks allocated
+    size_t numBlocks() const noexcept;
+
+    /// Copy the written bytes into a contiguous string
+    std::string str() const;
+
+    /// Release all blocks
+    void clear() noexcept;
+
+private:
+    struct Block {
+        std::unique_ptr<char[]> data;
+        size_t used;
+        size_t capacity;
+    };
+
+    std::vector<Block> blocks;
+    const size_t block_size;
+};
+
+/// Sink writing to a file descriptor through an internal buffer.
+/// The buffer is flushed when full and on destruction.
+class FileDescriptorSink {
+public:
+    explicit FileDescriptorSink(int fd, size_t buffer_size = 4096);
+    ~FileDescriptorSink();
+    FileDescriptorSink(const FileDescriptorSink&) = delete;
+    FileDescriptorSink& operator=(const FileDescriptorSink&) = delete;
+
+    char* prepare(size_t n);
+    void commit(char* end) noexcept;
+
+    /// Write buffered bytes to the file descriptor. Returns true on failure.
+    bool flush() noexcept;
+
+    /// Return true if any write to the file descriptor has failed
+    bool failed() const noexcept;
+
+private:
+    std::unique_ptr<char[]> buffer;
+    size_t used = 0;
+    size_t capacity;
+    const int fd;
+    bool has_failed = false;
+};
+
+/// Append raw text to a sink
+template<OutputSink Sink> void sink_append(Sink& sink, std::string_view text) {
+    char* dest = sink.prepare(text.size());
+    if(dest == nullptr) return;
+    std::memcpy(dest, text.data(), text.size());
+    sink.commit(dest + text.size());
+}
+
+}  // namespace KiCAS2
+
+#endif // KI_CAS_OUTPUT_SINK_H
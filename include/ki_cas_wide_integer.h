@@ -0,0 +1,48 @@
+#ifndef KI_CAS_WIDE_INTEGER_H
+#define KI_CAS_WIDE_INTEGER_H
+
+#ifdef _MSC_VER
+#include <malloc.h>  // MSC dependencies for GMP
+#endif
+
+#include "ki_cas_big_num_owner.h"
+#include "ki_cas_kmpz.h"
+#include <stddef.h>
+
+// Checked unsigned arithmetic on 256- and 512-bit integers, for intermediate values too wide for a native integer
+// but too narrow to justify an fmpz. The ckd_* functions follow the conventions of ki_cas_native_integer.h.
+// The promote_* functions always succeed, staying fixed-width where possible and promoting to an fmpz on overflow.
+
+namespace KiCAS2 {
+
+/// Returns true if the calculation overflows
+bool ckd_add(uint256_t* result, const uint256_t& a, const uint256_t& b) noexcept;
+bool ckd_add(uint512_t* result, const uint512_t& a, const uint512_t& b) noexcept;
+
+/// Returns true if the calculation overflows
+bool ckd_mul(uint256_t* result, const uint256_t& a, const uint256_t& b) noexcept;
+bool ckd_mul(uint512_t* result, const uint512_t& a, const uint512_t& b) noexcept;
+
+/// Returns true if the calculation overflows
+bool ckd_pow(uint256_t* result, const uint256_t& base, size_t power) noexcept;
+bool ckd_pow(uint512_t* result, const uint512_t& base, size_t power) noexcept;
+
+/// Returns true if the divisor does not divide the dividend exactly
+bool ckd_div(uint256_t* result, const uint256_t& dividend, const uint256_t& divisor) noexcept;
+bool ckd_div(uint512_t* result, const uint512_t& dividend, const uint512_t& divisor) noexcept;
+
+/// Exact sum, promoted to an fmpz if it overflows
+Int promote_add(const uint256_t& a, const uint256_t& b);
+Int promote_add(const uint512_t& a, const uint512_t& b);
+
+/// Exact product, promoted to an fmpz if it overflows
+Int promote_mul(const uint256_t& a, const uint256_t& b);
+Int promote_mul(const uint512_t& a, const uint512_t& b);
+
+/// Exact power, promoted to an fmpz if it overflows
+Int promote_pow(const uint256_t& base, size_t power);
+Int promote_pow(const uint512_t& base, size_t power);
+
+}  // namespace KiCAS2
+
+#endif // KI_CAS_WIDE_INTEGER_H
@@ -0,0 +1,178 @@
+#include "ki_cas_allocation_tracker.h"
+
+#include <algorithm>
+#include <atomic>
+#include <bit>
+#include <cstdlib>
+#include <new>
+
+namespace KiCAS2 {
+
+/// Counters for one allocation source. Only the owning thread writes, so updates are plain loads and stores
+/// rather than read-modify-write operations, and other threads may read them at any time for a snapshot.
+struct SourceCounters {
+    std::atomic<int64_t> live_bytes = 0;
+    std::atomic<size_t> num_allocations = 0;
+    std::atomic<size_t> num_reallocations = 0;
+    std::atomic<size_t> num_frees = 0;
+    std::atomic<size_t> size_histogram[ALLOCATION_HISTOGRAM_SIZE] = {};
+};
+
+static constexpr size_t NUM_ALLOCATION_SOURCES = 2;
+
+/// Counters owned by one thread at a time
+struct alignas(64) Shard {
+    SourceCounters counters[NUM_ALLOCATION_SOURCES];
+    int64_t unpublished_bytes = 0;
+    std::atomic<bool> in_use = true;
+    Shard* next = nullptr;
+};
+
+/// Shards are never freed, so snapshots may traverse the list without locking.
+/// A shard released by an exiting thread is reused by the next new thread.
+static std::atomic<Shard*> shards = nullptr;
+static std::atomic<int64_t> published_live_bytes = 0;
+static std::atomic<int64_t> published_peak_bytes = 0;
+
+static thread_local Shard* local_shard = nullptr;
+static thread_local bool thread_is_exiting = false;
+
+template<typename T> static void increment(std::atomic<T>& counter, T val) noexcept {
+    counter.store(counter.load(std::memory_order_relaxed) + val, std::memory_order_relaxed);
+}
+
+static void publish(Shard& shard) noexcept {
+    const int64_t live = published_live_bytes.fetch_add(shard.unpublished_bytes, std::memory_order_relaxed)
+                         + shard.unpublished_bytes;
+    shard.unpublished_bytes = 0;
+
+    int64_t peak = published_peak_bytes.load(std::memory_order_relaxed);
+    while(live > peak && !published_peak_bytes.compare_exchange_weak(peak, live, std::memory_order_relaxed));
+}
+
+static Shard* acquire_shard() noexcept {
+    for(Shard* shard = shards.load(std::memory_order_acquire); shard != nullptr; shard = shard->next){
+        bool in_use = false;
+        if(shard->in_use.compare_exchange_strong(in_use, true, std::memory_order_acquire)) return shard;
+    }
+
+    Shard* shard = new(std::nothrow) Shard;
+    if(shard == nullptr) std::abort();
+    shard->next = shards.load(std::memory_order_relaxed);
+    while(!shards.compare_exchange_weak(shard->next, shard, std::memory_order_release, std::memory_order_relaxed));
+
+    return shard;
+}
+
+/// Releases the shard of a thread on exit
+struct ShardReleaser {
+    // Writing to the object ensures it is constructed, so that its destructor runs
+    void arm() noexcept { is_armed = true; }
+
+    bool is_armed = false;
+
+    ~ShardReleaser() {
+        thread_is_exiting = true;
+        if(local_shard == nullptr) return;
+        publish(*local_shard);
+        local_shard->in_use.store(false, std::memory_order_release);
+        local_shard = nullptr;
+    }
+};
+
+static thread_local ShardReleaser shard_releaser;
+
+static Shard& get_local_shard() noexcept {
+    if(local_shard == nullptr){
+        local_shard = acquire_shard();
+
+        // A shard acquired while destroying thread locals is kept rather than released
+        if(!thread_is_exiting) shard_releaser.arm();
+    }
+
+    return *local_shard;
+}
+
+static size_t histogram_bucket(size_t n) noexcept {
+    constexpr size_t smallest_bucket_bits = 4;
+    const size_t bits = std::bit_width(n);
+    return std::min(bits - std::min(bits, smallest_bucket_bits), ALLOCATION_HISTOGRAM_SIZE - 1);
+}
+
+/// Only GMP reports the size of freed memory, so only GMP bytes are recorded
+static void record(Shard& shard, int64_t delta_bytes) noexcept {
+    increment(shard.counters[static_cast<size_t>(AllocationSource::Gmp)].live_bytes, delta_bytes);
+    shard.unpublished_bytes += delta_bytes;
+    if(shard.unpublished_bytes > ALLOCATION_PEAK_TOLERANCE_BYTES || shard.unpublished_bytes < -ALLOCATION_PEAK_TOLERANCE_BYTES)
+        publish(shard);
+}
+
+static NumericAllocator prior = {};
+
+static void* trackingAllocate(size_t n, AllocationSource source) {
+    void* allocated = prior.allocate(n, source);
+
+    Shard& shard = get_local_shard();
+    SourceCounters& counters = shard.counters[static_cast<size_t>(source)];
+    increment(counters.num_allocations, size_t(1));
+    increment(counters.size_histogram[histogram_bucket(n)], size_t(1));
+    if(source == AllocationSource::Gmp) record(shard, static_cast<int64_t>(n));
+
+    return allocated;
+}
+
+static void* trackingReallocate(void* p, size_t old, size_t n, AllocationSource source) {
+    void* reallocated = prior.reallocate(p, old, n, source);
+
+    Shard& shard = get_local_shard();
+    SourceCounters& counters = shard.counters[static_cast<size_t>(source)];
+    increment(counters.num_reallocations, size_t(1));
+    increment(counters.size_histogram[histogram_bucket(n)], size_t(1));
+    if(source == AllocationSource::Gmp) record(shard, static_cast<int64_t>(n) - static_cast<int64_t>(old));
+
+    return reallocated;
+}
+
+static void trackingDeallocate(void* p, size_t old, AllocationSource source) noexcept {
+    prior.deallocate(p, old, source);
+
+    Shard& shard = get_local_shard();
+    increment(shard.counters[static_cast<size_t>(source)].num_frees, size_t(1));
+    if(source == AllocationSource::Gmp) record(shard, -static_cast<int64_t>(old));
+}
+
+static constexpr NumericAllocator TRACKING_ALLOCATOR = {trackingAllocate, trackingReallocate, trackingDeallocate};
+
+int64_t AllocationStats::liveAllocations() const noexcept {
+    return static_cast<int64_t>(num_allocations) - static_cast<int64_t>(num_frees);
+}
+
+void install_allocation_tracker() noexcept {
+    if(is_allocation_tracker_installed()) return;
+    prior = layer_numeric_allocator(TRACKING_ALLOCATOR);
+}
+
+bool is_allocation_tracker_installed() noexcept {
+    return is_numeric_allocator_installed(TRACKING_ALLOCATOR);
+}
+
+AllocationStats allocation_stats(AllocationSource source) noexcept {
+    AllocationStats stats;
+
+    for(const Shard* shard = shards.load(std::memory_order_acquire); shard != nullptr; shard = shard->next){
+        const SourceCounters& counters = shard->counters[static_cast<size_t>(source)];
+        stats.live_bytes += counters.live_bytes.load(std::memory_order_relaxed);
+        stats.num_allocations += counters.num_allocations.load(std::memory_order_relaxed);
+        stats.num_reallocations += counters.num_reallocations.load(std::memory_order_relaxed);
+        stats.num_frees += counters.num_frees.load(std::memory_order_relaxed);
+        for(size_t i = 0; i < ALLOCATION_HISTOGRAM_SIZE; i++)
+            stats.size_histogram[i] += counters.size_histogram[i].load(std::memory_order_relaxed);
+    }
+
+    if(source == AllocationSource::Gmp)
+        stats.peak_bytes = std::max(published_peak_bytes.load(std::memory_order_relaxed), stats.live_bytes);
+
+    return stats;
+}
+
+}  // namespace KiCAS2
@@ -0,0 +1,165 @@
+#include "ki_cas_big_num_expr.h"
+
+namespace KiCAS2 {
+
+static void add_or_sub(fmpz* dest, const fmpz* a, const fmpz* b, bool subtract) {
+    if(subtract) fmpz_sub(dest, a, b);
+    else fmpz_add(dest, a, b);
+}
+
+static void add_or_sub(fmpq* dest, const fmpq* a, const fmpq* b, bool subtract) {
+    if(subtract) fmpq_sub(dest, a, b);
+    else fmpq_add(dest, a, b);
+}
+
+/// Fallback for a destination which is also an operand, where accumulating in place would change the operand
+template<IntExpression Expr> static void accumulate_via_temporary(const Expr& expr, fmpz* dest, bool subtract) {
+    const Int val(expr);
+    add_or_sub(dest, dest, val.get(), subtract);
+}
+
+template<RatExpression Expr> static void accumulate_via_temporary(const Expr& expr, fmpq* dest, bool subtract) {
+    const Rat val(expr);
+    add_or_sub(dest, dest, val.get(), subtract);
+}
+
+void IntSum::evaluate(fmpz* dest) const {
+    add_or_sub(dest, a, b, subtract);
+}
+
+void IntSum::accumulate(fmpz* dest, bool subtract_sum) const {
+    if(dest == b) return accumulate_via_temporary(*this, dest, subtract_sum);
+
+    add_or_sub(dest, dest, a, subtract_sum);
+    add_or_sub(dest, dest, b, subtract_sum != subtract);
+}
+
+bool IntProduct::aliases(const fmpz* dest) const noexcept {
+    return dest == a || dest == b;
+}
+
+void IntProduct::evaluate(fmpz* dest) const {
+    fmpz_mul(dest, a, b);
+}
+
+void IntProduct::accumulate(fmpz* dest, bool subtract_product) const {
+    if(subtract_product) fmpz_submul(dest, a, b);
+    else fmpz_addmul(dest, a, b);
+}
+
+bool IntProductUi::aliases(const fmpz* dest) const noexcept {
+    return dest == a;
+}
+
+void IntProductUi::evaluate(fmpz* dest) const {
+    fmpz_mul_ui(dest, a, b);
+}
+
+void IntProductUi::accumulate(fmpz* dest, bool subtract_product) const {
+    if(subtract_product) fmpz_submul_ui(dest, a, b);
+    else fmpz_addmul_ui(dest, a, b);
+}
+
+template<IntProductExpression Product> void IntProductSum<Product>::evaluate(fmpz* dest) const {
+    if(dest == c){
+        product.accumulate(dest, subtract_product);
+    }else if(product.aliases(dest)){
+        const Int val(product);
+        add_or_sub(dest, c, val.get(), subtract_product);
+    }else{
+        fmpz_set(dest, c);
+        product.accumulate(dest, subtract_product);
+    }
+
+    if(negate) fmpz_neg(dest, dest);
+}
+
+template<IntProductExpression Product> void IntProductSum<Product>::accumulate(fmpz* dest, bool subtract_sum) const {
+    if(dest == c || product.aliases(dest)) return accumulate_via_temporary(*this, dest, subtract_sum);
+
+    add_or_sub(dest, dest, c, subtract_sum != negate);
+    product.accumulate(dest, subtract_sum != (negate != subtract_product));
+}
+
+template struct IntProductSum<IntProduct>;
+template struct IntProductSum<IntProductUi>;
+
+void IntProductPair::evaluate(fmpz* dest) const {
+    if(subtract) fmpz_fmms(dest, first.a, first.b, second.a, second.b);
+    else fmpz_fmma(dest, first.a, first.b, second.a, second.b);
+}
+
+void IntProductPair::accumulate(fmpz* dest, bool subtract_sum) const {
+    if(first.aliases(dest) || second.aliases(dest)) return accumulate_via_temporary(*this, dest, subtract_sum);
+
+    first.accumulate(dest, subtract_sum);
+    second.accumulate(dest, subtract_sum != subtract);
+}
+
+void RatSum::evaluate(fmpq* dest) const {
+    add_or_sub(dest, a, b, subtract);
+}
+
+void RatSum::accumulate(fmpq* dest, bool subtract_sum) const {
+    if(dest == b) return accumulate_via_temporary(*this, dest, subtract_sum);
+
+    add_or_sub(dest, dest, a, subtract_sum);
+    add_or_sub(dest, dest, b, subtract_sum != subtract);
+}
+
+void RatIntSum::evaluate(fmpq* dest) const {
+    if(subtract) fmpq_sub_fmpz(dest, a, b);
+    else fmpq_add_fmpz(dest, a, b);
+}
+
+void RatIntSum::accumulate(fmpq* dest, bool subtract_sum) const {
+    if(dest == a) return accumulate_via_temporary(*this, dest, subtract_sum);
+
+    if(subtract_sum != subtract) fmpq_sub_fmpz(dest, dest, b);
+    else fmpq_add_fmpz(dest, dest, b);
+    add_or_sub(dest, dest, a, subtract_sum);
+}
+
+bool RatProduct::aliases(const fmpq* dest) const noexcept {
+    return dest == a || dest == b;
+}
+
+void RatProduct::evaluate(fmpq* dest) const {
+    fmpq_mul(dest, a, b);
+}
+
+void RatProduct::accumulate(fmpq* dest, bool subtract_product) const {
+    if(subtract_product) fmpq_submul(dest, a, b);
+    else fmpq_addmul(dest, a, b);
+}
+
+void RatIntProduct::evaluate(fmpq* dest) const {
+    fmpq_mul_fmpz(dest, a, b);
+}
+
+void RatIntProduct::accumulate(fmpq* dest, bool subtract_product) const {
+    accumulate_via_temporary(*this, dest, subtract_product);
+}
+
+void RatProductSum::evaluate(fmpq* dest) const {
+    if(dest == c){
+        product.accumulate(dest, subtract_product);
+    }else if(product.aliases(dest)){
+        const Rat val(product);
+        add_or_sub(dest, c, val.get(), subtract_product);
+    }else{
+        fmpq_set(dest, c);
+        product.accumulate(dest, subtract_product);
+    }
+
+    if(negate) fmpq_neg(dest, dest);
+}
+
+void RatProductSum::accumulate(fmpq* dest, bool subtract_sum) const {
+    if(dest == c || product.aliases(dest)) return accumulate_via_temporary(*this, dest, subtract_sum);
+
+    add_or_sub(dest, dest, c, subtract_sum != negate);
+    product.accumulate(dest, subtract_sum != (negate != subtract_product));
+}
+
+}  // namespace KiCAS2
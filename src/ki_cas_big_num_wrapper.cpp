@@ -1,16 +1,17 @@
 #include "ki_cas_big_num_wrapper.h"
 
 #include <cassert>
+#include <cstring>
 #include "arch_macros.h"
+#include "ki_cas_gmp_arena.h"
+#include "ki_cas_kmpz.h"
 #include "ki_cas_native_integer.h"
 #include "ki_cas_native_rational.h"
 #include <limits>
 
-#ifndef NDEBUG
+#if !defined(NDEBUG) && defined(TEST_GMP_LEAKS)
+#include "ki_cas_allocation_tracker.h"
 #include <iostream>
-#include <memory.h>
-#include <shared_mutex>
-#include <unordered_set>
 #endif
 
 namespace KiCAS2 {
@@ -67,18 +68,78 @@ void fmpz_10_pow_fmpz(fmpz_t f, const fmpz_t rhs) {
 
 size_t mpz_sizeinbase10upperbound(const mpz_t val) noexcept {
     // return mpz_sizeinbase(val, 10);  // Avoid computation, make a quick upper bound
-    return mpz_size(val) * std::numeric_limits<mp_limb_t>::digits10;
+    return mpz_size(val) * (std::numeric_limits<mp_limb_t>::digits10 + 1);
 }
 
 size_t fmpz_sizeinbase10upperbound(const fmpz_t val) noexcept {
     // return fmpz_sizeinbase(val, 10);  // Avoid computation, make a quick upper bound
-    return fmpz_size(val) * std::numeric_limits<mp_limb_t>::digits10;
+    return fmpz_size(val) * (std::numeric_limits<mp_limb_t>::digits10 + 1);
 }
 
 void fmpq_abs_inplace(fmpq_t val) noexcept {
     val->num = std::abs(val->num);
 }
 
+/// Magnitude of a small fmpz
+static size_t small_abs(slong val) noexcept {
+    return val < 0 ? -static_cast<size_t>(val) : static_cast<size_t>(val);
+}
+
+void fmpq_pow_ui(fmpq_t result, const fmpq_t base, ulong power) {
+    assert(!fmpq_is_zero(base) || power != 0);  // 0^0 is not generally defined
+
+    const fmpz num = *fmpq_numref(base);
+    const fmpz den = *fmpq_denref(base);
+    if(!COEFF_IS_MPZ(num) && !COEFF_IS_MPZ(den)
+        && !pow_overflows(small_abs(num), power) && !pow_overflows(static_cast<size_t>(den), power)){
+        fmpz_set_ui(fmpq_numref(result), knownfit_pow(small_abs(num), power));
+        if(num < 0 && power % 2 == 1) fmpz_neg(fmpq_numref(result), fmpq_numref(result));
+        fmpz_set_ui(fmpq_denref(result), knownfit_pow(static_cast<size_t>(den), power));
+        return;
+    }
+
+    // The parts of a canonical fmpq are coprime, so their powers are too. fmpq_pow_si would take the power as signed.
+    fmpz_pow_ui(fmpq_numref(result), fmpq_numref(base), power);
+    fmpz_pow_ui(fmpq_denref(result), fmpq_denref(base), power);
+}
+
+bool ckd_root(fmpq_t result, const fmpq_t base, ulong root) {
+    assert(root != 0);
+
+    const fmpz num = *fmpq_numref(base);
+    const fmpz den = *fmpq_denref(base);
+    if(fmpz_sgn(fmpq_numref(base)) < 0 && root % 2 == 0) return true;
+
+    if(!COEFF_IS_MPZ(num) && !COEFF_IS_MPZ(den)){
+        NativeRational native_root;
+        if(ckd_root(&native_root, NativeRational(small_abs(num), static_cast<size_t>(den)), root)) return true;
+        fmpz_set_ui(fmpq_numref(result), native_root.num);
+        if(num < 0) fmpz_neg(fmpq_numref(result), fmpq_numref(result));
+        fmpz_set_ui(fmpq_denref(result), native_root.den);
+        return false;
+    }
+
+    // A part which does not fit in a word has no root of an index this large, and fmpz_root takes the index as signed
+    if(root > static_cast<ulong>(std::numeric_limits<slong>::max())) return true;
+
+    Int num_root;
+    Int den_root;
+    if(!fmpz_root(num_root.get(), fmpq_numref(base), static_cast<slong>(root))
+        || !fmpz_root(den_root.get(), fmpq_denref(base), static_cast<slong>(root))) return true;
+    fmpz_swap(fmpq_numref(result), num_root.get());
+    fmpz_swap(fmpq_denref(result), den_root.get());
+    return false;
+}
+
+bool ckd_pow(fmpq_t result, const fmpq_t base, NativeRational exponent) {
+    assert(exponent.den != 0);
+    exponent.reduceInPlace();
+
+    if(ckd_root(result, base, exponent.den)) return true;
+    fmpq_pow_ui(result, result, exponent.num);
+    return false;
+}
+
 void mpz_init_set_strview(mpz_t f, std::string_view str) {
     #ifndef NDEBUG
     for(const char ch : str) assert(ch >= '0' && ch <= '9');
@@ -86,14 +147,10 @@ void mpz_init_set_strview(mpz_t f, std::string_view str) {
 
     if(str.size() <= std::numeric_limits<size_t>::digits10){
         mpz_init_set_ui(f, knownfit_str2int(str));
-    #if (!defined(__x86_64__) && !defined(__aarch64__) && !defined(_WIN64)) || !defined(_MSC_VER)
-    }else if(str.size() <= std::numeric_limits<WideType>::digits10){
-        const DoubleInt val = knownfit_str2wideint(str);
-        fmpz ptr = 0;
-        fmpz_set_uiui(&ptr, val.high, val.low);
-        if(COEFF_IS_MPZ(ptr)) *f = *COEFF_TO_PTR(ptr);
-        else mpz_init_set_ui(f, ptr);
-    #endif
+    }else if(str.size() <= std::numeric_limits<uint128_t>::digits10){
+        mpz_init_set_uint128(f, knownfit_str2uint128(str));
+    }else if(str.size() <= std::numeric_limits<uint256_t>::digits10){
+        mpz_init_set_uint256(f, knownfit_str2uint256(str));
     }else{
         std::string copy(str);
         mpz_init(f);
@@ -116,13 +173,10 @@ fmpz fmpz_from_strview(std::string_view str) {
 
     if(str.size() < COEFF_MAX_DIGITS){
         return knownfit_str2int(str);
-#if defined(Word32) || !defined(_MSC_VER)
-    }else if(str.size() <= std::numeric_limits<WideType>::digits10){
-        const DoubleInt val = knownfit_str2wideint(str);
-        fmpz f = 0;
-        fmpz_set_uiui(&f, val.high, val.low);
-        return f;
-#endif
+    }else if(str.size() <= std::numeric_limits<uint128_t>::digits10){
+        return u128_to_fmpz(knownfit_str2uint128(str));
+    }else if(str.size() <= std::numeric_limits<uint256_t>::digits10){
+        return u256_to_fmpz(knownfit_str2uint256(str));
     }else{
         std::string copy(str);
         fmpz f = 0;
@@ -136,43 +190,47 @@ void fmpz_init_set_strview(fmpz_t f, std::string_view str) {
     *f = fmpz_from_strview(str);
 }
 
-void write_big_int(std::string& str, const mpz_t val) {
-    // Resize str to ensure sufficient capacity for the largest possible number
+void write_big_int(SinkRef sink, const mpz_t val) {
     static constexpr size_t base = 10;
     static constexpr size_t PLUS_ONE_FOR_SIGN = 1;
     static constexpr size_t PLUS_ONE_FOR_NULL_TERMINATOR = 1;
 
     const size_t max_digits = mpz_sizeinbase10upperbound(val) + (PLUS_ONE_FOR_SIGN + PLUS_ONE_FOR_NULL_TERMINATOR);
-    const size_t start_index = str.size();
-    str.resize(str.size() + max_digits);
+    char* const dest = sink.prepare(max_digits);
+    if(dest == nullptr) return;
 
-    // Append the number to the end of str
-    mpz_get_str(str.data() + start_index, base, val);
-
-    // Resize where prior allocation exceeded the actual need
-    const size_t null_terminator_index = str.find('\0', start_index);
-    str.resize(null_terminator_index);
+    mpz_get_str(dest, base, val);
+    sink.commit(dest + std::strlen(dest));
 }
 
-void write_big_int(std::string& str, const fmpz_t val) {
-    // Resize str to ensure sufficient capacity for the largest possible number
+void write_big_int(SinkRef sink, const fmpz_t val) {
     static constexpr size_t base = 10;
     static constexpr size_t PLUS_ONE_FOR_SIGN = 1;
     static constexpr size_t PLUS_ONE_FOR_NULL_TERMINATOR = 1;
 
     const size_t max_digits = fmpz_sizeinbase(val, base) + (PLUS_ONE_FOR_SIGN + PLUS_ONE_FOR_NULL_TERMINATOR);
-    const size_t start_index = str.size();
-    str.resize(str.size() + max_digits);
+    char* const dest = sink.prepare(max_digits);
+    if(dest == nullptr) return;
 
-    // Append the number to the end of str
-    fmpz_get_str(str.data() + start_index, base, val);
+    fmpz_get_str(dest, base, val);
+    sink.commit(dest + std::strlen(dest));
+}
 
-    // Resize where prior allocation exceeded the actual need
-    const size_t null_terminator_index = str.find('\0', start_index);
-    str.resize(null_terminator_index);
+void write_big_int(SinkRef sink, const fmpz val) {
+    write_big_int(sink, &val);
 }
 
-void write_big_int(std::string &str, const fmpz val) {
+void write_big_int(std::string& str, const mpz_t val) {
+    StringSink sink(str);
+    write_big_int(sink, val);
+}
+
+void write_big_int(std::string& str, const fmpz_t val) {
+    StringSink sink(str);
+    write_big_int(sink, val);
+}
+
+void write_big_int(std::string& str, const fmpz val) {
     write_big_int(str, &val);
 }
 
@@ -203,38 +261,34 @@ void write_big_int_term(std::string& str, const fmpz val) {
     }
 }
 
-static void write_big_int(std::string& str, const fmpz_t val, bool is_negative) {
-    // Resize str to ensure sufficient capacity for the largest possible number
+static void write_big_int_magnitude(SinkRef sink, const fmpz_t val, bool is_negative) {
     static constexpr size_t base = 10;
     static constexpr size_t PLUS_ONE_FOR_SIGN = 1;
     static constexpr size_t PLUS_ONE_FOR_NULL_TERMINATOR = 1;
 
     const size_t max_digits = fmpz_sizeinbase(val, base) + (PLUS_ONE_FOR_SIGN + PLUS_ONE_FOR_NULL_TERMINATOR);
-    const size_t start_index = str.size();
-    str.resize(str.size() + max_digits);
-
-    // Append the number to the end of str, overwriting any sign character
-    const char backup = str[start_index-1];
-    fmpz_get_str(str.data() + start_index - is_negative, base, val);
-    str[start_index-1] = backup;
-
-    // Resize where prior allocation exceeded the actual need
-    const size_t null_terminator_index = str.find('\0', start_index);
-    str.resize(null_terminator_index);
+    char* const dest = sink.prepare(max_digits);
+    if(dest == nullptr) return;
+
+    // Write the number, then shift left over any sign character
+    fmpz_get_str(dest, base, val);
+    const size_t length = std::strlen(dest);
+    if(is_negative) std::memmove(dest, dest+1, length-1);
+    sink.commit(dest + length - is_negative);
 }
 
-template<bool typeset_fraction> void write_big_rational(std::string& str, const fmpq_t val) {
+template<bool typeset_fraction> void write_big_rational(SinkRef sink, const fmpq_t val) {
     const fmpz* num = fmpq_numref(val);
     const fmpz* den = fmpq_denref(val);
 
     if(typeset_fraction){
         const bool is_negative = (fmpz_sgn(num) == -1);
-        if(is_negative) str += '-';
-        str += "⁜f⏴";
-        write_big_int(str, num, is_negative);
-        str += "⏵⏴";
-        write_big_int(str, den, false);
-        str += "⏵";
+        if(is_negative) sink_append(sink, "-");
+        sink_append(sink, "⁜f⏴");
+        write_big_int_magnitude(sink, num, is_negative);
+        sink_append(sink, "⏵⏴");
+        write_big_int_magnitude(sink, den, false);
+        sink_append(sink, "⏵");
     }else{
         static constexpr size_t base = 10;
         static constexpr size_t PLUS_ONE_FOR_SIGN = 1;
@@ -242,16 +296,26 @@ template<bool typeset_fraction> void write_big_rational(std::string& str, const
         static constexpr size_t PLUS_ONE_FOR_DIVISION = 1;
         const size_t max_digits = fmpz_sizeinbase10upperbound(num) + fmpz_sizeinbase10upperbound(den)
                                   + (PLUS_ONE_FOR_SIGN + PLUS_ONE_FOR_NULL_TERMINATOR + PLUS_ONE_FOR_DIVISION);
-        const size_t start_index = str.size();
-        str.resize(str.size() + max_digits);
+        char* const dest = sink.prepare(max_digits);
+        if(dest == nullptr) return;
 
-        _fmpq_get_str(str.data() + start_index, base, num, den);
-
-        // Resize where prior allocation exceeded the actual need
-        const size_t null_terminator_index = str.find('\0', start_index);
-        str.resize(null_terminator_index);
+        _fmpq_get_str(dest, base, num, den);
+        sink.commit(dest + std::strlen(dest));
     }
 }
+template void write_big_rational<false>(SinkRef, const fmpq_t);
+template void write_big_rational<true>(SinkRef, const fmpq_t);
+
+template<bool typeset_fraction> void write_big_rational(SinkRef sink, const fmpq val) {
+    write_big_rational<typeset_fraction>(sink, &val);
+}
+template void write_big_rational<false>(SinkRef, const fmpq);
+template void write_big_rational<true>(SinkRef, const fmpq);
+
+template<bool typeset_fraction> void write_big_rational(std::string& str, const fmpq_t val) {
+    StringSink sink(str);
+    write_big_rational<typeset_fraction>(sink, val);
+}
 template void write_big_rational<false>(std::string&, const fmpq_t);
 template void write_big_rational<true>(std::string&, const fmpq_t);
 
@@ -286,10 +350,91 @@ inline static fmpq conv(NativeRational val) {
     return ans;
 }
 
+/// Set an mpz_t from the digits of a string, skipping any decimal point.
+/// The null-terminated copy for mpz_set_str comes from the GMP memory functions, so it may use the arena.
+static void mpz_init_set_digits(mpz_t f, std::string_view str, size_t decimal_index) {
+    const std::string_view integer_digits = str.substr(0, decimal_index);
+    const std::string_view fraction_digits =
+        str.substr((decimal_index == std::string::npos) ? str.size() : decimal_index+1);
+    const size_t num_digits = integer_digits.size() + fraction_digits.size();
+    assert(num_digits != 0);
+
+    void* (*gmp_allocate)(size_t);
+    void (*gmp_free)(void*, size_t);
+    mp_get_memory_functions(&gmp_allocate, nullptr, &gmp_free);
+    const size_t buffer_size = num_digits + 1;
+    char* digits = static_cast<char*>(gmp_allocate(buffer_size));
+    std::memcpy(digits, integer_digits.data(), integer_digits.size());
+    std::memcpy(digits + integer_digits.size(), fraction_digits.data(), fraction_digits.size());
+    digits[num_digits] = '\0';
+
+    mpz_init(f);
+    const auto code = mpz_set_str(f, digits, 10);
+    assert(code == 0);
+    gmp_free(digits, buffer_size);
+}
+
+/// Reduce num/den to a canonical fmpq allocated outside of any GmpArenaScope, and clear num and den
+static fmpq fmpq_from_mpz_canonicalise_clear(mpz_t num, mpz_t den) {
+    mpz_t gcd;
+    mpz_init(gcd);
+    mpz_gcd(gcd, num, den);
+    if(mpz_cmp_ui(gcd, 1) > 0){
+        mpz_divexact(num, num, gcd);
+        mpz_divexact(den, den, gcd);
+    }
+    mpz_clear(gcd);
+
+    fmpq result {0, 0};
+    {
+        GmpArenaBypass bypass;
+        fmpz_set_mpz(&result.num, num);
+        fmpz_set_mpz(&result.den, den);
+    }
+
+    // Clear in reverse order of allocation so an arena may reclaim the memory immediately
+    mpz_clear(den);
+    mpz_clear(num);
+
+    return result;
+}
+
+/// Largest power of ten applied to the digits of a decimal string with mpz_ui_pow_ui
+static constexpr size_t MAX_MPZ_EXPONENT = std::numeric_limits<unsigned long>::max() / 2;
+
+/// Parse the digits of a decimal string multiplied by 10^±exponent.
+/// Temporaries are GMP integers rather than Flint integers, so they may use the arena of a GmpArenaScope.
+static fmpq fmpq_from_digits_times_10_pow(std::string_view str, size_t decimal_index, size_t exponent, bool is_negative_exponent) {
+    assert(exponent <= MAX_MPZ_EXPONENT && str.size() <= MAX_MPZ_EXPONENT);
+
+    // The value is digits·10^(±exponent - fraction_digits)
+    const size_t fraction_digits = (decimal_index == std::string::npos) ? 0 : str.size() - (decimal_index+1);
+    size_t num_power = 0;
+    size_t den_power = 0;
+    if(is_negative_exponent) den_power = exponent + fraction_digits;
+    else if(exponent >= fraction_digits) num_power = exponent - fraction_digits;
+    else den_power = fraction_digits - exponent;
+
+    mpz_t num, den;
+    mpz_init_set_digits(num, str, decimal_index);
+    mpz_init(den);
+    if(num_power != 0){
+        mpz_ui_pow_ui(den, 10, static_cast<unsigned long>(num_power));
+        mpz_mul(num, num, den);
+        mpz_set_ui(den, 1);
+    }else{
+        mpz_ui_pow_ui(den, 10, static_cast<unsigned long>(den_power));
+    }
+
+    return fmpq_from_mpz_canonicalise_clear(num, den);
+}
+
 fmpq fmpq_from_decimal_str(std::string_view str) {
     const auto decimal_index = str.find('.');
-    if(decimal_index == std::string::npos) return {fmpz_from_strview(str), *FMPZ_ONE};
-    else return fmpq_from_decimal_str(str, decimal_index);
+    if(decimal_index != std::string::npos) return fmpq_from_decimal_str(str, decimal_index);
+
+    GmpArenaBypass bypass;
+    return {fmpz_from_strview(str), *FMPZ_ONE};
 }
 
 fmpq fmpq_from_decimal_str(std::string_view str, size_t decimal_index) {
@@ -297,18 +442,7 @@ fmpq fmpq_from_decimal_str(std::string_view str, size_t decimal_index) {
     if(ckd_strdecimal2rat(&result, str, decimal_index) == false)
         return conv(result);
 
-    fmpz lead = fmpz_from_strview(str.substr(0, decimal_index));
-
-    fmpz num = fmpz_from_strview(str.substr(decimal_index+1));
-    fmpz den = 0;
-    fmpz_10_pow_ui(&den, str.size()-(decimal_index+1));
-    fmpq_t tail {{num, den}};
-    fmpq_canonicalise(tail);
-
-    fmpq_add_fmpz(tail, tail, &lead);
-    fmpz_clear(&lead);
-
-    return *tail;
+    return fmpq_from_digits_times_10_pow(str, decimal_index, 0, false);
 }
 
 fmpq fmpq_from_scientific_str(std::string_view str) {
@@ -319,25 +453,25 @@ fmpq fmpq_from_scientific_str(std::string_view str) {
     const size_t e_index = str.find('e');
     assert(e_index != std::string::npos);
 
-    fmpq lhs = fmpq_from_decimal_str(str.substr(0, e_index));
-
     size_t exp_start = e_index + 1;
 
     const bool hasNegativePrefix = (str[exp_start] == '-');
     const bool hasPositivePrefix = (str[exp_start] == '+');
     exp_start += (hasNegativePrefix || hasPositivePrefix);
     const std::string_view exp_digits = str.substr(exp_start);
-
-    fmpz tenPower = 0;
+    const std::string_view significand = str.substr(0, e_index);
 
     size_t native_exp;
-    if(ckd_str2int(&native_exp, exp_digits) == false){
-        fmpz_10_pow_ui(&tenPower, native_exp);
-    }else{
-        fmpz exp = fmpz_from_strview(exp_digits);
-        fmpz_10_pow_fmpz(&tenPower, &exp);
-        fmpz_clear(&exp);
-    }
+    if(ckd_str2int(&native_exp, exp_digits) == false && native_exp <= MAX_MPZ_EXPONENT)
+        return fmpq_from_digits_times_10_pow(significand, significand.find('.'), native_exp, hasNegativePrefix);
+
+    // The exponent is too large for GMP, and the result may not fit in memory
+    GmpArenaBypass bypass;
+    fmpq lhs = fmpq_from_decimal_str(significand);
+    fmpz tenPower = 0;
+    fmpz exp = fmpz_from_strview(exp_digits);
+    fmpz_10_pow_fmpz(&tenPower, &exp);
+    fmpz_clear(&exp);
 
     const auto op = hasNegativePrefix ? &fmpq_div_fmpz : &fmpq_mul_fmpz;
     (*op)(&lhs, &lhs, &tenPower);
@@ -382,60 +516,52 @@ fmpz fmpz_from_scientific_str(std::string_view str) {
     return lhs;
 }
 
-#if !defined(NDEBUG) && defined(TEST_GMP_LEAKS)
-static std::allocator<size_t> allocator;
-static std::unordered_set<const void*> allocated_memory;
-static std::shared_mutex allocation_mutex;
-
-static void* leakTrackingAlloc(size_t n) {
-    allocation_mutex.lock_shared();
-    size_t* allocated = allocator.allocate(n);
-    if(allocated){
-        const auto result = allocated_memory.insert(allocated);
-        assert(result.second);
-    }
-    allocation_mutex.unlock_shared();
+Int int_from_strview(std::string_view str) {
+    return Int::adopt(fmpz_from_strview(str));
+}
 
-    return allocated;
+Int int_from_scientific_str(std::string_view str) {
+    return Int::adopt(fmpz_from_scientific_str(str));
 }
 
-static void leakTrackingFree(void* p, size_t old) noexcept {
-    allocation_mutex.lock_shared();
-    allocated_memory.erase(p);
-    allocator.deallocate(reinterpret_cast<size_t*>(p), old);
-    allocation_mutex.unlock_shared();
+Rat rat_from_decimal_str(std::string_view str) {
+    return Rat::adopt(fmpq_from_decimal_str(str));
 }
 
-static void* leakTrackingRealloc(void* p, size_t old, size_t n) {
-    void* reallocated = nullptr;
-    if(n != 0){
-        reallocated = leakTrackingAlloc(n);
-        memcpy(reallocated, p, sizeof(size_t)*std::min(old, n));
-    }
-    leakTrackingFree(p, old);
-    return reallocated;
+Rat rat_from_decimal_str(std::string_view str, size_t decimal_index) {
+    return Rat::adopt(fmpq_from_decimal_str(str, decimal_index));
 }
 
+Rat rat_from_scientific_str(std::string_view str) {
+    return Rat::adopt(fmpq_from_scientific_str(str));
+}
+
+#if !defined(NDEBUG) && defined(TEST_GMP_LEAKS)
 struct Init {
     Init(){
-        mp_set_memory_functions(leakTrackingAlloc, leakTrackingRealloc, leakTrackingFree);
+        install_allocation_tracker();
         std::cout << "GMP leak checking is active" << std::endl;
 
-        // EVENTUALLY: could also use __flint_set_memory_functions
-        // Unfortunately this is flaky. It would be good to get rid of the TEST_GMP_LEAKS macro,
+        // Flint allocations are tracked too, but Flint keeps caches alive between calls,
+        // so only GMP allocations are leak checked.
+        // EVENTUALLY: It would be good to get rid of the TEST_GMP_LEAKS macro,
         // and always use these tests in debug builds.
     }
 };
 
 static Init memoryTrackingInit;
 
+/// Live allocations already reported as leaked, which are not reported again
+static int64_t reported_allocations = 0;
+
 bool isAllGmpMemoryFreed() noexcept {
-    return allocated_memory.empty();
+    return allocation_stats().liveAllocations() <= reported_allocations;
 }
 
 bool isAllGmpMemoryFreed_resetIfNot() noexcept {
-    const bool all_freed = isAllGmpMemoryFreed();
-    if(!all_freed) allocated_memory.clear();
+    const int64_t live_allocations = allocation_stats().liveAllocations();
+    const bool all_freed = live_allocations <= reported_allocations;
+    reported_allocations = live_allocations;
     return all_freed;
 }
 
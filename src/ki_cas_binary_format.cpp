@@ -0,0 +1,238 @@
+#include "ki_cas_binary_format.h"
+
+#include <algorithm>
+#include <bit>
+#include <cassert>
+#include <cstdlib>
+#include <cstring>
+
+namespace KiCAS2 {
+
+/// The magnitude of an fmpz as limbs, least significant first, which refers to the fmpz if it is a GMP integer
+struct Magnitude {
+    const mp_limb_t* limbs;
+    size_t num_limbs;
+    bool is_negative;
+    mp_limb_t small;
+};
+
+static Magnitude magnitude(const fmpz* val) noexcept {
+    Magnitude result = {};
+    if(!COEFF_IS_MPZ(*val)){
+        result.small = static_cast<mp_limb_t>(*val < 0 ? -static_cast<ulong>(*val) : static_cast<ulong>(*val));
+        result.limbs = nullptr;
+        result.num_limbs = (result.small != 0);
+        result.is_negative = *val < 0;
+    }else{
+        const __mpz_struct* z = COEFF_TO_PTR(*val);
+        result.limbs = z->_mp_d;
+        result.num_limbs = static_cast<size_t>(std::abs(z->_mp_size));
+        result.is_negative = z->_mp_size < 0;
+    }
+    return result;
+}
+
+static size_t magnitude_bytes(const mp_limb_t* limbs, size_t num_limbs) noexcept {
+    if(num_limbs == 0) return 0;
+    const mp_limb_t top = limbs[num_limbs-1];
+    return (num_limbs-1)*sizeof(mp_limb_t) + (std::bit_width(top) + 7) / 8;
+}
+
+static size_t varint_size(size_t val) noexcept {
+    return std::max<size_t>(1, (std::bit_width(val) + 6) / 7);
+}
+
+static char* encode_varint(char* dest, size_t val) noexcept {
+    while(val >= 0x80){
+        *dest++ = static_cast<char>(val | 0x80);
+        val >>= 7;
+    }
+    *dest++ = static_cast<char>(val);
+    return dest;
+}
+
+static char* encode_magnitude(char* dest, const mp_limb_t* limbs, size_t num_bytes) noexcept {
+    if constexpr(std::endian::native == std::endian::little){
+        std::memcpy(dest, limbs, num_bytes);
+    }else{
+        for(size_t i = 0; i < num_bytes; i++)
+            dest[i] = static_cast<char>(limbs[i / sizeof(mp_limb_t)] >> (8 * (i % sizeof(mp_limb_t))));
+    }
+    return dest + num_bytes;
+}
+
+/// Fill num_limbs limbs from the bytes, which do not exceed the limbs
+static void decode_magnitude(mp_limb_t* limbs, size_t num_limbs, const char* src, size_t num_bytes) noexcept {
+    assert(num_bytes <= num_limbs*sizeof(mp_limb_t));
+    limbs[num_limbs-1] = 0;
+    if constexpr(std::endian::native == std::endian::little){
+        std::memcpy(limbs, src, num_bytes);
+    }else{
+        for(size_t i = 0; i < num_limbs; i++) limbs[i] = 0;
+        for(size_t i = 0; i < num_bytes; i++)
+            limbs[i / sizeof(mp_limb_t)] |= static_cast<mp_limb_t>(static_cast<unsigned char>(src[i])) << (8 * (i % sizeof(mp_limb_t)));
+    }
+}
+
+static char* encode_native_rational(char* dest, NativeRational val) noexcept {
+    return encode_varint(encode_varint(dest, val.num), val.den);
+}
+
+static char* encode_fmpz(char* dest, const fmpz* val) noexcept {
+    const Magnitude mag = magnitude(val);
+    const mp_limb_t* limbs = mag.limbs ? mag.limbs : &mag.small;
+    const size_t num_bytes = magnitude_bytes(limbs, mag.num_limbs);
+    dest = encode_varint(dest, (num_bytes << 1) | mag.is_negative);
+    return encode_magnitude(dest, limbs, num_bytes);
+}
+
+static char* encode_fmpq(char* dest, const fmpq* val) noexcept {
+    return encode_fmpz(encode_fmpz(dest, fmpq_numref(val)), fmpq_denref(val));
+}
+
+size_t binary_size(size_t val) noexcept {
+    return varint_size(val);
+}
+
+size_t binary_size(NativeRational val) noexcept {
+    return varint_size(val.num) + varint_size(val.den);
+}
+
+size_t binary_size(const fmpz_t val) noexcept {
+    const Magnitude mag = magnitude(val);
+    const size_t num_bytes = magnitude_bytes(mag.limbs ? mag.limbs : &mag.small, mag.num_limbs);
+    return varint_size(num_bytes << 1) + num_bytes;
+}
+
+size_t binary_size(const fmpq_t val) noexcept {
+    return binary_size(fmpq_numref(val)) + binary_size(fmpq_denref(val));
+}
+
+/// Size of an array element, where fmpz and fmpq arrays hold values rather than pointers
+static size_t element_size(size_t val) noexcept { return binary_size(val); }
+static size_t element_size(NativeRational val) noexcept { return binary_size(val); }
+static size_t element_size(const fmpz& val) noexcept { return binary_size(&val); }
+static size_t element_size(const fmpq& val) noexcept { return binary_size(&val); }
+
+template<typename T, typename Encode>
+static void write_binary(SinkRef sink, const T* vals, size_t num_vals, Encode encode) {
+    size_t size = 0;
+    for(size_t i = 0; i < num_vals; i++) size += element_size(vals[i]);
+
+    char* dest = sink.prepare(size);
+    if(dest == nullptr) return;
+    for(size_t i = 0; i < num_vals; i++) dest = encode(dest, vals[i]);
+    sink.commit(dest);
+}
+
+void write_binary_native_int(SinkRef sink, size_t val) {
+    write_binary(sink, &val, 1, encode_varint);
+}
+
+void write_binary_native_rational(SinkRef sink, NativeRational val) {
+    write_binary(sink, &val, 1, encode_native_rational);
+}
+
+void write_binary_big_int(SinkRef sink, const fmpz_t val) {
+    write_binary(sink, val, 1, [](char* dest, const fmpz& val){ return encode_fmpz(dest, &val); });
+}
+
+void write_binary_big_rational(SinkRef sink, const fmpq_t val) {
+    write_binary(sink, val, 1, [](char* dest, const fmpq& val){ return encode_fmpq(dest, &val); });
+}
+
+void write_binary_native_ints(SinkRef sink, const size_t* vals, size_t num_vals) {
+    write_binary(sink, vals, num_vals, encode_varint);
+}
+
+void write_binary_native_rationals(SinkRef sink, const NativeRational* vals, size_t num_vals) {
+    write_binary(sink, vals, num_vals, encode_native_rational);
+}
+
+void write_binary_big_ints(SinkRef sink, const fmpz* vals, size_t num_vals) {
+    write_binary(sink, vals, num_vals, [](char* dest, const fmpz& val){ return encode_fmpz(dest, &val); });
+}
+
+void write_binary_big_rationals(SinkRef sink, const fmpq* vals, size_t num_vals) {
+    write_binary(sink, vals, num_vals, [](char* dest, const fmpq& val){ return encode_fmpq(dest, &val); });
+}
+
+bool read_binary_native_int(size_t* result, std::string_view& bytes) noexcept {
+    size_t val = 0;
+    for(size_t i = 0; i < bytes.size() && i < BINARY_VARINT_MAX_BYTES; i++){
+        const size_t byte = static_cast<unsigned char>(bytes[i]);
+        const size_t shift = 7*i;
+
+        // Reject bits beyond the size_t, e.g. a 64-bit value read on a 32-bit target
+        if(shift + 7 > 8*sizeof(size_t) && (byte & 0x7f) >> (8*sizeof(size_t) - shift) != 0) return true;
+
+        val |= (byte & 0x7f) << shift;
+        if(byte < 0x80){
+            *result = val;
+            bytes.remove_prefix(i+1);
+            return false;
+        }
+    }
+
+    return true;
+}
+
+bool read_binary_native_rational(NativeRational* result, std::string_view& bytes) noexcept {
+    return read_binary_native_int(&result->num, bytes)
+        || read_binary_native_int(&result->den, bytes)
+        || result->den == 0;
+}
+
+bool read_binary_big_int(fmpz_t result, std::string_view& bytes) {
+    size_t header;
+    if(read_binary_native_int(&header, bytes)) return true;
+    const size_t num_bytes = header >> 1;
+    const bool is_negative = header & 1;
+    if(num_bytes > bytes.size() || (num_bytes == 0 && is_negative)) return true;
+
+    if(num_bytes <= sizeof(mp_limb_t)){
+        mp_limb_t val = 0;
+        if(num_bytes != 0) decode_magnitude(&val, 1, bytes.data(), num_bytes);
+        if(is_negative) fmpz_neg_ui(result, val);
+        else fmpz_set_ui(result, val);
+    }else{
+        const size_t num_limbs = (num_bytes + sizeof(mp_limb_t) - 1) / sizeof(mp_limb_t);
+        const mpz_ptr z = _fmpz_promote(result);
+        decode_magnitude(mpz_limbs_write(z, static_cast<mp_size_t>(num_limbs)), num_limbs, bytes.data(), num_bytes);
+        mpz_limbs_finish(z, is_negative ? -static_cast<mp_size_t>(num_limbs) : static_cast<mp_size_t>(num_limbs));
+
+        // Only needed for input with high zero bytes, which this library does not write
+        _fmpz_demote_val(result);
+    }
+
+    bytes.remove_prefix(num_bytes);
+    return false;
+}
+
+bool read_binary_big_rational(fmpq_t result, std::string_view& bytes) {
+    return read_binary_big_int(fmpq_numref(result), bytes)
+        || read_binary_big_int(fmpq_denref(result), bytes)
+        || fmpz_sgn(fmpq_denref(result)) <= 0;
+}
+
+bool read_binary_native_ints(size_t* result, size_t num_vals, std::string_view& bytes) noexcept {
+    for(size_t i = 0; i < num_vals; i++) if(read_binary_native_int(result + i, bytes)) return true;
+    return false;
+}
+
+bool read_binary_native_rationals(NativeRational* result, size_t num_vals, std::string_view& bytes) noexcept {
+    for(size_t i = 0; i < num_vals; i++) if(read_binary_native_rational(result + i, bytes)) return true;
+    return false;
+}
+
+bool read_binary_big_ints(fmpz* result, size_t num_vals, std::string_view& bytes) {
+    for(size_t i = 0; i < num_vals; i++) if(read_binary_big_int(result + i, bytes)) return true;
+    return false;
+}
+
+bool read_binary_big_rationals(fmpq* result, size_t num_vals, std::string_view& bytes) {
+    for(size_t i = 0; i < num_vals; i++) if(read_binary_big_rational(result + i, bytes)) return true;
+    return false;
+}
+
+}  // namespace KiCAS2
@@ -0,0 +1,202 @@
+#include "ki_cas_constant_table.h"
+
+#include <bit>
+#include <cstdlib>
+#include <cstring>
+#include <utility>
+
+#ifdef _WIN32
+#define WIN32_LEAN_AND_MEAN
+#include <windows.h>
+#else
+#include <fcntl.h>
+#include <sys/mman.h>
+#include <sys/stat.h>
+#include <unistd.h>
+#endif
+
+namespace KiCAS2 {
+
+static constexpr char CONSTANT_TABLE_MAGIC[8] = "KICASCT";
+
+struct TableHeader {
+    char magic[8];
+    uint32_t version;
+    uint8_t limb_bytes;
+    uint8_t is_big_endian;
+    uint16_t reserved;
+    uint64_t num_entries;
+};
+
+struct ConstantTable::IndexEntry {
+    uint64_t limb_offset;
+    int64_t size;  ///< Number of limbs, negated for negative values, following the mpz convention
+};
+
+static_assert(sizeof(TableHeader) % sizeof(mp_limb_t) == 0, "The index and limbs must be aligned to a limb");
+static_assert(sizeof(ConstantTable::IndexEntry) % sizeof(mp_limb_t) == 0, "The limbs must be aligned to a limb");
+
+void write_constant_table(SinkRef sink, const fmpz* vals, size_t num_vals) {
+    size_t num_limbs = 0;
+    for(size_t i = 0; i < num_vals; i++) num_limbs += fmpz_size(vals + i);
+
+    const size_t size = sizeof(TableHeader) + num_vals*sizeof(ConstantTable::IndexEntry) + num_limbs*sizeof(mp_limb_t);
+    char* const begin = sink.prepare(size);
+    if(begin == nullptr) return;
+
+    TableHeader header = {};
+    std::memcpy(header.magic, CONSTANT_TABLE_MAGIC, sizeof(header.magic));
+    header.version = CONSTANT_TABLE_VERSION;
+    header.limb_bytes = sizeof(mp_limb_t);
+    header.is_big_endian = std::endian::native == std::endian::big;
+    header.num_entries = num_vals;
+    std::memcpy(begin, &header, sizeof(header));
+
+    char* index_dest = begin + sizeof(TableHeader);
+    char* limb_dest = index_dest + num_vals*sizeof(ConstantTable::IndexEntry);
+    uint64_t limb_offset = 0;
+    for(size_t i = 0; i < num_vals; i++){
+        const fmpz val = vals[i];
+        mp_limb_t small;
+        const mp_limb_t* val_limbs;
+        ConstantTable::IndexEntry entry = {limb_offset, 0};
+        if(!COEFF_IS_MPZ(val)){
+            small = static_cast<mp_limb_t>(val < 0 ? -static_cast<ulong>(val) : static_cast<ulong>(val));
+            val_limbs = &small;
+            entry.size = val < 0 ? -1 : (val > 0);
+        }else{
+            val_limbs = COEFF_TO_PTR(val)->_mp_d;
+            entry.size = COEFF_TO_PTR(val)->_mp_size;
+        }
+
+        const size_t val_bytes = static_cast<size_t>(std::abs(entry.size))*sizeof(mp_limb_t);
+        std::memcpy(index_dest, &entry, sizeof(entry));
+        std::memcpy(limb_dest, val_limbs, val_bytes);
+        index_dest += sizeof(entry);
+        limb_dest += val_bytes;
+        limb_offset += static_cast<uint64_t>(std::abs(entry.size));
+    }
+
+    sink.commit(limb_dest);
+}
+
+ConstantTable::~ConstantTable() {
+    reset();
+}
+
+ConstantTable::ConstantTable(ConstantTable&& other) noexcept
+    : index(std::exchange(other.index, nullptr)),
+      limbs(std::exchange(other.limbs, nullptr)),
+      num_entries(std::exchange(other.num_entries, 0)),
+      mapping(std::exchange(other.mapping, nullptr)),
+      mapping_size(std::exchange(other.mapping_size, 0)) {}
+
+ConstantTable& ConstantTable::operator=(ConstantTable&& other) noexcept {
+    std::swap(index, other.index);
+    std::swap(limbs, other.limbs);
+    std::swap(num_entries, other.num_entries);
+    std::swap(mapping, other.mapping);
+    std::swap(mapping_size, other.mapping_size);
+    return *this;
+}
+
+bool ConstantTable::validate(const char* begin, size_t num_bytes) noexcept {
+    if(num_bytes < sizeof(TableHeader) || reinterpret_cast<uintptr_t>(begin) % alignof(mp_limb_t) != 0) return true;
+
+    TableHeader header;
+    std::memcpy(&header, begin, sizeof(header));
+    if(std::memcmp(header.magic, CONSTANT_TABLE_MAGIC, sizeof(header.magic)) != 0
+        || header.version != CONSTANT_TABLE_VERSION
+        || header.limb_bytes != sizeof(mp_limb_t)
+        || header.is_big_endian != (std::endian::native == std::endian::big)
+        || header.num_entries > (num_bytes - sizeof(TableHeader)) / sizeof(IndexEntry)) return true;
+
+    const IndexEntry* const table_index = reinterpret_cast<const IndexEntry*>(begin + sizeof(TableHeader));
+    const size_t index_bytes = static_cast<size_t>(header.num_entries) * sizeof(IndexEntry);
+    const size_t num_limbs = (num_bytes - sizeof(TableHeader) - index_bytes) / sizeof(mp_limb_t);
+    for(size_t i = 0; i < header.num_entries; i++){
+        // Negate as unsigned, since std::abs of INT64_MIN is undefined
+        const int64_t entry_size = table_index[i].size;
+        const uint64_t entry_limbs = entry_size < 0 ? uint64_t(0) - static_cast<uint64_t>(entry_size)
+                                                    : static_cast<uint64_t>(entry_size);
+        if(entry_limbs > num_limbs || table_index[i].limb_offset > num_limbs - entry_limbs) return true;
+    }
+
+    index = table_index;
+    limbs = reinterpret_cast<const mp_limb_t*>(begin + sizeof(TableHeader) + index_bytes);
+    num_entries = static_cast<size_t>(header.num_entries);
+    return false;
+}
+
+bool ConstantTable::map(const char* path) {
+    reset();
+
+    #ifdef _WIN32
+    const HANDLE file = CreateFileA(path, GENERIC_READ, FILE_SHARE_READ, nullptr, OPEN_EXISTING, FILE_ATTRIBUTE_NORMAL, nullptr);
+    if(file == INVALID_HANDLE_VALUE) return true;
+    LARGE_INTEGER file_size;
+    const HANDLE file_mapping = (GetFileSizeEx(file, &file_size) && file_size.QuadPart > 0)
+        ? CreateFileMappingA(file, nullptr, PAGE_READONLY, 0, 0, nullptr) : nullptr;
+    CloseHandle(file);
+    if(file_mapping == nullptr) return true;
+    void* const address = MapViewOfFile(file_mapping, FILE_MAP_READ, 0, 0, 0);
+    CloseHandle(file_mapping);
+    if(address == nullptr) return true;
+    const size_t num_bytes = static_cast<size_t>(file_size.QuadPart);
+    #else
+    const int fd = ::open(path, O_RDONLY);
+    if(fd < 0) return true;
+    struct stat file_stat;
+    void* address = MAP_FAILED;
+    if(::fstat(fd, &file_stat) == 0 && file_stat.st_size > 0)
+        address = ::mmap(nullptr, static_cast<size_t>(file_stat.st_size), PROT_READ, MAP_PRIVATE, fd, 0);
+    ::close(fd);
+    if(address == MAP_FAILED) return true;
+    const size_t num_bytes = static_cast<size_t>(file_stat.st_size);
+    #endif
+
+    mapping = address;
+    mapping_size = num_bytes;
+    if(validate(static_cast<const char*>(address), num_bytes)){
+        reset();
+        return true;
+    }
+
+    return false;
+}
+
+bool ConstantTable::view(std::string_view bytes) {
+    reset();
+    return validate(bytes.data(), bytes.size());
+}
+
+void ConstantTable::reset() noexcept {
+    if(mapping != nullptr){
+        #ifdef _WIN32
+        UnmapViewOfFile(mapping);
+        #else
+        ::munmap(mapping, mapping_size);
+        #endif
+    }
+
+    index = nullptr;
+    limbs = nullptr;
+    num_entries = 0;
+    mapping = nullptr;
+    mapping_size = 0;
+}
+
+MP_INT ConstantTable::entry(size_t i) const noexcept {
+    MP_INT result;
+    mpz_roinit_n(&result, limbs + index[i].limb_offset, static_cast<mp_size_t>(index[i].size));
+    return result;
+}
+
+Int ConstantTable::materialise(size_t i) const {
+    const MP_INT view = entry(i);
+    Int result;
+    fmpz_set_mpz(result.get(), &view);
+    return result;
+}
+
+}  // namespace KiCAS2
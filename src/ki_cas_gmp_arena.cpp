@@ -0,0 +1,170 @@
+#include "ki_cas_gmp_arena.h"
+
+#include "ki_cas_numeric_allocator.h"
+
+#include <algorithm>
+#include <cstddef>
+#include <cstdlib>
+#include <cstring>
+#include <vector>
+
+namespace KiCAS2 {
+
+static constexpr size_t ARENA_ALIGNMENT = alignof(std::max_align_t);
+static constexpr size_t FIRST_BLOCK_SIZE = 64 * 1024;
+static constexpr size_t MAX_BLOCK_SIZE = 4 * 1024 * 1024;
+
+struct ArenaBlock {
+    char* data;
+    size_t capacity;
+};
+
+/// Blocks are kept when a scope ends, so later scopes on the thread reuse them
+struct ThreadArena {
+    std::vector<ArenaBlock> blocks;
+    size_t block_index = 0;
+    size_t used = 0;
+
+    ~ThreadArena() {
+        for(const ArenaBlock& block : blocks) std::free(block.data);
+    }
+};
+
+static thread_local ThreadArena thread_arena;
+
+// Trivial thread locals, so that allocations outside of a scope do not initialise the arena
+static thread_local size_t scope_depth = 0;
+static thread_local bool arena_is_allocating = false;
+static thread_local size_t arena_allocations = 0;
+static thread_local size_t heap_allocations = 0;
+
+static NumericAllocator prior = {};
+
+static constexpr size_t round_to_alignment(size_t n) noexcept {
+    return (n + (ARENA_ALIGNMENT - 1)) & ~(ARENA_ALIGNMENT - 1);
+}
+
+static void* arena_allocate(size_t n) {
+    ThreadArena& arena = thread_arena;
+    const size_t size = round_to_alignment(n);
+    arena_allocations++;
+
+    // Bump allocate from the current block, or a block kept from an earlier scope
+    for(; arena.block_index < arena.blocks.size(); arena.block_index++, arena.used = 0){
+        const ArenaBlock& block = arena.blocks[arena.block_index];
+        if(block.capacity - arena.used >= size){
+            void* allocated = block.data + arena.used;
+            arena.used += size;
+            return allocated;
+        }
+    }
+
+    const size_t next_capacity = arena.blocks.empty() ? FIRST_BLOCK_SIZE : std::min(2*arena.blocks.back().capacity, MAX_BLOCK_SIZE);
+    const size_t capacity = std::max(size, next_capacity);
+    char* data = static_cast<char*>(std::malloc(capacity));
+    if(data == nullptr) std::abort();  // GMP cannot recover from a failed allocation
+    arena.blocks.push_back(ArenaBlock{data, capacity});
+    arena.block_index = arena.blocks.size() - 1;
+    arena.used = size;
+
+    return data;
+}
+
+static bool arena_owns(const void* p) noexcept {
+    for(const ArenaBlock& block : thread_arena.blocks)
+        if(p >= block.data && p < block.data + block.capacity) return true;
+    return false;
+}
+
+/// Return true if p is the most recent allocation of the current block, which may be resized in place
+static bool is_last_allocation(const void* p, size_t n) noexcept {
+    const ThreadArena& arena = thread_arena;
+    if(arena.block_index >= arena.blocks.size()) return false;
+    const ArenaBlock& block = arena.blocks[arena.block_index];
+    return static_cast<const char*>(p) + round_to_alignment(n) == block.data + arena.used;
+}
+
+/// Flint allocations always pass through, since Flint keeps some of its allocations across calls
+static void* arenaAllocate(size_t n, AllocationSource source) {
+    if(source == AllocationSource::Gmp && arena_is_allocating) return arena_allocate(n);
+
+    if(source == AllocationSource::Gmp) heap_allocations++;
+    return prior.allocate(n, source);
+}
+
+static void* arenaReallocate(void* p, size_t old, size_t n, AllocationSource source) {
+    if(source == AllocationSource::Flint) return prior.reallocate(p, old, n, source);
+
+    if(scope_depth == 0 || !arena_owns(p)){
+        heap_allocations++;
+        return prior.reallocate(p, old, n, source);
+    }
+
+    ThreadArena& arena = thread_arena;
+    if(is_last_allocation(p, old)){
+        const size_t start = arena.used - round_to_alignment(old);
+        if(arena.blocks[arena.block_index].capacity - start >= round_to_alignment(n)){
+            arena_allocations++;
+            arena.used = start + round_to_alignment(n);
+            return p;
+        }
+    }
+
+    void* reallocated = arena_allocate(n);
+    std::memcpy(reallocated, p, std::min(old, n));
+    return reallocated;
+}
+
+static void arenaDeallocate(void* p, size_t old, AllocationSource source) noexcept {
+    if(source == AllocationSource::Flint || scope_depth == 0 || !arena_owns(p)){
+        prior.deallocate(p, old, source);
+        return;
+    }
+
+    // Memory is released when the scope ends, but the most recent allocation is reclaimed immediately
+    if(is_last_allocation(p, old)) thread_arena.used -= round_to_alignment(old);
+}
+
+static constexpr NumericAllocator ARENA_ALLOCATOR = {arenaAllocate, arenaReallocate, arenaDeallocate};
+
+void install_gmp_arena() noexcept {
+    if(is_gmp_arena_installed()) return;
+    prior = layer_numeric_allocator(ARENA_ALLOCATOR);
+}
+
+bool is_gmp_arena_installed() noexcept {
+    return is_numeric_allocator_installed(ARENA_ALLOCATOR);
+}
+
+GmpArenaScope::GmpArenaScope() noexcept
+    : block_index(thread_arena.block_index), used(thread_arena.used), was_allocating(arena_is_allocating) {
+    scope_depth++;
+    arena_is_allocating = true;
+}
+
+GmpArenaScope::~GmpArenaScope() {
+    thread_arena.block_index = block_index;
+    thread_arena.used = used;
+    arena_is_allocating = was_allocating;
+    scope_depth--;
+}
+
+GmpArenaBypass::GmpArenaBypass() noexcept
+    : was_allocating(arena_is_allocating) {
+    arena_is_allocating = false;
+}
+
+GmpArenaBypass::~GmpArenaBypass() {
+    arena_is_allocating = was_allocating;
+}
+
+GmpArenaStats gmp_arena_stats() noexcept {
+    GmpArenaStats stats;
+    stats.arena_allocations = arena_allocations;
+    stats.heap_allocations = heap_allocations;
+    for(const ArenaBlock& block : thread_arena.blocks) stats.reserved_bytes += block.capacity;
+
+    return stats;
+}
+
+}  // namespace KiCAS2
@@ -0,0 +1,251 @@
+#include "ki_cas_gmp_pool.h"
+
+#include "ki_cas_gmp_arena.h"
+#include "ki_cas_numeric_allocator.h"
+
+#ifdef _MSC_VER
+#include <malloc.h>  // MSC dependencies for GMP
+#endif
+
+#include <gmp.h>
+
+#include <algorithm>
+#include <cstring>
+#include <mutex>
+
+namespace KiCAS2 {
+
+/// A free block stores the next free block of its size class in its first bytes
+struct FreeBlock {
+    FreeBlock* next;
+};
+
+static_assert(sizeof(FreeBlock) <= sizeof(mp_limb_t), "The smallest size class must hold a FreeBlock");
+
+struct FreeList {
+    FreeBlock* head = nullptr;
+    size_t size = 0;
+};
+
+/// Blocks given back by threads with more free blocks than they cache, shared by all threads
+struct ReclaimList {
+    std::mutex mutex;
+    FreeList blocks;
+};
+
+static constexpr size_t NOT_POOLED = GMP_POOL_MAX_LIMBS;
+
+static ReclaimList reclaim_lists[GMP_POOL_MAX_LIMBS];
+
+// Trivial thread locals, so that the pool may be used while other thread locals are destroyed
+static thread_local FreeList thread_lists[GMP_POOL_MAX_LIMBS];
+static thread_local bool thread_is_exiting = false;
+static thread_local bool releaser_is_armed = false;
+static thread_local bool pool_is_bypassed = false;
+static thread_local size_t thread_hits = 0;
+static thread_local size_t reclaim_hits = 0;
+static thread_local size_t misses = 0;
+static thread_local size_t unpooled = 0;
+
+static NumericAllocator prior = {};
+
+/// Pool only whole limb counts, which is what GMP requests for limb buffers. GMP always frees with
+/// the size it requested, so a block of a pooled size allocated before installation is safe to reuse.
+static size_t size_class(size_t n) noexcept {
+    if(pool_is_bypassed || n == 0 || n % sizeof(mp_limb_t) != 0 || n > GMP_POOL_MAX_LIMBS*sizeof(mp_limb_t)) return NOT_POOLED;
+    return n / sizeof(mp_limb_t) - 1;
+}
+
+static size_t block_size(size_t index) noexcept {
+    return (index + 1) * sizeof(mp_limb_t);
+}
+
+static void push(FreeList& list, void* p) noexcept {
+    FreeBlock* block = static_cast<FreeBlock*>(p);
+    block->next = list.head;
+    list.head = block;
+    list.size++;
+}
+
+static void* pop(FreeList& list) noexcept {
+    FreeBlock* block = list.head;
+    list.head = block->next;
+    list.size--;
+    return block;
+}
+
+/// Detach up to num_blocks blocks from the front of the list
+static FreeList split(FreeList& list, size_t num_blocks) noexcept {
+    FreeList front{list.head, std::min(num_blocks, list.size)};
+    if(front.size == 0) return front;
+
+    FreeBlock* last = front.head;
+    for(size_t i = 1; i < front.size; i++) last = last->next;
+    list.head = last->next;
+    list.size -= front.size;
+    last->next = nullptr;
+
+    return front;
+}
+
+static void release(FreeList& list, size_t index) noexcept {
+    while(list.head != nullptr) prior.deallocate(pop(list), block_size(index), AllocationSource::Gmp);
+}
+
+static void give_back(FreeList& batch, size_t index) noexcept {
+    ReclaimList& reclaim = reclaim_lists[index];
+    {
+        std::lock_guard<std::mutex> lock(reclaim.mutex);
+        if(reclaim.blocks.size + batch.size <= GMP_POOL_RECLAIM_BLOCKS){
+            while(batch.head != nullptr) push(reclaim.blocks, pop(batch));
+            return;
+        }
+    }
+
+    release(batch, index);
+}
+
+static bool refill(FreeList& list, size_t index) noexcept {
+    ReclaimList& reclaim = reclaim_lists[index];
+    std::lock_guard<std::mutex> lock(reclaim.mutex);
+    list = split(reclaim.blocks, GMP_POOL_TRANSFER_BLOCKS);
+
+    return list.size != 0;
+}
+
+/// Returns the free blocks of a thread to the reclaim lists on exit
+struct FreeListReleaser {
+    // Writing to the object ensures it is constructed, so that its destructor runs
+    void arm() noexcept { is_armed = true; }
+
+    bool is_armed = false;
+
+    ~FreeListReleaser() {
+        thread_is_exiting = true;
+        for(size_t i = 0; i < GMP_POOL_MAX_LIMBS; i++) give_back(thread_lists[i], i);
+    }
+};
+
+static thread_local FreeListReleaser free_list_releaser;
+
+static void* pool_allocate(size_t n, size_t index) {
+    FreeList& list = thread_lists[index];
+    if(list.head != nullptr){
+        thread_hits++;
+    }else if(refill(list, index)){
+        reclaim_hits++;
+    }else{
+        misses++;
+        return prior.allocate(n, AllocationSource::Gmp);
+    }
+
+    return pop(list);
+}
+
+static void pool_deallocate(void* p, size_t index) noexcept {
+    if(thread_is_exiting){
+        prior.deallocate(p, block_size(index), AllocationSource::Gmp);
+        return;
+    }
+
+    if(!releaser_is_armed){
+        releaser_is_armed = true;
+        free_list_releaser.arm();
+    }
+
+    FreeList& list = thread_lists[index];
+    push(list, p);
+    if(list.size > GMP_POOL_THREAD_CACHE_BLOCKS){
+        FreeList batch = split(list, GMP_POOL_TRANSFER_BLOCKS);
+        give_back(batch, index);
+    }
+}
+
+static void* poolAllocate(size_t n, AllocationSource source) {
+    const size_t index = source == AllocationSource::Gmp ? size_class(n) : NOT_POOLED;
+    if(index != NOT_POOLED) return pool_allocate(n, index);
+
+    if(source == AllocationSource::Gmp) unpooled++;
+    return prior.allocate(n, source);
+}
+
+static void* poolReallocate(void* p, size_t old, size_t n, AllocationSource source) {
+    if(source == AllocationSource::Flint) return prior.reallocate(p, old, n, source);
+
+    const size_t old_index = size_class(old);
+    const size_t new_index = size_class(n);
+    if(old_index == NOT_POOLED && new_index == NOT_POOLED){
+        unpooled++;
+        return prior.reallocate(p, old, n, source);
+    }else if(old_index == new_index){
+        return p;
+    }
+
+    void* reallocated = poolAllocate(n, source);
+    std::memcpy(reallocated, p, std::min(old, n));
+    if(old_index == NOT_POOLED) prior.deallocate(p, old, source);
+    else pool_deallocate(p, old_index);
+
+    return reallocated;
+}
+
+static void poolDeallocate(void* p, size_t old, AllocationSource source) noexcept {
+    const size_t index = source == AllocationSource::Gmp ? size_class(old) : NOT_POOLED;
+    if(index != NOT_POOLED) pool_deallocate(p, index);
+    else prior.deallocate(p, old, source);
+}
+
+static constexpr NumericAllocator POOL_ALLOCATOR = {poolAllocate, poolReallocate, poolDeallocate, trim_gmp_pool};
+
+bool install_gmp_pool() noexcept {
+    if(is_gmp_pool_installed()) return false;
+
+    // Over the arena, a miss within a GmpArenaScope would cache a block which the arena reuses when the scope ends
+    if(is_gmp_arena_installed()) return true;
+
+    prior = layer_numeric_allocator(POOL_ALLOCATOR);
+    return false;
+}
+
+bool is_gmp_pool_installed() noexcept {
+    return is_numeric_allocator_installed(POOL_ALLOCATOR);
+}
+
+void trim_gmp_pool() noexcept {
+    for(size_t i = 0; i < GMP_POOL_MAX_LIMBS; i++){
+        release(thread_lists[i], i);
+
+        FreeList reclaimed;
+        {
+            std::lock_guard<std::mutex> lock(reclaim_lists[i].mutex);
+            std::swap(reclaimed, reclaim_lists[i].blocks);
+        }
+        release(reclaimed, i);
+    }
+}
+
+GmpPoolBypass::GmpPoolBypass() noexcept
+    : was_bypassing(pool_is_bypassed) {
+    pool_is_bypassed = true;
+}
+
+GmpPoolBypass::~GmpPoolBypass() {
+    pool_is_bypassed = was_bypassing;
+}
+
+double GmpPoolStats::hitRate() const noexcept {
+    const size_t hits = thread_hits + reclaim_hits;
+    return hits + misses == 0 ? 0.0 : static_cast<double>(hits) / static_cast<double>(hits + misses);
+}
+
+GmpPoolStats gmp_pool_stats() noexcept {
+    GmpPoolStats stats;
+    stats.thread_hits = thread_hits;
+    stats.reclaim_hits = reclaim_hits;
+    stats.misses = misses;
+    stats.unpooled = unpooled;
+
+    return stats;
+}
+
+}  // namespace KiCAS2
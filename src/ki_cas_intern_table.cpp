@@ -0,0 +1,258 @@
+#include "ki_cas_intern_table.h"
+
+#include <cassert>
+#include <memory>
+
+namespace KiCAS2 {
+
+/// Open addressing with linear probing. Slots only go from empty to a node, and from a node to the tombstone,
+/// so a lookup racing an insert at worst misses the new node, and then finds it when retrying under the lock.
+struct InternTable::Slots {
+    size_t mask;
+    std::unique_ptr<std::atomic<InternNode*>[]> slot;
+
+    explicit Slots(size_t capacity) : mask(capacity - 1), slot(new std::atomic<InternNode*>[capacity]) {
+        for(size_t i = 0; i < capacity; i++) slot[i].store(nullptr, std::memory_order_relaxed);
+    }
+
+    size_t capacity() const noexcept { return mask + 1; }
+};
+
+static constexpr size_t INITIAL_SLOTS_PER_SHARD = 16;
+
+/// Marks the slot of a reclaimed node, so that probing continues past it
+static InternNode tombstone = {};
+
+/// Heap memory owned by the fmpz, beyond its word
+static size_t limb_bytes(const fmpz* val) noexcept {
+    if(!COEFF_IS_MPZ(*val)) return 0;
+    return sizeof(__mpz_struct) + static_cast<size_t>(COEFF_TO_PTR(*val)->_mp_alloc) * sizeof(mp_limb_t);
+}
+
+static size_t limb_bytes(const fmpq* val) noexcept {
+    return limb_bytes(&val->num) + limb_bytes(&val->den);
+}
+
+/// Increment the reference count, unless the node has no references and may be reclaimed
+static bool try_acquire(InternNode* node) noexcept {
+    size_t refs = node->refs.load(std::memory_order_relaxed);
+    while(refs != 0)
+        if(node->refs.compare_exchange_weak(refs, refs + 1, std::memory_order_relaxed)) return true;
+    return false;
+}
+
+static void free_node(InternNode* node) noexcept {
+    fmpq_clear(&node->val);
+    delete node;
+}
+
+InternedNumber::InternedNumber(const InternedNumber& other) noexcept : node(other.node) {
+    if(node) node->refs.fetch_add(1, std::memory_order_relaxed);
+}
+
+InternedNumber::InternedNumber(InternedNumber&& other) noexcept : node(std::exchange(other.node, nullptr)) {}
+
+InternedNumber& InternedNumber::operator=(const InternedNumber& other) noexcept {
+    InternedNumber copy(other);
+    std::swap(node, copy.node);
+    return *this;
+}
+
+InternedNumber& InternedNumber::operator=(InternedNumber&& other) noexcept {
+    std::swap(node, other.node);
+    return *this;
+}
+
+InternedNumber::~InternedNumber() {
+    // The node is reclaimed by the table, which checks the count under the lock of the shard
+    if(node) node->refs.fetch_sub(1, std::memory_order_release);
+}
+
+InternTable::InternTable() {
+    for(Shard& shard : shards) shard.slots.store(new Slots(INITIAL_SLOTS_PER_SHARD), std::memory_order_relaxed);
+}
+
+InternTable::~InternTable() {
+    for(Shard& shard : shards){
+        Slots* slots = shard.slots.load(std::memory_order_relaxed);
+        for(size_t i = 0; i < slots->capacity(); i++){
+            InternNode* node = slots->slot[i].load(std::memory_order_relaxed);
+            if(node == nullptr || node == &tombstone) continue;
+            assert(node->refs.load(std::memory_order_relaxed) == 0);
+            free_node(node);
+        }
+        delete slots;
+
+        for(InternNode* node : shard.retired_nodes) free_node(node);
+        for(Slots* retired : shard.retired_slots) delete retired;
+    }
+}
+
+InternTable::Shard& InternTable::shardFor(size_t hash) noexcept {
+    // The low bits select the slot within the shard
+    return shards[(hash >> 4*sizeof(size_t)) % INTERN_TABLE_SHARDS];
+}
+
+InternedNumber InternTable::find(const fmpq* val, size_t hash) noexcept {
+    Shard& shard = shardFor(hash);
+
+    // Sequentially consistent, so that a reclaimer seeing no active readers has published every unlink to later readers
+    shard.active_readers.fetch_add(1);
+    const Slots* slots = shard.slots.load();
+    InternNode* found = nullptr;
+    for(size_t i = hash & slots->mask;; i = (i + 1) & slots->mask){
+        InternNode* node = slots->slot[i].load();
+        if(node == nullptr) break;
+        if(node == &tombstone || node->hash != hash || !fmpq_equal(&node->val, val)) continue;
+        if(try_acquire(node)) found = node;
+        break;
+    }
+    shard.active_readers.fetch_sub(1, std::memory_order_release);
+
+    return InternedNumber(found);
+}
+
+InternedNumber InternTable::insert(fmpq* val, size_t hash, bool take_storage) {
+    Shard& shard = shardFor(hash);
+    std::lock_guard lock(shard.mutex);
+
+    Slots* slots = shard.slots.load(std::memory_order_relaxed);
+    size_t i = hash & slots->mask;
+    for(;; i = (i + 1) & slots->mask){
+        InternNode* node = slots->slot[i].load(std::memory_order_relaxed);
+        if(node == nullptr) break;
+        if(node == &tombstone || node->hash != hash || !fmpq_equal(&node->val, val)) continue;
+
+        // Reviving a node without references is safe under the lock, which reclaiming also holds
+        node->refs.fetch_add(1, std::memory_order_relaxed);
+        return InternedNumber(node);
+    }
+
+    if(2*(shard.occupied + 1) > slots->capacity()){
+        grow(shard);
+        slots = shard.slots.load(std::memory_order_relaxed);
+        for(i = hash & slots->mask; slots->slot[i].load(std::memory_order_relaxed) != nullptr; i = (i + 1) & slots->mask);
+    }
+
+    InternNode* node = new InternNode{{1}, hash, {0, 1}};
+    if(take_storage) std::swap(node->val, *val);
+    else fmpq_set(&node->val, val);
+
+    slots->slot[i].store(node, std::memory_order_release);
+    shard.occupied++;
+
+    return InternedNumber(node);
+}
+
+void InternTable::sweep(Shard& shard) {
+    Slots* slots = shard.slots.load(std::memory_order_relaxed);
+    for(size_t i = 0; i < slots->capacity(); i++){
+        InternNode* node = slots->slot[i].load(std::memory_order_relaxed);
+        if(node == nullptr || node == &tombstone || node->refs.load(std::memory_order_acquire) != 0) continue;
+        slots->slot[i].store(&tombstone);
+        shard.retired_nodes.push_back(node);
+    }
+}
+
+void InternTable::grow(Shard& shard) {
+    sweep(shard);
+
+    Slots* slots = shard.slots.load(std::memory_order_relaxed);
+    size_t live = 0;
+    for(size_t i = 0; i < slots->capacity(); i++){
+        InternNode* node = slots->slot[i].load(std::memory_order_relaxed);
+        live += (node != nullptr && node != &tombstone);
+    }
+
+    // Rebuild at the same capacity if reclaiming made enough room, which also clears the tombstones
+    const size_t capacity = 4*(live + 1) > slots->capacity() ? 2*slots->capacity() : slots->capacity();
+    Slots* rebuilt = new Slots(capacity);
+    for(size_t i = 0; i < slots->capacity(); i++){
+        InternNode* node = slots->slot[i].load(std::memory_order_relaxed);
+        if(node == nullptr || node == &tombstone) continue;
+        size_t j = node->hash & rebuilt->mask;
+        while(rebuilt->slot[j].load(std::memory_order_relaxed) != nullptr) j = (j + 1) & rebuilt->mask;
+        rebuilt->slot[j].store(node, std::memory_order_relaxed);
+    }
+
+    shard.slots.store(rebuilt);
+    shard.retired_slots.push_back(slots);
+    shard.occupied = live;
+
+    freeRetiredIfQuiescent(shard);
+}
+
+void InternTable::freeRetiredIfQuiescent(Shard& shard) {
+    if(shard.active_readers.load() != 0) return;
+
+    for(InternNode* node : shard.retired_nodes) free_node(node);
+    shard.retired_nodes.clear();
+    for(Slots* slots : shard.retired_slots) delete slots;
+    shard.retired_slots.clear();
+}
+
+InternedNumber InternTable::intern(const fmpq* val) {
+    assert(fmpq_is_canonical(val));
+    const size_t hash = numeric_hash(val);
+    if(InternedNumber found = find(val, hash)) return found;
+    return insert(const_cast<fmpq*>(val), hash, false);
+}
+
+InternedNumber InternTable::intern(const fmpz* val) {
+    // A shallow fmpq, which is only read unless the value is inserted, when it is deep copied
+    const fmpq as_rational = {*val, 1};
+    return intern(&as_rational);
+}
+
+InternedNumber InternTable::intern(NativeRational val) {
+    val.reduceInPlace();
+    Rat rat = Rat::adopt({0, 1});
+    fmpz_set_ui(&rat.get()->num, val.num);
+    fmpz_set_ui(&rat.get()->den, val.den);
+    return intern(std::move(rat));
+}
+
+InternedNumber InternTable::intern(Int&& val) {
+    Rat rat = Rat::adopt({val.release(), 1});
+    return intern(std::move(rat));
+}
+
+InternedNumber InternTable::intern(Rat&& val) {
+    assert(fmpq_is_canonical(val.get()));
+    const size_t hash = numeric_hash(val.get());
+    if(InternedNumber found = find(val.get(), hash)) return found;
+    return insert(val.get(), hash, true);
+}
+
+void InternTable::collect() {
+    for(Shard& shard : shards){
+        std::lock_guard lock(shard.mutex);
+        sweep(shard);
+        freeRetiredIfQuiescent(shard);
+    }
+}
+
+InternStats InternTable::stats() const {
+    InternStats stats;
+
+    for(const Shard& shard : shards){
+        std::lock_guard lock(shard.mutex);
+        const Slots* slots = shard.slots.load(std::memory_order_relaxed);
+        stats.bytes += sizeof(Slots) + slots->capacity()*sizeof(std::atomic<InternNode*>);
+        for(size_t i = 0; i < slots->capacity(); i++){
+            const InternNode* node = slots->slot[i].load(std::memory_order_relaxed);
+            if(node == nullptr || node == &tombstone) continue;
+            const size_t refs = node->refs.load(std::memory_order_relaxed);
+            const size_t bytes = limb_bytes(&node->val);
+            stats.bytes += sizeof(InternNode) + bytes;
+            if(refs == 0) continue;
+            stats.values++;
+            stats.references += refs;
+            stats.bytes_saved += (refs - 1) * bytes;
+        }
+    }
+
+    return stats;
+}
+
+}  // namespace KiCAS2
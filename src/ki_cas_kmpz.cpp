@@ -4,7 +4,7 @@
 
 namespace KiCAS2 {
 
-static const char* to_chars(char* begin, char* end, uint128_t x) noexcept {
+static char* to_chars(char* begin, char* end, uint128_t x) noexcept {
     static auto printFilled = [](char*& begin, char* end, uint64_t val) noexcept {
         const auto result = std::to_chars(begin, end, val);
         assert(result.ec == std::errc());
@@ -62,7 +62,7 @@ void mpz_init_set_x(mpz_t lhs, uintx_t rhs) {
     *reinterpret_cast<uintx_t*>(lhs->_mp_d) = rhs;
 
     if(uintx_t::num_bits == 128 && sizeof(mp_limb_t) == sizeof(uint64_t)){
-        const int size = num_limbs - (rhs <= std::numeric_limits<uint64_t>::max());
+        const int size = num_limbs - (rhs[1] == 0) - (rhs == 0);
         lhs->_mp_size = is_negative ? (-size) : size;
     }else{
         if(sizeof(uint64_t) == sizeof(mp_limb_t)){
@@ -71,7 +71,7 @@ void mpz_init_set_x(mpz_t lhs, uintx_t rhs) {
             const auto bytes = intx::count_significant_bytes(rhs);
             lhs->_mp_size = (bytes + (sizeof(mp_limb_t)-1)) / sizeof(mp_limb_t);
         }
-        if(is_negative) lhs->_mp_size += 1;
+        if(is_negative) lhs->_mp_size = -lhs->_mp_size;
     }
 }
 
@@ -93,49 +93,192 @@ template<bool is_negative> inline void mpz_init_set_uint512(mpz_t lhs, uint512_t
 template void mpz_init_set_uint512<false>(mpz_t lhs, uint512_t rhs);
 template void mpz_init_set_uint512<true>(mpz_t lhs, uint512_t rhs);
 
-template<bool is_negative> fmpz u128_to_fmpz(uint128_t val) {
+template<unsigned N, bool is_negative> fmpz uintN_to_fmpz(const intx::uint<N>& val) {
+    const unsigned num_words = intx::count_significant_words(val);
+    if(num_words <= 1 && val[0] <= static_cast<uint64_t>(COEFF_MAX)){
+        const slong small = static_cast<slong>(val[0]);
+        return is_negative ? -small : small;
+    }
+
+    constexpr unsigned limbs_per_word = sizeof(uint64_t) / sizeof(mp_limb_t);
+    const mp_size_t num_limbs = static_cast<mp_size_t>(num_words * limbs_per_word);
     fmpz out = 0;
-    if(sizeof(mp_limb_t) == sizeof(uint64_t)){
-        if(is_negative) fmpz_neg_uiui(&out, val[1], val[0]);
-        else fmpz_set_uiui(&out, val[1], val[0]);
+    const mpz_ptr z = _fmpz_promote(&out);
+    mp_limb_t* const limbs = mpz_limbs_write(z, num_limbs);
+    if constexpr(limbs_per_word == 1){
+        for(unsigned i = 0; i < num_words; i++) limbs[i] = val[i];
     }else{
-        fmpz_set_ui_array(
-            &out,
-            reinterpret_cast<const mp_limb_t*>(&val[0]),
-            16/sizeof(mp_limb_t));
-        if(is_negative) COEFF_TO_PTR(out)->_mp_size *= -1;
+        for(unsigned i = 0; i < num_words; i++){
+            limbs[2*i] = static_cast<mp_limb_t>(val[i]);
+            limbs[2*i+1] = static_cast<mp_limb_t>(val[i] >> 32);
+        }
     }
+    mpz_limbs_finish(z, is_negative ? -num_limbs : num_limbs);
+
     return out;
 }
+template fmpz uintN_to_fmpz<128, false>(const uint128_t& val);
+template fmpz uintN_to_fmpz<128, true>(const uint128_t& val);
+template fmpz uintN_to_fmpz<256, false>(const uint256_t& val);
+template fmpz uintN_to_fmpz<256, true>(const uint256_t& val);
+template fmpz uintN_to_fmpz<512, false>(const uint512_t& val);
+template fmpz uintN_to_fmpz<512, true>(const uint512_t& val);
+
+template<bool is_negative> fmpz u128_to_fmpz(uint128_t val) {
+    return uintN_to_fmpz<128, is_negative>(val);
+}
 template fmpz u128_to_fmpz<false>(uint128_t val);
 template fmpz u128_to_fmpz<true>(uint128_t val);
 
 template<bool is_negative> fmpz u256_to_fmpz(uint256_t val) {
-    fmpz out = 0;
-    fmpz_set_ui_array(
-        &out,
-        reinterpret_cast<const mp_limb_t*>(&val[0]),
-        32/sizeof(mp_limb_t));
-    if(is_negative) COEFF_TO_PTR(out)->_mp_size *= -1;
-    return out;
+    return uintN_to_fmpz<256, is_negative>(val);
 }
 template fmpz u256_to_fmpz<false>(uint256_t val);
 template fmpz u256_to_fmpz<true>(uint256_t val);
 
+template<bool is_negative> fmpz u512_to_fmpz(const uint512_t& val) {
+    return uintN_to_fmpz<512, is_negative>(val);
+}
+template fmpz u512_to_fmpz<false>(const uint512_t& val);
+template fmpz u512_to_fmpz<true>(const uint512_t& val);
+
+template<bool is_negative> Int u128_to_int(uint128_t val) {
+    return Int::adopt(u128_to_fmpz<is_negative>(val));
+}
+template Int u128_to_int<false>(uint128_t val);
+template Int u128_to_int<true>(uint128_t val);
+
+template<bool is_negative> Int u256_to_int(uint256_t val) {
+    return Int::adopt(u256_to_fmpz<is_negative>(val));
+}
+template Int u256_to_int<false>(uint256_t val);
+template Int u256_to_int<true>(uint256_t val);
+
+template<bool is_negative> Int u512_to_int(const uint512_t& val) {
+    return Int::adopt(u512_to_fmpz<is_negative>(val));
+}
+template Int u512_to_int<false>(const uint512_t& val);
+template Int u512_to_int<true>(const uint512_t& val);
+
 template<typename uintx_t>
-static void write_uintx(std::string& str, uintx_t val) {
-    str += intx::to_string(val);
+static bool mpz_get_x(uintx_t* result, bool* is_negative, mpz_srcptr val) noexcept {
+    const size_t num_limbs = mpz_size(val);
+    if(num_limbs > sizeof(uintx_t)/sizeof(mp_limb_t)) return true;
+
+    const mp_limb_t* const limbs = mpz_limbs_read(val);
+    *result = 0;
+    if constexpr(sizeof(mp_limb_t) == sizeof(uint64_t)){
+        for(size_t i = 0; i < num_limbs; i++) (*result)[i] = limbs[i];
+    }else{
+        // Two 32-bit limbs form each 64-bit word, least significant first
+        for(size_t i = 0; i < num_limbs; i++) (*result)[i/2] |= static_cast<uint64_t>(limbs[i]) << (32*(i%2));
+    }
+    *is_negative = mpz_sgn(val) < 0;
+
+    return false;
 }
 
-void write_uint128(std::string& str, uint128_t val) {
+template<typename uintx_t>
+static bool fmpz_get_x(uintx_t* result, bool* is_negative, const fmpz_t val) noexcept {
+    if(COEFF_IS_MPZ(*val)) return mpz_get_x(result, is_negative, COEFF_TO_PTR(*val));
+
+    *result = *val < 0 ? -static_cast<ulong>(*val) : static_cast<ulong>(*val);
+    *is_negative = *val < 0;
+    return false;
+}
+
+bool mpz_get_uint128(uint128_t* result, bool* is_negative, mpz_srcptr val) noexcept {
+    return mpz_get_x(result, is_negative, val);
+}
+
+bool mpz_get_uint256(uint256_t* result, bool* is_negative, mpz_srcptr val) noexcept {
+    return mpz_get_x(result, is_negative, val);
+}
+
+bool mpz_get_uint512(uint512_t* result, bool* is_negative, mpz_srcptr val) noexcept {
+    return mpz_get_x(result, is_negative, val);
+}
+
+bool fmpz_get_uint128(uint128_t* result, bool* is_negative, const fmpz_t val) noexcept {
+    return fmpz_get_x(result, is_negative, val);
+}
+
+bool fmpz_get_uint256(uint256_t* result, bool* is_negative, const fmpz_t val) noexcept {
+    return fmpz_get_x(result, is_negative, val);
+}
+
+bool fmpz_get_uint512(uint512_t* result, bool* is_negative, const fmpz_t val) noexcept {
+    return fmpz_get_x(result, is_negative, val);
+}
+
+/// The largest power of ten which fits in a word, so that a chunk of digits converts without overflow
+static constexpr size_t CHUNK_DIGITS = std::numeric_limits<uint64_t>::digits10;
+static constexpr uint64_t CHUNK_BASE = 10000000000000000000u;
+static_assert(CHUNK_DIGITS == 19);
+
+static uint64_t knownfit_str2chunk(const char* begin, const char* end) noexcept {
+    uint64_t ans = 0;
+    for(; begin != end; begin++) ans = ans * 10 + static_cast<uint64_t>(*begin - '0');
+    return ans;
+}
+
+template<typename uintx_t>
+static uintx_t knownfit_str2x(std::string_view str) noexcept {
+    assert(!str.empty());
+    assert(str.size() <= static_cast<size_t>(std::numeric_limits<uintx_t>::digits10));
+    #ifndef NDEBUG
+    for(const char ch : str) assert(ch >= '0' && ch <= '9');
+    #endif
+
+    // The leading chunk takes the remainder, so that every following chunk has exactly CHUNK_DIGITS digits
+    const char* iter = str.data();
+    const char* const end = iter + str.size();
+    const char* chunk_end = iter + (str.size() - 1) % CHUNK_DIGITS + 1;
+    uintx_t ans = knownfit_str2chunk(iter, chunk_end);
+
+    // Each chunk grows the value by less than a word, so only the words reached so far are multiplied
+    unsigned num_words = 1;
+    for(iter = chunk_end; iter != end; iter += CHUNK_DIGITS){
+        uint64_t carry = knownfit_str2chunk(iter, iter + CHUNK_DIGITS);
+        for(unsigned i = 0; i < num_words; i++){
+            const uint128_t t = intx::umul(ans[i], CHUNK_BASE) + carry;
+            ans[i] = t[0];
+            carry = t[1];
+        }
+        if(num_words < uintx_t::num_words) ans[num_words++] = carry;
+        else assert(carry == 0);
+    }
+
+    return ans;
+}
+
+uint128_t knownfit_str2uint128(std::string_view str) noexcept {
+    return knownfit_str2x<uint128_t>(str);
+}
+
+uint256_t knownfit_str2uint256(std::string_view str) noexcept {
+    return knownfit_str2x<uint256_t>(str);
+}
+
+void write_uint128(SinkRef sink, uint128_t val) {
     constexpr size_t max_digits = std::numeric_limits<uint128_t>::digits10 + 1;
-    char buffer[max_digits];
-    const char* end = to_chars(buffer, buffer + max_digits, val);
-    str.append(buffer, end - buffer);
+    char* const dest = sink.prepare(max_digits);
+    if(dest == nullptr) return;
+    sink.commit(to_chars(dest, dest + max_digits, val));
+}
+
+void write_uint256(SinkRef sink, uint256_t val) {
+    sink_append(sink, intx::to_string(val));
+}
+
+void write_uint128(std::string& str, uint128_t val) {
+    StringSink sink(str);
+    write_uint128(sink, val);
 }
 
 void write_uint256(std::string& str, uint256_t val) {
-    write_uintx(str, val);
+    StringSink sink(str);
+    write_uint256(sink, val);
 }
 
 }  // namespace KiCAS2
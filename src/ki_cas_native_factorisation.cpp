@@ -0,0 +1,414 @@
+#include "ki_cas_native_factorisation.h"
+
+#include "arch_macros.h"
+#include "ki_cas_native_integer.h"
+#include <algorithm>
+#include <array>
+#include <bit>
+#include <cassert>
+#include <limits>
+#include <mutex>
+#include <numeric>
+
+#if defined(_MSC_VER) && defined(_WIN64)
+#include <intrin.h>
+#endif
+
+namespace KiCAS2 {
+
+static constexpr size_t WORD_BITS = std::numeric_limits<size_t>::digits;
+
+/// Smallest prime factors are sieved below this bound, at a cost of 2 bytes per odd number
+static constexpr size_t SIEVE_LIMIT = size_t(1) << 18;
+
+/// Larger words are trial divided by the odd primes below this bound before any other method
+static constexpr size_t TRIAL_LIMIT = 1024;
+
+/// The smallest prime factor of each odd number below the sieve limit, or 0 for primes.
+/// Composites below the limit have a factor below 2^9, so the factors fit in 16 bits.
+struct OddSieve {
+    uint16_t smallest_factor[SIEVE_LIMIT / 2] = {};
+
+    OddSieve() noexcept {
+        for(size_t p = 3; p*p < SIEVE_LIMIT; p += 2){
+            if(smallest_factor[p / 2] != 0) continue;
+            for(size_t multiple = p*p; multiple < SIEVE_LIMIT; multiple += 2*p)
+                if(smallest_factor[multiple / 2] == 0) smallest_factor[multiple / 2] = static_cast<uint16_t>(p);
+        }
+    }
+};
+
+/// The sieve is built on first use, rather than at load or compile time
+static const OddSieve& odd_sieve() noexcept {
+    static const OddSieve sieve;
+    return sieve;
+}
+
+/// The inverse of an odd word modulo 2^WORD_BITS, by Newton iteration, which doubles the correct bits each step
+static constexpr size_t inverse_mod_word(size_t n) noexcept {
+    assert(n % 2 == 1);
+    size_t inverse = n;  // Correct to 3 bits, since n*n = 1 (mod 8) for odd n
+    for(size_t i = 0; i < 5; i++) inverse *= 2 - n*inverse;
+    return inverse;
+}
+
+static constexpr bool is_small_prime(size_t n) noexcept {
+    if(n < 2) return false;
+    for(size_t d = 2; d*d <= n; d++)
+        if(n % d == 0) return false;
+    return true;
+}
+
+/// An odd prime with its inverse, so that divisibility is tested by a multiplication rather than a division:
+/// n is a multiple of p exactly when n * p^-1 (mod 2^WORD_BITS) is at most the largest quotient.
+struct TrialPrime {
+    size_t p;
+    size_t inverse;
+    size_t max_quotient;
+};
+
+static constexpr size_t NUM_TRIAL_PRIMES = [](){
+    size_t num_primes = 0;
+    for(size_t n = 3; n < TRIAL_LIMIT; n += 2) num_primes += is_small_prime(n);
+    return num_primes;
+}();
+
+static constexpr auto TRIAL_PRIMES = [](){
+    std::array<TrialPrime, NUM_TRIAL_PRIMES> primes = {};
+    size_t i = 0;
+    for(size_t n = 3; n < TRIAL_LIMIT; n += 2)
+        if(is_small_prime(n)) primes[i++] = {n, inverse_mod_word(n), std::numeric_limits<size_t>::max() / n};
+    return primes;
+}();
+
+static_assert(TRIAL_PRIMES.front().p * TRIAL_PRIMES.front().inverse == 1);
+
+struct WordProduct {
+    size_t high;
+    size_t low;
+};
+
+static WordProduct mul_wide(size_t a, size_t b) noexcept {
+    #if defined(_MSC_VER) && defined(_WIN64)
+    return {__umulh(a, b), a * b};
+    #else
+    const WideType product = static_cast<WideType>(a) * b;
+    return {static_cast<size_t>(product >> WORD_BITS), static_cast<size_t>(product)};
+    #endif
+}
+
+/// Arithmetic modulo an odd word in Montgomery form, where x is represented by x*2^WORD_BITS (mod n).
+/// Reduction needs only the high half of products, so there is no double-word division.
+class Montgomery {
+public:
+    explicit Montgomery(size_t n) noexcept : n(n), n_inverse(inverse_mod_word(n)), one((0 - n) % n) {
+        r_squared = one;
+        for(size_t i = 0; i < WORD_BITS; i++) r_squared = add(r_squared, r_squared);
+    }
+
+    size_t unity() const noexcept { return one; }
+
+    size_t add(size_t a, size_t b) const noexcept {
+        const size_t sum = a + b;
+        return (sum < a || sum >= n) ? sum - n : sum;
+    }
+
+    /// Since the low words of a*b and m*n agree, (a*b - m*n) / 2^WORD_BITS is the difference of the high words
+    size_t mul(size_t a, size_t b) const noexcept {
+        const WordProduct product = mul_wide(a, b);
+        const size_t m = product.low * n_inverse;
+        const size_t m_times_n_high = mul_wide(m, n).high;
+        return product.high >= m_times_n_high ? product.high - m_times_n_high : product.high - m_times_n_high + n;
+    }
+
+    size_t to_form(size_t a) const noexcept {
+        return mul(a % n, r_squared);
+    }
+
+    size_t pow(size_t base, size_t power) const noexcept {
+        size_t result = one;
+        for(;;){
+            if(power & 1) result = mul(result, base);
+            power >>= 1;
+            if(power == 0) return result;
+            base = mul(base, base);
+        }
+    }
+
+private:
+    size_t n;
+    size_t n_inverse;
+    size_t one;
+    size_t r_squared;
+};
+
+/// Bases for which a strong probable prime test is deterministic over every word
+#if defined(Word32)
+static constexpr size_t MILLER_RABIN_BASES[] = {2, 7, 61};
+#else
+static constexpr size_t MILLER_RABIN_BASES[] = {2, 325, 9375, 28178, 450775, 9780504, 1795265022};
+#endif
+
+/// Deterministic Miller-Rabin for an odd word
+static bool is_odd_prime(size_t n) noexcept {
+    const Montgomery mont(n);
+    const size_t minus_one = n - mont.unity();
+    const size_t num_twos = static_cast<size_t>(std::countr_zero(n - 1));
+    const size_t odd_part = (n - 1) >> num_twos;
+
+    for(const size_t base : MILLER_RABIN_BASES){
+        if(base % n == 0) continue;
+        size_t x = mont.pow(mont.to_form(base), odd_part);
+        if(x == mont.unity() || x == minus_one) continue;
+
+        bool is_witness = true;
+        for(size_t i = 1; i < num_twos && is_witness; i++){
+            x = mont.mul(x, x);
+            if(x == minus_one) is_witness = false;
+            else if(x == mont.unity()) break;
+        }
+        if(is_witness) return false;
+    }
+
+    return true;
+}
+
+bool is_prime(size_t n) noexcept {
+    if(n < SIEVE_LIMIT) return n == 2 || (n % 2 == 1 && n > 1 && odd_sieve().smallest_factor[n / 2] == 0);
+    if(n % 2 == 0) return false;
+
+    for(const TrialPrime& prime : TRIAL_PRIMES)
+        if(n * prime.inverse <= prime.max_quotient) return false;
+    if(n < TRIAL_LIMIT * TRIAL_LIMIT) return true;
+
+    return is_odd_prime(n);
+}
+
+static size_t abs_diff(size_t a, size_t b) noexcept {
+    return a > b ? a - b : b - a;
+}
+
+/// A nontrivial factor of an odd composite which is not a perfect power, by Brent's variant of Pollard's rho.
+/// Differences are accumulated in a product so that a gcd is only taken every BATCH steps.
+static size_t pollard_brent(size_t n) noexcept {
+    constexpr size_t BATCH = 128;
+    const Montgomery mont(n);
+
+    for(size_t c = 1;; c++){
+        const auto step = [&mont, c](size_t y){ return mont.add(mont.mul(y, y), c); };
+        size_t y = 2;
+        size_t x = y;
+        size_t saved_y = y;
+        size_t product = mont.unity();
+        size_t factor = 1;
+
+        for(size_t cycle_length = 1; factor == 1; cycle_length *= 2){
+            x = y;
+            for(size_t i = 0; i < cycle_length; i++) y = step(y);
+            for(size_t k = 0; k < cycle_length && factor == 1; k += BATCH){
+                saved_y = y;
+                for(size_t i = 0; i < std::min(BATCH, cycle_length - k); i++){
+                    y = step(y);
+                    product = mont.mul(product, abs_diff(x, y));
+                }
+                factor = std::gcd(product, n);
+            }
+        }
+
+        // The batch overshot to a multiple of n, so retrace it a step at a time
+        if(factor == n){
+            do{
+                saved_y = step(saved_y);
+                factor = std::gcd(abs_diff(x, saved_y), n);
+            }while(factor == 1);
+        }
+
+        if(factor != n) return factor;
+    }
+}
+
+static void add_factor(NativeFactorisation* result, size_t p, size_t exponent) noexcept {
+    for(size_t i = 0; i < result->num_factors; i++){
+        if(result->primes[i] == p){
+            result->exponents[i] += static_cast<uint8_t>(exponent);
+            return;
+        }
+    }
+
+    assert(result->num_factors < NativeFactorisation::MAX_FACTORS);
+    result->primes[result->num_factors] = p;
+    result->exponents[result->num_factors] = static_cast<uint8_t>(exponent);
+    result->num_factors++;
+}
+
+/// Factorise a word below the sieve limit by repeatedly dividing out its smallest prime factor
+static void factorise_small(NativeFactorisation* result, size_t n) noexcept {
+    result->num_factors = 0;
+    if(n == 1) return;
+
+    const size_t num_twos = static_cast<size_t>(std::countr_zero(n));
+    if(num_twos != 0) add_factor(result, 2, num_twos);
+    n >>= num_twos;
+
+    const OddSieve& sieve = odd_sieve();
+    while(n != 1){
+        const size_t p = sieve.smallest_factor[n / 2] == 0 ? n : sieve.smallest_factor[n / 2];
+        size_t exponent = 0;
+        do{
+            n /= p;
+            exponent++;
+        }while(n % p == 0);
+        add_factor(result, p, exponent);
+    }
+}
+
+/// Factorise a word with no prime factors below the trial division limit, counting each factor multiplicity times
+static void factorise_without_small_factors(NativeFactorisation* result, size_t n, size_t multiplicity) noexcept {
+    if(n < TRIAL_LIMIT * TRIAL_LIMIT || is_odd_prime(n)){
+        add_factor(result, n, multiplicity);
+        return;
+    }
+
+    // Rho splits perfect powers slowly, if at all, so their roots are factored instead
+    size_t root;
+    if(const size_t exponent = is_perfect_power(&root, n)){
+        factorise_without_small_factors(result, root, multiplicity * exponent);
+        return;
+    }
+
+    const size_t factor = pollard_brent(n);
+    factorise_without_small_factors(result, factor, multiplicity);
+    factorise_without_small_factors(result, n / factor, multiplicity);
+}
+
+static void factorise_large(NativeFactorisation* result, size_t n) noexcept {
+    result->num_factors = 0;
+
+    const size_t num_twos = static_cast<size_t>(std::countr_zero(n));
+    if(num_twos != 0) add_factor(result, 2, num_twos);
+    n >>= num_twos;
+
+    for(const TrialPrime& prime : TRIAL_PRIMES){
+        if(prime.p * prime.p > n) break;
+        size_t exponent = 0;
+        for(size_t quotient = n * prime.inverse; quotient <= prime.max_quotient; quotient = n * prime.inverse){
+            n = quotient;
+            exponent++;
+        }
+        if(exponent != 0) add_factor(result, prime.p, exponent);
+    }
+
+    if(n != 1) factorise_without_small_factors(result, n, 1);
+
+    // Rho finds factors in no particular order
+    for(size_t i = 1; i < result->num_factors; i++){
+        const size_t p = result->primes[i];
+        const uint8_t exponent = result->exponents[i];
+        size_t j = i;
+        for(; j > 0 && result->primes[j - 1] > p; j--){
+            result->primes[j] = result->primes[j - 1];
+            result->exponents[j] = result->exponents[j - 1];
+        }
+        result->primes[j] = p;
+        result->exponents[j] = exponent;
+    }
+}
+
+static constexpr size_t FACTOR_CACHE_SHARDS = 16;
+static constexpr size_t FACTOR_CACHE_SLOTS_PER_SHARD = 256;
+
+/// A direct-mapped cache of recent factorisations. A new factorisation replaces whichever shared its slot.
+struct FactorCacheShard {
+    std::mutex mutex;
+    size_t keys[FACTOR_CACHE_SLOTS_PER_SHARD] = {};  ///< 0 marks an empty slot, since zero is never factorised
+    NativeFactorisation factorisations[FACTOR_CACHE_SLOTS_PER_SHARD];
+    size_t hits = 0;
+    size_t misses = 0;
+};
+
+static FactorCacheShard factor_cache[FACTOR_CACHE_SHARDS];
+
+/// Fibonacci hashing, whose upper bits select the shard and then the slot
+static size_t factor_cache_hash(size_t n) noexcept {
+    return n * static_cast<size_t>(0x9E3779B97F4A7C15ull);
+}
+
+static FactorCacheShard& factor_cache_shard(size_t hash) noexcept {
+    return factor_cache[hash >> (WORD_BITS - std::bit_width(FACTOR_CACHE_SHARDS - 1))];
+}
+
+static size_t factor_cache_slot(size_t hash) noexcept {
+    return (hash >> (WORD_BITS - std::bit_width(FACTOR_CACHE_SHARDS - 1) - std::bit_width(FACTOR_CACHE_SLOTS_PER_SHARD - 1)))
+        % FACTOR_CACHE_SLOTS_PER_SHARD;
+}
+
+void factorise(NativeFactorisation* result, size_t n) noexcept {
+    assert(n != 0);
+    if(n < SIEVE_LIMIT){
+        factorise_small(result, n);
+        return;
+    }
+
+    const size_t hash = factor_cache_hash(n);
+    FactorCacheShard& shard = factor_cache_shard(hash);
+    const size_t slot = factor_cache_slot(hash);
+    {
+        std::lock_guard lock(shard.mutex);
+        if(shard.keys[slot] == n){
+            shard.hits++;
+            *result = shard.factorisations[slot];
+            return;
+        }
+        shard.misses++;
+    }
+
+    // The lock is not held while factorising, so threads which miss on the same word may both factorise it
+    factorise_large(result, n);
+
+    std::lock_guard lock(shard.mutex);
+    shard.keys[slot] = n;
+    shard.factorisations[slot] = *result;
+}
+
+size_t power_free_part(size_t n, size_t power, size_t* k) noexcept {
+    assert(power != 0);
+    *k = 1;
+    if(n == 0) return 0;
+
+    NativeFactorisation factors;
+    factorise(&factors, n);
+
+    size_t free_part = 1;
+    for(size_t i = 0; i < factors.num_factors; i++){
+        *k *= knownfit_pow(factors.primes[i], factors.exponents[i] / power);
+        free_part *= knownfit_pow(factors.primes[i], factors.exponents[i] % power);
+    }
+
+    return free_part;
+}
+
+size_t square_free_part(size_t n, size_t* k) noexcept {
+    return power_free_part(n, 2, k);
+}
+
+NativeFactorCacheStats native_factor_cache_stats() noexcept {
+    NativeFactorCacheStats stats;
+    for(FactorCacheShard& shard : factor_cache){
+        std::lock_guard lock(shard.mutex);
+        stats.hits += shard.hits;
+        stats.misses += shard.misses;
+    }
+
+    return stats;
+}
+
+void clear_native_factor_cache() noexcept {
+    for(FactorCacheShard& shard : factor_cache){
+        std::lock_guard lock(shard.mutex);
+        for(size_t& key : shard.keys) key = 0;
+        shard.hits = 0;
+        shard.misses = 0;
+    }
+}
+
+}  // namespace KiCAS2
@@ -1,71 +1,584 @@
 #include "ki_cas_native_float.h"
 
+#ifdef _MSC_VER
+#include <malloc.h>  // MSC dependencies for GMP
+#endif
+
+#include <gmp.h>
+#include <intx/intx.hpp>
+
+#include "ki_cas_powers_of_five.h"
 #include <cassert>
 #include <charconv>
+#include <algorithm>
+#include <bit>
+#include <cfloat>
+#include <cmath>
+#include <cstdlib>
+#include <cstring>
 #include <limits>
 
 namespace KiCAS2 {
 
-static size_t precision = 6;
+static thread_local FloatFormat thread_format;
+
+void set_float_format(FloatFormat format) noexcept {
+    thread_format = format;
+}
+
+FloatFormat get_float_format() noexcept {
+    return thread_format;
+}
 
 void set_float_string_precision(size_t precision_val) noexcept {
-    precision = precision_val;
+    thread_format.precision = precision_val;
 }
 
 size_t get_float_string_precision() noexcept {
-    return precision;
+    return thread_format.precision;
 }
 
-void write_float(std::string& str, FloatingPoint val) {
 #if !defined(__GNUC__) || __GNUC__ > 8
-    constexpr size_t max_digits = std::numeric_limits<FloatingPoint>::max_digits10 + 8;
-    char buffer[max_digits];
-    const std::to_chars_result result = std::to_chars(buffer, buffer+max_digits, val, std::chars_format::general, precision);
+// Sign, decimal point, 'e', exponent sign, and up to 4 exponent digits
+static constexpr size_t NOTATION_CHARS = 8;
+
+static constexpr size_t SHORTEST_FAST_PATH_MAX_DECIMALS = 6;
+
+static size_t count_digits(uint64_t val) noexcept {
+    size_t digits = 1;
+    while((val /= 10) != 0) digits++;
+    return digits;
+}
+
+/// Write ±m·10⁻ᵏ in whichever of fixed or scientific notation is shorter, preferring fixed on a tie.
+/// Returns nullptr if scientific notation is shorter for a non-integer, which is left to the general algorithm.
+static char* write_decimal(char* dest, bool is_negative, uint64_t m, size_t k) noexcept {
+    char digits[std::numeric_limits<uint64_t>::digits10 + 1];
+    const size_t num_digits = std::to_chars(digits, digits + sizeof(digits), m).ptr - digits;
+    static constexpr size_t PLUS_TWO_FOR_E_AND_SIGN = 2;
+
+    if(k == 0){
+        size_t num_significant = num_digits;
+        while(num_significant > 1 && digits[num_significant-1] == '0') num_significant--;
+        const size_t exponent = num_digits - 1;
+        const size_t scientific_size = num_significant + (num_significant > 1)
+                                       + PLUS_TWO_FOR_E_AND_SIGN + std::max<size_t>(2, count_digits(exponent));
+
+        if(is_negative) *dest++ = '-';
+        if(num_digits <= scientific_size){
+            std::memcpy(dest, digits, num_digits);
+            return dest + num_digits;
+        }
+
+        *dest++ = digits[0];
+        if(num_significant > 1){
+            *dest++ = '.';
+            std::memcpy(dest, digits+1, num_significant-1);
+            dest += num_significant-1;
+        }
+        *dest++ = 'e';
+        *dest++ = '+';
+        if(exponent < 10) *dest++ = '0';
+        return std::to_chars(dest, dest + 3, exponent).ptr;
+    }else if(num_digits > k){
+        if(is_negative) *dest++ = '-';
+        const size_t num_integer_digits = num_digits - k;
+        std::memcpy(dest, digits, num_integer_digits);
+        dest += num_integer_digits;
+        *dest++ = '.';
+        std::memcpy(dest, digits + num_integer_digits, k);
+        return dest + k;
+    }else{
+        const size_t fixed_size = 2 + k;  // "0." followed by k digits
+        const size_t scientific_size = num_digits + (num_digits > 1) + PLUS_TWO_FOR_E_AND_SIGN + 2;
+        if(scientific_size < fixed_size) return nullptr;
+
+        if(is_negative) *dest++ = '-';
+        *dest++ = '0';
+        *dest++ = '.';
+        std::memset(dest, '0', k - num_digits);
+        dest += k - num_digits;
+        std::memcpy(dest, digits, num_digits);
+        return dest + num_digits;
+    }
+}
+
+/// Write the shortest representation if val is an integer or has few decimal places, otherwise return nullptr.
+template<std::floating_point T> static char* write_shortest_fast_path(char* dest, T val) noexcept {
+    // Below 2^(digits-1) the spacing of T is finer than the spacing of the decimal grid 10⁻ᵏ,
+    // so only one point on the grid rounds to val, and that point has the fewest digits of any
+    // string which parses back to val.
+    constexpr int limit_bits = std::min(std::numeric_limits<T>::digits - 1, 63);
+    constexpr T limit = static_cast<T>(uint64_t(1) << limit_bits);
+    constexpr T powers_of_ten[SHORTEST_FAST_PATH_MAX_DECIMALS+1] = {1, 10, 100, 1000, 10000, 100000, 1000000};
+
+    if(!std::isfinite(val)) return nullptr;
+    const T magnitude = std::abs(val);
+
+    for(size_t k = 0; k <= SHORTEST_FAST_PATH_MAX_DECIMALS; k++){
+        const T scaled = magnitude * powers_of_ten[k];
+        if(!(scaled < limit)) return nullptr;
+
+        // The scaled value must be an integer which divides back to exactly the same value
+        if(scaled != std::trunc(scaled) || scaled / powers_of_ten[k] != magnitude) continue;
+
+        uint64_t m = static_cast<uint64_t>(scaled);
+        size_t decimals = k;
+        while(decimals > 0 && m % 10 == 0){
+            m /= 10;
+            decimals--;
+        }
+
+        return write_decimal(dest, std::signbit(val), m, decimals);
+    }
+
+    return nullptr;
+}
+
+/// The fast path output is bounded by max_digits10 + NOTATION_CHARS
+template<std::floating_point T> static std::to_chars_result to_chars_shortest(char* first, char* last, T val) noexcept {
+    assert(static_cast<size_t>(last - first) >= std::numeric_limits<T>::max_digits10 + NOTATION_CHARS);
+    char* const end = write_shortest_fast_path(first, val);
+    if(end != nullptr) return {end, std::errc()};
+    return std::to_chars(first, last, val);
+}
+
+static size_t max_float_chars(FloatingPoint val, FloatFormat format) noexcept {
+    switch(format.style){
+        case FloatStyle::Fixed: {
+            // The integer part grows with the binary exponent, ⌈exp2 * log₁₀(2)⌉
+            int exp2;
+            std::frexp(val, &exp2);
+            const size_t integer_digits = (exp2 > 0) ? static_cast<size_t>(exp2 * 0.30103) + 1 : 1;
+            return integer_digits + format.precision + NOTATION_CHARS;
+        }
+        case FloatStyle::General:
+        case FloatStyle::Scientific:
+            return format.precision + NOTATION_CHARS;
+        case FloatStyle::Shortest:
+            return std::numeric_limits<FloatingPoint>::max_digits10 + NOTATION_CHARS;
+    }
+
+    assert(false);
+    return 0;
+}
+
+static std::to_chars_result float_to_chars(char* first, char* last, FloatingPoint val, FloatFormat format) noexcept {
+    static_assert(MAX_FLOAT_PRECISION <= static_cast<size_t>(std::numeric_limits<int>::max()));
+    assert(format.precision <= MAX_FLOAT_PRECISION);
+    const int precision = static_cast<int>(format.precision);
+
+    switch(format.style){
+        case FloatStyle::General: return std::to_chars(first, last, val, std::chars_format::general, precision);
+        case FloatStyle::Fixed: return std::to_chars(first, last, val, std::chars_format::fixed, precision);
+        case FloatStyle::Scientific: return std::to_chars(first, last, val, std::chars_format::scientific, precision);
+        case FloatStyle::Shortest: return to_chars_shortest(first, last, val);
+    }
+
+    assert(false);
+    return {first, std::errc::invalid_argument};
+}
+#endif
+
+void write_float(SinkRef sink, FloatingPoint val, FloatFormat format) {
+#if !defined(__GNUC__) || __GNUC__ > 8
+    format.precision = std::min(format.precision, MAX_FLOAT_PRECISION);
+    size_t max_chars = max_float_chars(val, format);
+    for(;;){
+        char* const dest = sink.prepare(max_chars);
+        if(dest == nullptr) return;
+
+        const std::to_chars_result result = float_to_chars(dest, dest+max_chars, val, format);
+        if(result.ec == std::errc()){
+            sink.commit(result.ptr);
+            return;
+        }
+
+        // The estimate is not a strict bound for every format, so retry with more space
+        assert(result.ec == std::errc::value_too_large);
+        sink.commit(dest);
+        max_chars *= 2;
+    }
+#else
+    // Older GCC versions don't implement std::to_chars for floats
+    sink_append(sink, std::to_string(val));
+#endif
+}
+
+void write_float(SinkRef sink, FloatingPoint val) {
+    write_float(sink, val, thread_format);
+}
+
+template<std::floating_point T> void write_float_shortest(SinkRef sink, T val) {
+#if !defined(__GNUC__) || __GNUC__ > 8
+    constexpr size_t max_chars = std::numeric_limits<T>::max_digits10 + NOTATION_CHARS;
+    char* const dest = sink.prepare(max_chars);
+    if(dest == nullptr) return;
+    const std::to_chars_result result = to_chars_shortest(dest, dest+max_chars, val);
     assert(result.ec == std::errc());
-    str.append(buffer, result.ptr - buffer);
+    sink.commit(result.ptr);
 #else
     // Older GCC versions don't implement std::to_chars for floats
-    str += std::to_string(val);
+    sink_append(sink, std::to_string(val));
 #endif
 }
+template void write_float_shortest(SinkRef, float);
+template void write_float_shortest(SinkRef, double);
+template void write_float_shortest(SinkRef, long double);
 
-void write_float_term(std::string& str, FloatingPoint val){
+template<std::floating_point T> void write_float_shortest(std::string& str, T val) {
+    StringSink sink(str);
+    write_float_shortest(sink, val);
+}
+template void write_float_shortest(std::string&, float);
+template void write_float_shortest(std::string&, double);
+template void write_float_shortest(std::string&, long double);
+
+void write_float(std::string& str, FloatingPoint val, FloatFormat format) {
+    StringSink sink(str);
+    write_float(sink, val, format);
+}
+
+void write_float(std::string& str, FloatingPoint val) {
+    write_float(str, val, thread_format);
+}
+
+void write_float_term(std::string& str, FloatingPoint val, FloatFormat format){
     assert(str[str.size()-2] == '+');
     assert(str[str.size()-1] == ' ');
     if(val >= 0){
-        write_float(str, val);
+        write_float(str, val, format);
     }else{
         str[str.size()-2] = '-';
-        write_float(str, -val);
+        write_float(str, -val, format);
     }
 }
 
-FloatingPoint strdecimal2floatingpoint(std::string_view str) noexcept {
-    long double result;
+void write_float_term(std::string& str, FloatingPoint val){
+    write_float_term(str, val, thread_format);
+}
 
-#if !defined(__GNUC__) || __GNUC__ > 8
-    const auto parse_result = std::from_chars(str.data(), str.data() + str.size(), result, std::chars_format::fixed);
-    assert(parse_result.ptr == str.data()+str.size());
-#else
-    // Must allocate to avoid reading past end of view, e.g. parsing view of "23" from a string "1234"
-    result = std::stold(std::string(str));
+/// A decimal string split into a significand of at most 19 digits and a power of ten, with value w·10^q
+struct DecimalParts {
+    uint64_t w = 0;
+    int64_t q = 0;
+    bool truncated = false;  ///< Nonzero digits past the 19 held by w were dropped
+    std::string_view significand;  ///< The digits and decimal point, excluding the exponent
+    int64_t exponent = 0;  ///< The exponent written after 'e', if any
+};
+
+static constexpr size_t MAX_SIGNIFICAND_DIGITS = std::numeric_limits<uint64_t>::digits10;
+static constexpr size_t DIGITS_PER_WORD = 8;
+static constexpr int64_t EXPONENT_SATURATION = 0x10000000;
+
+static constexpr bool is_digit(char c) noexcept {
+    return c >= '0' && c <= '9';
+}
+
+/// Load eight chars with the first in the lowest byte, regardless of endianness
+static uint64_t load_eight_chars(const char* chars) noexcept {
+    uint64_t val = 0;
+    for(size_t i = 0; i < DIGITS_PER_WORD; i++)
+        val |= static_cast<uint64_t>(static_cast<uint8_t>(chars[i])) << (8*i);
+    return val;
+}
+
+static constexpr bool is_eight_digits(uint64_t chars) noexcept {
+    return ((chars & 0xF0F0F0F0F0F0F0F0) | (((chars + 0x0606060606060606) & 0xF0F0F0F0F0F0F0F0) >> 4))
+           == 0x3333333333333333;
+}
+
+/// Convert eight ASCII digits to their value with three multiplications
+static constexpr uint32_t parse_eight_digits(uint64_t chars) noexcept {
+    constexpr uint64_t mask = 0x000000FF000000FF;
+    constexpr uint64_t mul1 = 100 + (uint64_t(1000000) << 32);
+    constexpr uint64_t mul2 = 1 + (uint64_t(10000) << 32);
+    chars -= 0x3030303030303030;
+    chars = (chars * 10) + (chars >> 8);
+    return static_cast<uint32_t>((((chars & mask) * mul1) + (((chars >> 16) & mask) * mul2)) >> 32);
+}
+
+static const char* parse_significand_digits(
+        const char* it, const char* end, DecimalParts& parts, size_t& num_digits, bool after_point) noexcept {
+    while(num_digits + DIGITS_PER_WORD <= MAX_SIGNIFICAND_DIGITS && end - it >= static_cast<ptrdiff_t>(DIGITS_PER_WORD)){
+        const uint64_t chars = load_eight_chars(it);
+        if(!is_eight_digits(chars)) break;
+        parts.w = 100000000*parts.w + parse_eight_digits(chars);
+        num_digits += DIGITS_PER_WORD;
+        if(after_point) parts.q -= DIGITS_PER_WORD;
+        it += DIGITS_PER_WORD;
+    }
+
+    for(; it != end && is_digit(*it); it++){
+        if(num_digits < MAX_SIGNIFICAND_DIGITS){
+            parts.w = 10*parts.w + (*it - '0');
+            num_digits++;
+            if(after_point) parts.q--;
+        }else{
+            if(!after_point) parts.q++;
+            parts.truncated |= (*it != '0');
+        }
+    }
+
+    return it;
+}
+
+static DecimalParts parse_decimal(std::string_view str) noexcept {
+    DecimalParts parts;
+    const char* it = str.data();
+    const char* const end = str.data() + str.size();
+    size_t num_digits = 0;
+
+    // Leading zeros are not significant digits
+    while(it != end && *it == '0') it++;
+    it = parse_significand_digits(it, end, parts, num_digits, false);
+
+    if(it != end && *it == '.'){
+        it++;
+        if(num_digits == 0) for(; it != end && *it == '0'; it++) parts.q--;
+        it = parse_significand_digits(it, end, parts, num_digits, true);
+    }
+
+    parts.significand = std::string_view(str.data(), it - str.data());
+
+    if(it != end && (*it == 'e' || *it == 'E')){
+        it++;
+        const bool is_negative = (it != end && *it == '-');
+        if(it != end && (*it == '-' || *it == '+')) it++;
+        for(; it != end && is_digit(*it); it++)
+            if(parts.exponent < EXPONENT_SATURATION) parts.exponent = 10*parts.exponent + (*it - '0');
+        if(is_negative) parts.exponent = -parts.exponent;
+        parts.q += parts.exponent;
+    }
+
+    assert(it == end);
+    return parts;
+}
+
+static constexpr int DOUBLE_MANTISSA_BITS = std::numeric_limits<double>::digits - 1;
+static constexpr int32_t DOUBLE_MIN_EXPONENT = -1023;
+static constexpr int32_t DOUBLE_INFINITE_POWER = 0x7FF;
+static constexpr int64_t DOUBLE_MAX_EXACT_POWER_OF_TEN = 22;
+
+static_assert(std::numeric_limits<double>::is_iec559 && DOUBLE_MANTISSA_BITS == 52);
+
+/// Powers of ten exactly representable as doubles
+static constexpr double exact_powers_of_ten[DOUBLE_MAX_EXACT_POWER_OF_TEN+1] = {
+    1e0, 1e1, 1e2, 1e3, 1e4, 1e5, 1e6, 1e7, 1e8, 1e9, 1e10, 1e11,
+    1e12, 1e13, 1e14, 1e15, 1e16, 1e17, 1e18, 1e19, 1e20, 1e21, 1e22,
+};
+
+/// The most significant bits of w·5^q, accurate enough to round to a double
+static intx::uint128 product_approximation(int64_t q, uint64_t w) noexcept {
+    constexpr uint64_t precision_mask = std::numeric_limits<uint64_t>::max() >> (DOUBLE_MANTISSA_BITS + 3);
+    const size_t index = 2*static_cast<size_t>(q - SMALLEST_POWER_OF_FIVE);
+
+    intx::uint128 product = intx::umul(w, POWERS_OF_FIVE_128[index]);
+    if((product[1] & precision_mask) == precision_mask){
+        // The lower bits of the product are ambiguous, so include the next 64 bits of 5^q
+        const intx::uint128 second_product = intx::umul(w, POWERS_OF_FIVE_128[index+1]);
+        product += second_product[1];
+    }
+
+    return product;
+}
+
+/// Round w·10^q to the bit pattern of the nearest double by the Eisel–Lemire algorithm.
+/// Lemire, "Number Parsing at a Gigabyte per Second" (2021), and Mushtak and Lemire,
+/// "Fast Number Parsing Without Fallback" (2023), which shows the approximation always suffices.
+static uint64_t eisel_lemire(int64_t q, uint64_t w) noexcept {
+    constexpr int64_t min_round_to_even = -4;
+    constexpr int64_t max_round_to_even = 23;
+    constexpr uint64_t hidden_bit = uint64_t(1) << DOUBLE_MANTISSA_BITS;
+
+    if(w == 0 || q < SMALLEST_POWER_OF_FIVE) return 0;
+    if(q > LARGEST_POWER_OF_FIVE) return static_cast<uint64_t>(DOUBLE_INFINITE_POWER) << DOUBLE_MANTISSA_BITS;
+
+    const int lz = std::countl_zero(w);
+    w <<= lz;
+    const intx::uint128 product = product_approximation(q, w);
+
+    const int upper_bit = static_cast<int>(product[1] >> 63);
+    const int shift = upper_bit + 64 - DOUBLE_MANTISSA_BITS - 3;
+    uint64_t mantissa = product[1] >> shift;
+
+    // floor(log2(10^q)) + 63 for q in the table range
+    const int32_t power_of_two = static_cast<int32_t>((((152170 + 65536) * q) >> 16) + 63);
+    int32_t power2 = power_of_two + upper_bit - lz - DOUBLE_MIN_EXPONENT;
+
+    if(power2 <= 0){
+        // Subnormal
+        if(-power2 + 1 >= 64) return 0;
+        mantissa >>= -power2 + 1;
+        mantissa += (mantissa & 1);
+        mantissa >>= 1;
+        power2 = (mantissa < hidden_bit) ? 0 : 1;
+        return (mantissa & (hidden_bit - 1)) | (static_cast<uint64_t>(power2) << DOUBLE_MANTISSA_BITS);
+    }
+
+    // Exactly halfway between two doubles, which is only possible for small powers, rounds to even
+    if(product[0] <= 1 && q >= min_round_to_even && q <= max_round_to_even && (mantissa & 3) == 1
+            && (mantissa << shift) == product[1]){
+        mantissa &= ~uint64_t(1);
+    }
+
+    mantissa += (mantissa & 1);
+    mantissa >>= 1;
+    if(mantissa >= 2*hidden_bit){
+        mantissa = hidden_bit;
+        power2++;
+    }
+
+    if(power2 >= DOUBLE_INFINITE_POWER) return static_cast<uint64_t>(DOUBLE_INFINITE_POWER) << DOUBLE_MANTISSA_BITS;
+    return (mantissa & (hidden_bit - 1)) | (static_cast<uint64_t>(power2) << DOUBLE_MANTISSA_BITS);
+}
+
+static void mpz_set_uint64(mpz_t result, uint64_t val) noexcept {
+    // Avoid mpz_set_ui, since unsigned long is 32 bits on Windows
+    mpz_set_ui(result, static_cast<unsigned long>(val >> 32));
+    mpz_mul_2exp(result, result, 32);
+    mpz_add_ui(result, result, static_cast<unsigned long>(val & 0xFFFFFFFF));
+}
+
+/// Decide whether the decimal string rounds to the double below or above the boundary between them,
+/// comparing every digit to the halfway point with exact big integer arithmetic
+static uint64_t round_exactly(const DecimalParts& parts, uint64_t lower_bits) noexcept {
+    constexpr unsigned long chunk_base = 1000000000;  // Fits unsigned long on every platform
+
+    // The digits as an integer D with value D·10^E
+    mpz_t decimal, halfway, scale;
+    mpz_init(decimal);
+    int64_t E = parts.exponent;
+    bool after_point = false;
+    unsigned long chunk = 0;
+    unsigned long chunk_scale = 1;
+    for(const char c : parts.significand){
+        if(c == '.'){
+            after_point = true;
+            continue;
+        }
+        chunk = 10*chunk + (c - '0');
+        chunk_scale *= 10;
+        if(after_point) E--;
+        if(chunk_scale == chunk_base){
+            mpz_mul_ui(decimal, decimal, chunk_scale);
+            mpz_add_ui(decimal, decimal, chunk);
+            chunk = 0;
+            chunk_scale = 1;
+        }
+    }
+    mpz_mul_ui(decimal, decimal, chunk_scale);
+    mpz_add_ui(decimal, decimal, chunk);
+
+    // The halfway point (2M+1)·2^(e-1) between the lower double M·2^e and the next
+    constexpr uint64_t hidden_bit = uint64_t(1) << DOUBLE_MANTISSA_BITS;
+    const int32_t biased_exponent = static_cast<int32_t>(lower_bits >> DOUBLE_MANTISSA_BITS);
+    const uint64_t M = (biased_exponent == 0) ? lower_bits : ((lower_bits & (hidden_bit - 1)) | hidden_bit);
+    const int64_t e = std::max(biased_exponent, 1) + DOUBLE_MIN_EXPONENT - DOUBLE_MANTISSA_BITS;
+    mpz_init(halfway);
+    mpz_set_uint64(halfway, 2*M + 1);
+
+    mpz_init(scale);
+    mpz_ui_pow_ui(scale, 10, static_cast<unsigned long>(std::abs(E)));
+    if(E >= 0) mpz_mul(decimal, decimal, scale);
+    else mpz_mul(halfway, halfway, scale);
+    mpz_clear(scale);
+
+    if(e - 1 >= 0) mpz_mul_2exp(halfway, halfway, static_cast<mp_bitcnt_t>(e - 1));
+    else mpz_mul_2exp(decimal, decimal, static_cast<mp_bitcnt_t>(1 - e));
+
+    const int comparison = mpz_cmp(decimal, halfway);
+    mpz_clear(decimal);
+    mpz_clear(halfway);
+
+    const bool round_up = comparison > 0 || (comparison == 0 && (lower_bits & 1));
+    return lower_bits + round_up;
+}
+
+static double decimal_to_double(const DecimalParts& parts) noexcept {
+#if defined(FLT_EVAL_METHOD) && FLT_EVAL_METHOD == 0
+    // Clinger's fast path, where both operands are exact and one rounding follows
+    if(!parts.truncated && parts.w <= (uint64_t(1) << (DOUBLE_MANTISSA_BITS+1))
+            && parts.q >= -DOUBLE_MAX_EXACT_POWER_OF_TEN && parts.q <= DOUBLE_MAX_EXACT_POWER_OF_TEN){
+        const double w = static_cast<double>(parts.w);
+        return parts.q < 0 ? w / exact_powers_of_ten[-parts.q] : w * exact_powers_of_ten[parts.q];
+    }
 #endif
 
+    uint64_t bits = eisel_lemire(parts.q, parts.w);
+
+    // The dropped digits place the value between w·10^q and (w+1)·10^q,
+    // so the result is only ambiguous when those bounds round differently
+    if(parts.truncated && bits != eisel_lemire(parts.q, parts.w + 1))
+        bits = round_exactly(parts, bits);
+
+    double result;
+    std::memcpy(&result, &bits, sizeof(double));
     return result;
 }
 
-FloatingPoint strscientific2floatingpoint(std::string_view str) noexcept {
-    long double result;
+double strdecimal2double(std::string_view str) noexcept {
+    return decimal_to_double(parse_decimal(str));
+}
+
+double strscientific2double(std::string_view str) noexcept {
+    return decimal_to_double(parse_decimal(str));
+}
+
+static constexpr int64_t LONG_DOUBLE_MAX_EXACT_POWER_OF_TEN = 27;
+
+/// Powers of ten exactly representable as long doubles with at least a 64-bit mantissa
+static constexpr long double exact_long_double_powers_of_ten[LONG_DOUBLE_MAX_EXACT_POWER_OF_TEN+1] = {
+    1e0L, 1e1L, 1e2L, 1e3L, 1e4L, 1e5L, 1e6L, 1e7L, 1e8L, 1e9L, 1e10L, 1e11L, 1e12L, 1e13L,
+    1e14L, 1e15L, 1e16L, 1e17L, 1e18L, 1e19L, 1e20L, 1e21L, 1e22L, 1e23L, 1e24L, 1e25L, 1e26L, 1e27L,
+};
+
+static long double decimal_to_long_double(std::string_view str) noexcept {
+    if constexpr(std::numeric_limits<long double>::digits == std::numeric_limits<double>::digits){
+        return strdecimal2double(str);
+    }else{
+        const DecimalParts parts = parse_decimal(str);
+        if(parts.w == 0) return 0;
+
+#if defined(FLT_EVAL_METHOD) && FLT_EVAL_METHOD >= 0
+        // Every w fits the mantissa, so Clinger's fast path covers more powers than for double
+        if(std::numeric_limits<long double>::is_iec559 && std::numeric_limits<long double>::digits >= 64
+                && !parts.truncated
+                && parts.q >= -LONG_DOUBLE_MAX_EXACT_POWER_OF_TEN && parts.q <= LONG_DOUBLE_MAX_EXACT_POWER_OF_TEN){
+            const long double w = static_cast<long double>(parts.w);
+            return parts.q < 0 ? w / exact_long_double_powers_of_ten[-parts.q]
+                               : w * exact_long_double_powers_of_ten[parts.q];
+        }
+#endif
 
+        long double result;
 #if !defined(__GNUC__) || __GNUC__ > 8
-    const auto parse_result = std::from_chars(str.data(), str.data() + str.size(), result, std::chars_format::scientific);
-    assert(parse_result.ptr == str.data()+str.size());
+        const auto parse_result = std::from_chars(str.data(), str.data() + str.size(), result, std::chars_format::general);
+        assert(parse_result.ptr == str.data()+str.size());
 #else
-    // Must allocate to avoid reading past end of view, e.g. parsing view of "23" from a string "1234"
-    result = std::stold(std::string(str));
+        // Copy to a terminated buffer to avoid reading past the end of the view, e.g. parsing "23" from "1234".
+        // Only unusually long strings need the heap.
+        static constexpr size_t STACK_BUFFER_SIZE = 64;
+        if(str.size() < STACK_BUFFER_SIZE){
+            char buffer[STACK_BUFFER_SIZE];
+            std::memcpy(buffer, str.data(), str.size());
+            buffer[str.size()] = '\0';
+            result = std::strtold(buffer, nullptr);
+        }else{
+            result = std::strtold(std::string(str).c_str(), nullptr);
+        }
 #endif
 
-    return result;
+        return result;
+    }
+}
+
+FloatingPoint strdecimal2floatingpoint(std::string_view str) noexcept {
+    return decimal_to_long_double(str);
+}
+
+FloatingPoint strscientific2floatingpoint(std::string_view str) noexcept {
+    return decimal_to_long_double(str);
 }
 
 }
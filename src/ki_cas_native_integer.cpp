@@ -1,9 +1,13 @@
 #include "ki_cas_native_integer.h"
 
+#include <algorithm>
+#include <array>
+#include <bit>
 #include <cassert>
 #include <charconv>
-#include <cmath>
-#include <flint/ulong_extras.h>
+#include <iterator>
+#include <limits>
+#include <utility>
 
 #if __cplusplus >= 202302L
 #include <stdckdint.h>
@@ -43,75 +47,310 @@ size_t knownfit_sub(size_t a, size_t b) noexcept {
     return a - b;
 }
 
+/// Bitmask of the residues of k-th powers modulo m, for rejecting arguments which cannot be k-th powers
+static constexpr uint64_t power_residues(size_t m, size_t k) noexcept {
+    uint64_t mask = 0;
+    for(size_t x = 0; x < m; x++){
+        size_t residue = 1;
+        for(size_t i = 0; i < k; i++) residue = residue * x % m;
+        mask |= uint64_t(1) << residue;
+    }
+    return mask;
+}
+
+struct ResidueFilter {
+    size_t modulus;
+    uint64_t residues;
+};
+
+/// Moduli with few k-th power residues, where each prime modulus is 1 modulo k. Powers above 7 have no filter,
+/// since their roots are small enough that computing them is as fast.
+static constexpr ResidueFilter SQUARE_FILTERS[] = {{64, power_residues(64, 2)}, {63, power_residues(63, 2)}, {11, power_residues(11, 2)}};
+static constexpr ResidueFilter CUBE_FILTERS[] = {{63, power_residues(63, 3)}, {19, power_residues(19, 3)}, {37, power_residues(37, 3)}};
+static constexpr ResidueFilter FIFTH_POWER_FILTERS[] = {{11, power_residues(11, 5)}, {31, power_residues(31, 5)}, {41, power_residues(41, 5)}};
+static constexpr ResidueFilter SEVENTH_POWER_FILTERS[] = {{29, power_residues(29, 7)}, {43, power_residues(43, 7)}};
+
+template<size_t num_filters>
+static bool is_nonresidue(size_t arg, const ResidueFilter (&filters)[num_filters]) noexcept {
+    for(const ResidueFilter& filter : filters)
+        if(((filter.residues >> (arg % filter.modulus)) & 1) == 0) return true;
+    return false;
+}
+
+/// Returns true if the residues of the argument rule out an integer root
+static bool is_nonresidue_for_power(size_t arg, size_t power) noexcept {
+    return (power % 2 == 0 && is_nonresidue(arg, SQUARE_FILTERS))
+        || (power % 3 == 0 && is_nonresidue(arg, CUBE_FILTERS))
+        || (power % 5 == 0 && is_nonresidue(arg, FIFTH_POWER_FILTERS))
+        || (power % 7 == 0 && is_nonresidue(arg, SEVENTH_POWER_FILTERS));
+}
+
+size_t floor_nrt(size_t arg, size_t power) noexcept {
+    assert(power != 0);
+    if(power == 1 || arg < 2) return arg;
+
+    const size_t bits = static_cast<size_t>(std::bit_width(arg));
+    if(power >= bits) return 1;
+
+    // The root has at most this many bits. Small roots of high powers are built a bit at a time,
+    // since Newton iteration only shrinks an overestimate by a factor of about (power-1)/power per step.
+    const size_t root_bits = (bits + power - 1) / power;
+    if(root_bits <= 8){
+        size_t root = size_t(1) << (root_bits - 1);
+        for(size_t bit = root >> 1; bit != 0; bit >>= 1){
+            size_t raised;
+            if(!ckd_pow(&raised, root | bit, power) && raised <= arg) root |= bit;
+        }
+        return root;
+    }
+
+    // Newton iteration decreases monotonically to the floor of the root from any overestimate.
+    size_t root = size_t(1) << root_bits;
+    if(power == 2){
+        for(;;){
+            const size_t next = (root + arg / root) / 2;
+            if(next >= root) return root;
+            root = next;
+        }
+    }
+
+    for(;;){
+        // A power of the estimate which overflows exceeds the argument, so contributes nothing to the quotient
+        size_t raised = root;
+        bool overflowed = false;
+        for(size_t i = 2; i < power && !overflowed; i++) overflowed = ckd_mul(&raised, raised, root);
+        const size_t quotient = overflowed ? 0 : arg / raised;
+        const size_t next = ((power - 1) * root + quotient) / power;
+        if(next >= root) return root;
+        root = next;
+    }
+}
+
 bool ckd_sqrt(size_t* result, size_t arg) noexcept {
-    // Adequate precision confirmed for 64-bit numbers, see tests
-    *result = static_cast<size_t>(std::sqrt(static_cast<double>(arg)));
+    if(is_nonresidue(arg, SQUARE_FILTERS)) return true;
+    *result = floor_nrt(arg, 2);
     return (*result) * (*result) != arg;
 }
 
 bool ckd_cbrt(size_t* result, size_t arg) noexcept {
-    // Adequate precision confirmed for 64-bit numbers, see tests
-    *result = n_cbrt(arg);
+    if(is_nonresidue(arg, CUBE_FILTERS)) return true;
+    *result = floor_nrt(arg, 3);
     return (*result) * (*result) * (*result) != arg;
 }
 
 bool ckd_nrt(size_t* result, size_t arg, size_t power) noexcept {
     assert(power >= 4);
+    if(is_nonresidue_for_power(arg, power)) return true;
+    *result = floor_nrt(arg, power);
+    return knownfit_pow(*result, power) != arg;
+}
 
-    const auto fp_result = std::pow(arg, 1.0/static_cast<double>(power));
-    *result = static_cast<size_t>(fp_result + 0.5);
+/// Residue tables for screening a batch of candidates without branches: one lookup modulo 64, and one lookup modulo
+/// a product of small moduli, which combines their filters so that each candidate costs a single division
+template<size_t k, size_t modulus>
+struct BatchResidueFilter {
+    static constexpr uint64_t residues_mod_64 = power_residues(64, k);
+    static constexpr std::array<uint64_t, (modulus + 63) / 64> residues = [](){
+        std::array<uint64_t, (modulus + 63) / 64> mask = {};
+        for(size_t x = 0; x < modulus; x++){
+            size_t residue = 1;
+            for(size_t i = 0; i < k; i++) residue = residue * x % modulus;
+            mask[residue / 64] |= uint64_t(1) << (residue % 64);
+        }
+        return mask;
+    }();
 
-    constexpr double tol = 1e-11;
-    const auto error = fp_result - *result;
-    if(error > tol || error < -tol) return true;
+    static bool passes(size_t arg) noexcept {
+        const size_t residue = arg % modulus;
+        return ((residues_mod_64 >> (arg % 64)) & (residues[residue / 64] >> (residue % 64)) & 1) != 0;
+    }
+};
 
-    // EVENTUALLY: it would be nice if we could rely on the tolerance only,
-    //             but the search space to confirm no impure roots is enormous.
-    return knownfit_pow(*result, power) != arg;
+/// Squares pass modulo 64 and 63*65*11 with probability 0.0084, and cubes modulo 64 and 63*19*37 with 0.011
+using BatchSquareFilter = BatchResidueFilter<2, 63*65*11>;
+using BatchCubeFilter = BatchResidueFilter<3, 63*19*37>;
+
+/// Screen the arguments a block at a time, collecting the indices of survivors branch-free in the first pass,
+/// so that the loop has no data-dependent branches to mispredict, then take roots of the survivors only
+template<typename Filter, size_t power>
+static size_t batch_root(size_t* results, bool* is_inexact, const size_t* args, size_t num_args) noexcept {
+    constexpr size_t BLOCK_SIZE = 256;
+    size_t survivors[BLOCK_SIZE];
+    size_t num_passed = 0;
+
+    for(size_t block = 0; block < num_args; block += BLOCK_SIZE){
+        const size_t block_end = std::min(block + BLOCK_SIZE, num_args);
+        size_t num_survivors = 0;
+        for(size_t i = block; i < block_end; i++){
+            const bool passes = Filter::passes(args[i]);
+            is_inexact[i] = !passes;
+            survivors[num_survivors] = i;
+            num_survivors += passes;
+        }
+
+        for(size_t j = 0; j < num_survivors; j++){
+            const size_t i = survivors[j];
+            results[i] = floor_nrt(args[i], power);
+            is_inexact[i] = knownfit_pow(results[i], power) != args[i];
+        }
+        num_passed += num_survivors;
+    }
+
+    return num_passed;
+}
+
+size_t ckd_sqrt(size_t* results, bool* is_inexact, const size_t* args, size_t num_args) noexcept {
+    return batch_root<BatchSquareFilter, 2>(results, is_inexact, args, num_args);
+}
+
+size_t ckd_cbrt(size_t* results, bool* is_inexact, const size_t* args, size_t num_args) noexcept {
+    return batch_root<BatchCubeFilter, 3>(results, is_inexact, args, num_args);
 }
 
-static size_t ckd_pow_helper(bool& overflowed, size_t base, size_t power) noexcept {
-    if (power == 0) return 1;
-    if (power == 1) return base;
+/// A prime exponent p of a word-sized perfect power, and the smallest prime modulus q = 1 (mod p),
+/// modulo which only about 1 in p residues are p-th powers
+struct PrimeExponent {
+    size_t p;
+    size_t q;
+};
+
+static constexpr PrimeExponent PRIME_EXPONENTS[] = {
+    {2, 3}, {3, 7}, {5, 11}, {7, 29}, {11, 23}, {13, 53}, {17, 103}, {19, 191}, {23, 47},
+    {29, 59}, {31, 311}, {37, 149}, {41, 83}, {43, 173}, {47, 283}, {53, 107}, {59, 709}, {61, 367},
+};
+
+/// Bitmask of the residues of p-th powers modulo q, for moduli wider than a word
+template<PrimeExponent exponent>
+static constexpr auto WIDE_POWER_RESIDUES = [](){
+    std::array<uint64_t, (exponent.q + 63) / 64> mask = {};
+    for(size_t x = 0; x < exponent.q; x++){
+        size_t residue = 1;
+        for(size_t i = 0; i < exponent.p; i++) residue = residue * x % exponent.q;
+        mask[residue / 64] |= uint64_t(1) << (residue % 64);
+    }
+    return mask;
+}();
+
+/// Divide out the prime exponent from the argument for as long as the argument is a power of it
+template<PrimeExponent exponent>
+static void take_prime_exponent(size_t& arg, size_t& total_exponent) noexcept {
+    constexpr size_t p = exponent.p;
+    while(p < static_cast<size_t>(std::bit_width(arg))){
+        if constexpr(p <= 7){
+            if(is_nonresidue_for_power(arg, p)) return;
+        }else{
+            const size_t residue = arg % exponent.q;
+            if(((WIDE_POWER_RESIDUES<exponent>[residue / 64] >> (residue % 64)) & 1) == 0) return;
+        }
+
+        const size_t root = floor_nrt(arg, p);
+        if(knownfit_pow(root, p) != arg) return;
+        arg = root;
+        total_exponent *= p;
+    }
+}
+
+size_t is_perfect_power(size_t* root, size_t arg) noexcept {
+    if(arg < 2) return 0;
+
+    // The largest exponent is the product of the prime exponents taken while the root remains a power.
+    // Each prime is expanded at compile time, so that the residue tests divide by constants.
+    size_t exponent = 1;
+    [&]<size_t... i>(std::index_sequence<i...>){
+        (take_prime_exponent<PRIME_EXPONENTS[i]>(arg, exponent), ...);
+    }(std::make_index_sequence<std::size(PRIME_EXPONENTS)>());
+
+    *root = arg;
+    return exponent == 1 ? 0 : exponent;
+}
 
-    const size_t tmp = ckd_pow_helper(overflowed, base, power/2);
-    if(overflowed) return 0;
+void is_perfect_power(size_t* exponents, size_t* roots, const size_t* args, size_t num_args) noexcept {
+    for(size_t i = 0; i < num_args; i++) exponents[i] = is_perfect_power(roots + i, args[i]);
+}
 
-    size_t result;
-    if(power%2 == 0){
-        overflowed = ckd_mul(&result, tmp, tmp);
-    }else{
-        overflowed = ckd_mul(&result, tmp, tmp);
-        if(!overflowed) overflowed = ckd_mul(&result, base, result);
+/// The largest base whose power fits in the word type, for each power below the word width.
+/// Both word sizes are tabulated so that the 32-bit table is checked on 64-bit hosts too.
+template<typename Word>
+static constexpr auto MAX_BASE_FOR_POWER = [](){
+    constexpr size_t num_bits = std::numeric_limits<Word>::digits;
+    constexpr Word word_max = std::numeric_limits<Word>::max();
+    std::array<Word, num_bits> max_base = {};
+    max_base[0] = word_max;
+    max_base[1] = word_max;
+    for(size_t power = 2; power < num_bits; power++){
+        // Binary search for the largest base whose power does not exceed the maximum
+        Word low = 1;
+        Word high = Word(1) << ((num_bits + power - 1) / power);
+        while(low < high){
+            const Word mid = low + (high - low + 1) / 2;
+            Word raised = 1;
+            bool overflows = false;
+            for(size_t i = 0; i < power && !overflows; i++){
+                overflows = raised > word_max / mid;
+                raised *= mid;
+            }
+            if(overflows) high = mid - 1;
+            else low = mid;
+        }
+        max_base[power] = low;
     }
+    return max_base;
+}();
+
+static_assert(MAX_BASE_FOR_POWER<uint32_t>[2] == 65535);
+static_assert(MAX_BASE_FOR_POWER<uint32_t>[3] == 1625);
+static_assert(MAX_BASE_FOR_POWER<uint32_t>[31] == 2);
+static_assert(MAX_BASE_FOR_POWER<uint64_t>[2] == 4294967295u);
+static_assert(MAX_BASE_FOR_POWER<uint64_t>[3] == 2642245);
+static_assert(MAX_BASE_FOR_POWER<uint64_t>[63] == 2);
+
+bool pow_overflows(size_t base, size_t power) noexcept {
+    if(power < MAX_BASE_FOR_POWER<size_t>.size()) return base > MAX_BASE_FOR_POWER<size_t>[power];
+    return base > 1;
+}
 
-    return result;
+/// Square-and-multiply from the least significant bit of the power, which only squares while higher bits remain,
+/// so no intermediate exceeds the result
+static size_t unchecked_pow(size_t base, size_t power) noexcept {
+    size_t result = 1;
+    for(;;){
+        if(power & 1) result *= base;
+        power >>= 1;
+        if(power == 0) return result;
+        base *= base;
+    }
 }
 
 bool ckd_pow(size_t* result, size_t base, size_t power) noexcept {
     assert(base != 0 || power != 0);  // 0^0 is not generally defined
-    bool overflowed = false;
-    *result = ckd_pow_helper(overflowed, base, power);
-    return overflowed;
+    if(pow_overflows(base, power)) return true;
+    *result = unchecked_pow(base, power);
+    return false;
 }
 
 size_t knownfit_pow(size_t base, size_t power) noexcept {
-    #ifndef NDEBUG
-    size_t result;
-    const bool overflow = ckd_pow(&result, base, power);
-    assert(overflow == false);
-    return result;
-    #else
-    return n_pow(base, power);
-    #endif
+    assert(base != 0 || power != 0);  // 0^0 is not generally defined
+    assert(!pow_overflows(base, power));
+    return unchecked_pow(base, power);
 }
 
-void write_native_int(std::string& str, size_t val) {
+/// Shared by the overloads, so that strings are written through a StringSink without type erasure
+template<OutputSink Sink> static void write_native_int_to(Sink& sink, size_t val) {
     constexpr size_t max_digits = std::numeric_limits<size_t>::digits10 + 1;
-    char buffer[max_digits];
-    const std::to_chars_result result = std::to_chars(buffer, buffer + max_digits, val);
+    char* const dest = sink.prepare(max_digits);
+    if(dest == nullptr) return;
+    const std::to_chars_result result = std::to_chars(dest, dest + max_digits, val);
     assert(result.ec == std::errc());
-    str.append(buffer, result.ptr - buffer);
+    sink.commit(result.ptr);
+}
+
+void write_native_int(SinkRef sink, size_t val) {
+    write_native_int_to(sink, val);
+}
+
+void write_native_int(std::string& str, size_t val) {
+    StringSink sink(str);
+    write_native_int_to(sink, val);
 }
 
 bool ckd_str2int(size_t* result, std::string_view str) noexcept {
@@ -410,14 +410,70 @@ bool ckd_sub(NativeRational* result, NativeRational a, NativeRational b) noexcep
     return true;
 }
 
+bool ckd_pow(NativeRational* result, NativeRational base, size_t power) noexcept {
+    assert(base.num != 0 || power != 0);  // 0^0 is not generally defined
+
+    if(pow_overflows(base.num, power) || pow_overflows(base.den, power)){
+        base.reduceInPlace();
+        if(pow_overflows(base.num, power) || pow_overflows(base.den, power)) return true;
+    }
+
+    result->num = knownfit_pow(base.num, power);
+    result->den = knownfit_pow(base.den, power);
+    return false;
+}
+
+/// Returns true if the word has no exact root, dispatching to the specialised roots
+static bool ckd_word_root(size_t* result, size_t arg, size_t root) noexcept {
+    switch(root){
+        case 1: *result = arg; return false;
+        case 2: return ckd_sqrt(result, arg);
+        case 3: return ckd_cbrt(result, arg);
+        default: return ckd_nrt(result, arg, root);
+    }
+}
+
+bool ckd_root(NativeRational* result, NativeRational base, size_t root) noexcept {
+    assert(root != 0);
+
+    if(ckd_word_root(&result->num, base.num, root) == false && ckd_word_root(&result->den, base.den, root) == false)
+        return false;
+
+    // A canonical rational is an exact power only if its numerator and denominator are
+    const size_t gcd = std::gcd(base.num, base.den);
+    if(gcd == 1) return true;
+    base.num /= gcd;
+    base.den /= gcd;
+
+    return ckd_word_root(&result->num, base.num, root) || ckd_word_root(&result->den, base.den, root);
+}
+
+bool ckd_pow(NativeRational* result, NativeRational base, NativeRational exponent) noexcept {
+    assert(exponent.den != 0);
+    exponent.reduceInPlace();
+
+    // Taking the root first keeps the intermediate small
+    NativeRational root;
+    if(ckd_root(&root, base, exponent.den)) return true;
+    return ckd_pow(result, root, exponent.num);
+}
+
+template<bool typeset_fraction>
+void write_native_rational(SinkRef sink, NativeRational val) {
+    if(typeset_fraction) sink_append(sink, "⁜f⏴");
+    write_native_int(sink, val.num);
+    if(typeset_fraction) sink_append(sink, "⏵⏴");
+    else sink_append(sink, "/");
+    write_native_int(sink, val.den);
+    if(typeset_fraction) sink_append(sink, "⏵");
+}
+template void write_native_rational<false>(SinkRef, NativeRational);
+template void write_native_rational<true>(SinkRef, NativeRational);
+
 template<bool typeset_fraction>
 void write_native_rational(std::string& str, NativeRational val) {
-    if(typeset_fraction) str += "⁜f⏴";
-    write_native_int(str, val.num);
-    if(typeset_fraction) str += "⏵⏴";
-    else str += '/';
-    write_native_int(str, val.den);
-    if(typeset_fraction) str += "⏵";
+    StringSink sink(str);
+    write_native_rational<typeset_fraction>(sink, val);
 }
 template void write_native_rational<false>(std::string&, NativeRational);
 template void write_native_rational<true>(std::string&, NativeRational);
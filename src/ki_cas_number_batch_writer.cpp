@@ -0,0 +1,174 @@
+#include "ki_cas_number_batch_writer.h"
+
+#include <cassert>
+#include <charconv>
+#include <cstring>
+#include "ki_cas_big_num_wrapper.h"
+#include <limits>
+
+namespace KiCAS2 {
+
+static constexpr size_t NATIVE_MAX_DIGITS = std::numeric_limits<size_t>::digits10 + 1;
+static constexpr size_t TERM_SEPARATOR_SIZE = 3;  // " + " or " - "
+
+void NumberBatchWriter::reserve(size_t num_entries) {
+    entries.reserve(num_entries);
+}
+
+void NumberBatchWriter::clear() noexcept {
+    entries.clear();
+}
+
+size_t NumberBatchWriter::size() const noexcept {
+    return entries.size();
+}
+
+void NumberBatchWriter::add(size_t val) {
+    Entry& entry = entries.emplace_back(Entry{Kind::NativeInt, false, {}});
+    entry.native_int = val;
+}
+
+void NumberBatchWriter::add(NativeRational val) {
+    Entry& entry = entries.emplace_back(Entry{Kind::NativeRat, false, {}});
+    entry.native_rat = val;
+}
+
+void NumberBatchWriter::add(const fmpz_t val) {
+    Entry& entry = entries.emplace_back(Entry{Kind::BigInt, false, {}});
+    entry.big_int = val;
+}
+
+void NumberBatchWriter::add(const fmpq_t val) {
+    Entry& entry = entries.emplace_back(Entry{Kind::BigRat, false, {}});
+    entry.big_rat = val;
+}
+
+void NumberBatchWriter::addTerm(size_t val) {
+    add(val);
+    entries.back().is_term = true;
+}
+
+void NumberBatchWriter::addTerm(NativeRational val) {
+    add(val);
+    entries.back().is_term = true;
+}
+
+void NumberBatchWriter::addTerm(const fmpz_t val) {
+    add(val);
+    entries.back().is_term = true;
+}
+
+void NumberBatchWriter::addTerm(const fmpq_t val) {
+    add(val);
+    entries.back().is_term = true;
+}
+
+void NumberBatchWriter::addText(std::string_view text) {
+    Entry& entry = entries.emplace_back(Entry{Kind::Text, false, {}});
+    entry.text.data = text.data();
+    entry.text.size = text.size();
+}
+
+static size_t fmpz_upperbound(const fmpz* val) noexcept {
+    static constexpr size_t PLUS_ONE_FOR_SIGN = 1;
+    static constexpr size_t PLUS_ONE_FOR_ZERO = 1;
+    return fmpz_sizeinbase10upperbound(val) + (PLUS_ONE_FOR_SIGN + PLUS_ONE_FOR_ZERO);
+}
+
+size_t NumberBatchWriter::sizeUpperBound() const noexcept {
+    static constexpr size_t PLUS_ONE_FOR_NULL_TERMINATOR = 1;
+    static constexpr size_t PLUS_ONE_FOR_DIVISION = 1;
+
+    size_t total = PLUS_ONE_FOR_NULL_TERMINATOR;
+    for(const Entry& entry : entries){
+        if(entry.is_term) total += TERM_SEPARATOR_SIZE;
+
+        switch(entry.kind){
+            case Kind::NativeInt: total += NATIVE_MAX_DIGITS; break;
+            case Kind::NativeRat: total += 2*NATIVE_MAX_DIGITS + PLUS_ONE_FOR_DIVISION; break;
+            case Kind::BigInt: total += fmpz_upperbound(entry.big_int); break;
+            case Kind::BigRat:
+                total += fmpz_upperbound(fmpq_numref(entry.big_rat))
+                       + fmpz_upperbound(fmpq_denref(entry.big_rat))
+                       + PLUS_ONE_FOR_DIVISION;
+                break;
+            case Kind::Text: total += entry.text.size; break;
+        }
+    }
+
+    return total;
+}
+
+static char* write_native(char* dest, size_t val) noexcept {
+    const std::to_chars_result result = std::to_chars(dest, dest + NATIVE_MAX_DIGITS, val);
+    assert(result.ec == std::errc());
+    return result.ptr;
+}
+
+static char* write_fmpz_abs(char* dest, const fmpz* val) noexcept {
+    if(!COEFF_IS_MPZ(*val)) return write_native(dest, static_cast<size_t>(std::abs(*val)));
+
+    MP_INT big_int = *COEFF_TO_PTR(*val);
+    big_int._mp_size = std::abs(big_int._mp_size);
+    mpz_get_str(dest, 10, &big_int);
+    return dest + std::strlen(dest);
+}
+
+static char* write_sign(char* dest, bool is_negative, bool is_term, bool is_leading) noexcept {
+    if(is_term && !is_leading){
+        std::memcpy(dest, is_negative ? " - " : " + ", TERM_SEPARATOR_SIZE);
+        return dest + TERM_SEPARATOR_SIZE;
+    }
+
+    if(is_negative) *dest++ = '-';
+    return dest;
+}
+
+void NumberBatchWriter::write(SinkRef sink) const {
+    char* const begin = sink.prepare(sizeUpperBound());
+    if(begin == nullptr) return;
+
+    char* dest = begin;
+    bool is_leading = true;
+    for(const Entry& entry : entries){
+        switch(entry.kind){
+            case Kind::NativeInt:
+                dest = write_sign(dest, false, entry.is_term, is_leading);
+                dest = write_native(dest, entry.native_int);
+                break;
+            case Kind::NativeRat:
+                dest = write_sign(dest, false, entry.is_term, is_leading);
+                dest = write_native(dest, entry.native_rat.num);
+                *dest++ = '/';
+                dest = write_native(dest, entry.native_rat.den);
+                break;
+            case Kind::BigInt:
+                dest = write_sign(dest, fmpz_sgn(entry.big_int) < 0, entry.is_term, is_leading);
+                dest = write_fmpz_abs(dest, entry.big_int);
+                break;
+            case Kind::BigRat:
+                dest = write_sign(dest, fmpq_sgn(entry.big_rat) < 0, entry.is_term, is_leading);
+                dest = write_fmpz_abs(dest, fmpq_numref(entry.big_rat));
+                if(!fmpz_is_one(fmpq_denref(entry.big_rat))){
+                    *dest++ = '/';
+                    dest = write_fmpz_abs(dest, fmpq_denref(entry.big_rat));
+                }
+                break;
+            case Kind::Text:
+                std::memcpy(dest, entry.text.data, entry.text.size);
+                dest += entry.text.size;
+                break;
+        }
+        is_leading = false;
+    }
+
+    // Trim where the upper bound exceeded the actual need
+    sink.commit(dest);
+}
+
+void NumberBatchWriter::write(std::string& str) const {
+    StringSink sink(str);
+    write(sink);
+}
+
+}  // namespace KiCAS2
@@ -0,0 +1,122 @@
+#include "ki_cas_numeric_allocator.h"
+
+#ifdef _MSC_VER
+#include <malloc.h>  // MSC dependencies for GMP
+#endif
+
+#include <flint/flint.h>
+#include <gmp.h>
+
+#include <algorithm>
+#include <cassert>
+#include <cstdlib>
+#include <cstring>
+#include <limits>
+
+namespace KiCAS2 {
+
+static void* defaultAllocate(size_t n, AllocationSource) {
+    void* allocated = std::malloc(n);
+    if(allocated == nullptr) std::abort();  // GMP and Flint cannot recover from a failed allocation
+    return allocated;
+}
+
+static void* defaultReallocate(void* p, size_t, size_t n, AllocationSource) {
+    void* reallocated = std::realloc(p, n);
+    if(reallocated == nullptr) std::abort();
+    return reallocated;
+}
+
+static void defaultDeallocate(void* p, size_t, AllocationSource) noexcept {
+    std::free(p);
+}
+
+static constexpr NumericAllocator DEFAULT_NUMERIC_ALLOCATOR = {defaultAllocate, defaultReallocate, defaultDeallocate};
+
+// Constant initialised, so that allocators may be installed from static initialisers in any translation unit.
+// The first allocator is the base, with each later allocator layered over the one before.
+static NumericAllocator layers[1 + MAX_NUMERIC_ALLOCATOR_LAYERS] = {DEFAULT_NUMERIC_ALLOCATOR};
+static size_t num_layers = 1;
+static NumericAllocator installed = DEFAULT_NUMERIC_ALLOCATOR;
+
+static void* gmpAlloc(size_t n) {
+    return installed.allocate(n, AllocationSource::Gmp);
+}
+
+static void* gmpRealloc(void* p, size_t old, size_t n) {
+    return installed.reallocate(p, old, n, AllocationSource::Gmp);
+}
+
+static void gmpFree(void* p, size_t old) {
+    installed.deallocate(p, old, AllocationSource::Gmp);
+}
+
+static void* flintAlloc(size_t n) {
+    return installed.allocate(n, AllocationSource::Flint);
+}
+
+static void* flintCalloc(size_t num, size_t size) {
+    if(size != 0 && num > std::numeric_limits<size_t>::max() / size) std::abort();
+    void* allocated = installed.allocate(num*size, AllocationSource::Flint);
+    std::memset(allocated, 0, num*size);
+    return allocated;
+}
+
+static void* flintRealloc(void* p, size_t n) {
+    return installed.reallocate(p, 0, n, AllocationSource::Flint);
+}
+
+static void flintFree(void* p) {
+    installed.deallocate(p, 0, AllocationSource::Flint);
+}
+
+/// The hooks read the installed allocator on each call, so setting them again is harmless
+static void install_hooks() noexcept {
+    mp_set_memory_functions(gmpAlloc, gmpRealloc, gmpFree);
+    __flint_set_memory_functions(flintAlloc, flintCalloc, flintRealloc, flintFree);
+}
+
+NumericAllocator default_numeric_allocator() noexcept {
+    return DEFAULT_NUMERIC_ALLOCATOR;
+}
+
+void install_numeric_allocator(const NumericAllocator& allocator) noexcept {
+    layers[0] = allocator;
+    num_layers = 1;
+    installed = allocator;
+    install_hooks();
+}
+
+NumericAllocator layer_numeric_allocator(const NumericAllocator& allocator) noexcept {
+    if(num_layers == 1 + MAX_NUMERIC_ALLOCATOR_LAYERS) std::abort();
+
+    const NumericAllocator prior = installed;
+    layers[num_layers++] = allocator;
+    installed = allocator;
+    install_hooks();
+
+    return prior;
+}
+
+NumericAllocatorScope::NumericAllocatorScope() noexcept
+    : depth(num_layers) {}
+
+NumericAllocatorScope::~NumericAllocatorScope() {
+    assert(num_layers >= depth && "Numeric allocator scopes must end in reverse order");
+    while(num_layers > depth){
+        const NumericAllocator removed = layers[--num_layers];
+        installed = layers[num_layers - 1];
+        if(removed.release != nullptr) removed.release();
+    }
+    install_hooks();
+}
+
+NumericAllocator numeric_allocator() noexcept {
+    return installed;
+}
+
+bool is_numeric_allocator_installed(const NumericAllocator& allocator) noexcept {
+    return std::find(layers, layers + num_layers, allocator) != layers + num_layers;
+}
+
+}  // namespace KiCAS2
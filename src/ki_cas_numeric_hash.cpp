@@ -0,0 +1,58 @@
+#include "ki_cas_numeric_hash.h"
+
+namespace KiCAS2 {
+
+size_t numeric_hash_words(const uint64_t* words, size_t num_words, bool is_negative) noexcept {
+    while(num_words != 0 && words[num_words-1] == 0) num_words--;
+    if(num_words == 0) return 0;
+
+    uint64_t hash = numeric_hash_seed(num_words, is_negative);
+    for(size_t i = 0; i < num_words; i++) hash = numeric_hash_mix(hash ^ words[i]);
+
+    return static_cast<size_t>(hash);
+}
+
+size_t numeric_hash_limbs(const mp_limb_t* limbs, size_t num_limbs, bool is_negative) noexcept {
+#if GMP_LIMB_BITS == 64
+    return numeric_hash_words(reinterpret_cast<const uint64_t*>(limbs), num_limbs, is_negative);
+#else
+    // Stream pairs of 32-bit limbs as words, so that the hash does not depend on the limb size
+    static_assert(GMP_LIMB_BITS == 32, "Limbs are expected to be 32 or 64 bits");
+    while(num_limbs != 0 && limbs[num_limbs-1] == 0) num_limbs--;
+    if(num_limbs == 0) return 0;
+
+    const size_t num_words = (num_limbs + 1) / 2;
+    uint64_t hash = numeric_hash_seed(num_words, is_negative);
+    for(size_t i = 0; i < num_words; i++){
+        const uint64_t high = 2*i + 1 < num_limbs ? uint64_t(limbs[2*i + 1]) : 0;
+        hash = numeric_hash_mix(hash ^ (uint64_t(limbs[2*i]) | (high << 32)));
+    }
+
+    return static_cast<size_t>(hash);
+#endif
+}
+
+size_t numeric_hash(NativeRational val) noexcept {
+    if(val.den != 1) val.reduceInPlace();
+    return numeric_hash_rational(numeric_hash(val.num), numeric_hash(val.den));
+}
+
+size_t numeric_hash(const uint128_t& val, bool is_negative) noexcept {
+    return numeric_hash_words(&val[0], uint128_t::num_words, is_negative);
+}
+
+size_t numeric_hash(const uint256_t& val, bool is_negative) noexcept {
+    return numeric_hash_words(&val[0], uint256_t::num_words, is_negative);
+}
+
+size_t numeric_hash(const uint512_t& val, bool is_negative) noexcept {
+    return numeric_hash_words(&val[0], uint512_t::num_words, is_negative);
+}
+
+size_t numeric_hash(mpz_srcptr val) noexcept {
+    const bool is_negative = val->_mp_size < 0;
+    const size_t num_limbs = static_cast<size_t>(is_negative ? -val->_mp_size : val->_mp_size);
+    return numeric_hash_limbs(val->_mp_d, num_limbs, is_negative);
+}
+
+}  // namespace KiCAS2
@@ -0,0 +1,140 @@
+#include "ki_cas_output_sink.h"
+
+#include <algorithm>
+#include <cassert>
+#include <cerrno>
+
+#ifdef _WIN32
+#include <io.h>
+#define KICAS_WRITE_FD _write
+#else
+#include <unistd.h>
+#define KICAS_WRITE_FD ::write
+#endif
+
+namespace KiCAS2 {
+
+SpanSink::SpanSink(char* begin, char* end) noexcept
+    : begin(begin), cursor(begin), end(end) {
+    assert(begin <= end);
+}
+
+SpanSink::SpanSink(char* begin, size_t capacity) noexcept
+    : SpanSink(begin, begin + capacity) {}
+
+char* SpanSink::prepare(size_t n) noexcept {
+    if(has_overflowed || static_cast<size_t>(end - cursor) < n){
+        has_overflowed = true;
+        return nullptr;
+    }
+    return cursor;
+}
+
+void SpanSink::commit(char* end) noexcept {
+    assert(end >= cursor && end <= this->end);
+    cursor = end;
+}
+
+bool SpanSink::overflowed() const noexcept {
+    return has_overflowed;
+}
+
+std::string_view SpanSink::view() const noexcept {
+    return std::string_view(begin, cursor - begin);
+}
+
+ArenaSink::ArenaSink(size_t block_size) noexcept
+    : block_size(block_size) {
+    assert(block_size != 0);
+}
+
+char* ArenaSink::prepare(size_t n) {
+    if(blocks.empty() || blocks.back().capacity - blocks.back().used < n){
+        const size_t capacity = std::max(n, block_size);
+        blocks.push_back(Block{std::make_unique_for_overwrite<char[]>(capacity), 0, capacity});
+    }
+
+    Block& block = blocks.back();
+    return block.data.get() + block.used;
+}
+
+void ArenaSink::commit(char* end) noexcept {
+    Block& block = blocks.back();
+    assert(end >= block.data.get() + block.used && end <= block.data.get() + block.capacity);
+    block.used = end - block.data.get();
+}
+
+size_t ArenaSink::size() const noexcept {
+    size_t total = 0;
+    for(const Block& block : blocks) total += block.used;
+    return total;
+}
+
+size_t ArenaSink::numBlocks() const noexcept {
+    return blocks.size();
+}
+
+std::string ArenaSink::str() const {
+    std::string out;
+    out.reserve(size());
+    for(const Block& block : blocks) out.append(block.data.get(), block.used);
+    return out;
+}
+
+void ArenaSink::clear() noexcept {
+    blocks.clear();
+}
+
+FileDescriptorSink::FileDescriptorSink(int fd, size_t buffer_size)
+    : buffer(std::make_unique_for_overwrite<char[]>(buffer_size)), capacity(buffer_size), fd(fd) {
+    assert(buffer_size != 0);
+}
+
+FileDescriptorSink::~FileDescriptorSink() {
+    flush();
+}
+
+char* FileDescriptorSink::prepare(size_t n) {
+    if(capacity - used < n){
+        flush();
+
+        // A single number may exceed the buffer, in which case the buffer grows to fit
+        if(capacity < n){
+            buffer = std::make_unique_for_overwrite<char[]>(n);
+            capacity = n;
+        }
+    }
+
+    return buffer.get() + used;
+}
+
+void FileDescriptorSink::commit(char* end) noexcept {
+    assert(end >= buffer.get() + used && end <= buffer.get() + capacity);
+    used = end - buffer.get();
+}
+
+bool FileDescriptorSink::flush() noexcept {
+    const char* data = buffer.get();
+    size_t remaining = used;
+    used = 0;
+
+    while(remaining != 0 && !has_failed){
+        const auto written = KICAS_WRITE_FD(fd, data, static_cast<unsigned>(remaining));
+        if(written < 0 && errno == EINTR){
+            continue;  // Interrupted by a signal before writing anything
+        }else if(written <= 0){
+            has_failed = true;
+        }else{
+            data += written;
+            remaining -= written;
+        }
+    }
+
+    return has_failed;
+}
+
+bool FileDescriptorSink::failed() const noexcept {
+    return has_failed;
+}
+
+}  // namespace KiCAS2
@@ -0,0 +1,150 @@
+#include "ki_cas_wide_integer.h"
+
+#include <cassert>
+
+namespace KiCAS2 {
+
+template<unsigned N>
+static bool ckd_add_x(intx::uint<N>* result, const intx::uint<N>& a, const intx::uint<N>& b) noexcept {
+    const auto sum = intx::addc(a, b);
+    *result = sum.value;
+    return sum.carry;
+}
+
+bool ckd_add(uint256_t* result, const uint256_t& a, const uint256_t& b) noexcept {
+    return ckd_add_x(result, a, b);
+}
+
+bool ckd_add(uint512_t* result, const uint512_t& a, const uint512_t& b) noexcept {
+    return ckd_add_x(result, a, b);
+}
+
+template<unsigned N>
+static bool ckd_mul_x(intx::uint<N>* result, const intx::uint<N>& a, const intx::uint<N>& b) noexcept {
+    // Schoolbook multiplication over the significant words only, since intermediate values rarely fill the width
+    constexpr unsigned num_words = intx::uint<N>::num_words;
+    const unsigned a_words = intx::count_significant_words(a);
+    const unsigned b_words = intx::count_significant_words(b);
+    if(a_words + b_words > num_words + 1) return true;
+
+    uint64_t product[2*num_words] = {};
+    for(unsigned j = 0; j < b_words; j++){
+        uint64_t carry = 0;
+        for(unsigned i = 0; i < a_words; i++){
+            const intx::uint128 t = intx::umul(a[i], b[j]) + product[i+j] + carry;
+            product[i+j] = t[0];
+            carry = t[1];
+        }
+        product[j + a_words] = carry;
+    }
+
+    for(unsigned i = 0; i < num_words; i++) (*result)[i] = product[i];
+    return product[num_words] != 0;
+}
+
+bool ckd_mul(uint256_t* result, const uint256_t& a, const uint256_t& b) noexcept {
+    return ckd_mul_x(result, a, b);
+}
+
+bool ckd_mul(uint512_t* result, const uint512_t& a, const uint512_t& b) noexcept {
+    return ckd_mul_x(result, a, b);
+}
+
+template<unsigned N>
+static intx::uint<N> ckd_pow_helper(bool& overflowed, const intx::uint<N>& base, size_t power) noexcept {
+    if (power == 0) return 1;
+    if (power == 1) return base;
+
+    const intx::uint<N> tmp = ckd_pow_helper(overflowed, base, power/2);
+    if(overflowed) return 0;
+
+    intx::uint<N> result;
+    overflowed = ckd_mul_x(&result, tmp, tmp);
+    if(!overflowed && power%2 != 0) overflowed = ckd_mul_x(&result, base, result);
+
+    return result;
+}
+
+template<unsigned N>
+static bool ckd_pow_x(intx::uint<N>* result, const intx::uint<N>& base, size_t power) noexcept {
+    assert(base != 0 || power != 0);  // 0^0 is not generally defined
+    bool overflowed = false;
+    *result = ckd_pow_helper(overflowed, base, power);
+    return overflowed;
+}
+
+bool ckd_pow(uint256_t* result, const uint256_t& base, size_t power) noexcept {
+    return ckd_pow_x(result, base, power);
+}
+
+bool ckd_pow(uint512_t* result, const uint512_t& base, size_t power) noexcept {
+    return ckd_pow_x(result, base, power);
+}
+
+template<unsigned N>
+static bool ckd_div_x(intx::uint<N>* result, const intx::uint<N>& dividend, const intx::uint<N>& divisor) noexcept {
+    assert(divisor != 0);
+    const auto qr = intx::udivrem(dividend, divisor);
+    *result = qr.quot;
+    return qr.rem != 0;
+}
+
+bool ckd_div(uint256_t* result, const uint256_t& dividend, const uint256_t& divisor) noexcept {
+    return ckd_div_x(result, dividend, divisor);
+}
+
+bool ckd_div(uint512_t* result, const uint512_t& dividend, const uint512_t& divisor) noexcept {
+    return ckd_div_x(result, dividend, divisor);
+}
+
+template<unsigned N>
+static Int promote_add_x(const intx::uint<N>& a, const intx::uint<N>& b) {
+    const auto sum = intx::addc(a, b);
+    fmpz result = uintN_to_fmpz<N>(sum.value);
+
+    // The wrapped sum is less than 2^N, so the carry is added by setting bit N
+    if(sum.carry) fmpz_setbit(&result, N);
+
+    return Int::adopt(result);
+}
+
+Int promote_add(const uint256_t& a, const uint256_t& b) {
+    return promote_add_x(a, b);
+}
+
+Int promote_add(const uint512_t& a, const uint512_t& b) {
+    return promote_add_x(a, b);
+}
+
+Int promote_mul(const uint256_t& a, const uint256_t& b) {
+    return u512_to_int(intx::umul(a, b));
+}
+
+Int promote_mul(const uint512_t& a, const uint512_t& b) {
+    uint512_t product;
+    if(!ckd_mul_x(&product, a, b)) return u512_to_int(product);
+
+    fmpz result = 0;
+    mpz_mul(_fmpz_promote(&result), mpz_view(a).get(), mpz_view(b).get());
+    return Int::adopt(result);
+}
+
+template<unsigned N>
+static Int promote_pow_x(const intx::uint<N>& base, size_t power) {
+    intx::uint<N> val;
+    if(!ckd_pow_x(&val, base, power)) return Int::adopt(uintN_to_fmpz<N>(val));
+
+    fmpz result = 0;
+    mpz_pow_ui(_fmpz_promote(&result), mpz_view(base).get(), power);
+    return Int::adopt(result);
+}
+
+Int promote_pow(const uint256_t& base, size_t power) {
+    return promote_pow_x(base, power);
+}
+
+Int promote_pow(const uint512_t& base, size_t power) {
+    return promote_pow_x(base, power);
+}
+
+}  // namespace KiCAS2
@@ -0,0 +1,96 @@
+#include <catch2/catch_test_macros.hpp>
+#include <catch2/benchmark/catch_benchmark.hpp>
+
+#include "ki_cas_big_num_expr.h"
+
+#include "ki_cas_allocation_tracker.h"
+#include "ki_cas_kmpz.h"
+#include <iostream>
+#include <random>
+#include <vector>
+
+using namespace KiCAS2;
+
+/// Coefficients of 2 to 4 limbs
+static std::vector<Int> big_coefficients(uint64_t seed) {
+    std::mt19937_64 generator(seed);
+
+    std::vector<Int> coefficients;
+    for(size_t i = 0; i < 1000; i++){
+        const uint256_t val(generator(), generator(), generator() % 1000, 0);
+        coefficients.push_back(u256_to_int(val));
+    }
+
+    return coefficients;
+}
+
+/// out[i] = a[i]*b[i] + c[i]*d[i] with a temporary for each product
+static void update_with_temporaries(std::vector<Int>& out, const std::vector<Int>& a, const std::vector<Int>& b,
+                                    const std::vector<Int>& c, const std::vector<Int>& d) {
+    for(size_t i = 0; i < out.size(); i++){
+        fmpz ab = 0;
+        fmpz cd = 0;
+        fmpz_mul(&ab, a[i].get(), b[i].get());
+        fmpz_mul(&cd, c[i].get(), d[i].get());
+        fmpz_add(out[i].get(), &ab, &cd);
+        fmpz_clear(&ab);
+        fmpz_clear(&cd);
+    }
+}
+
+static void update_fused(std::vector<Int>& out, const std::vector<Int>& a, const std::vector<Int>& b,
+                         const std::vector<Int>& c, const std::vector<Int>& d) {
+    for(size_t i = 0; i < out.size(); i++) out[i] = a[i]*b[i] + c[i]*d[i];
+}
+
+/// Sum of a[i]*b[i] with a temporary for each product
+static void dot_with_temporaries(Int& sum, const std::vector<Int>& a, const std::vector<Int>& b) {
+    for(size_t i = 0; i < a.size(); i++){
+        fmpz ab = 0;
+        fmpz_mul(&ab, a[i].get(), b[i].get());
+        fmpz_add(sum.get(), sum.get(), &ab);
+        fmpz_clear(&ab);
+    }
+}
+
+static void dot_fused(Int& sum, const std::vector<Int>& a, const std::vector<Int>& b) {
+    for(size_t i = 0; i < a.size(); i++) sum += a[i]*b[i];
+}
+
+TEST_CASE("Int expressions (1000 coefficients of 2-4 limbs)") {
+    NumericAllocatorScope allocator_scope;
+    install_allocation_tracker();
+    const std::vector<Int> a = big_coefficients(1), b = big_coefficients(2), c = big_coefficients(3), d = big_coefficients(4);
+    std::vector<Int> out = big_coefficients(5);
+
+    const AllocationStats before = allocation_stats();
+    update_with_temporaries(out, a, b, c, d);
+    const AllocationStats temporaries = allocation_stats();
+    update_fused(out, a, b, c, d);
+    const AllocationStats fused = allocation_stats();
+
+    std::cout << "GMP allocations per update with temporaries: "
+              << (temporaries.num_allocations + temporaries.num_reallocations
+                  - before.num_allocations - before.num_reallocations) / double(out.size())
+              << ", fused: "
+              << (fused.num_allocations + fused.num_reallocations
+                  - temporaries.num_allocations - temporaries.num_reallocations) / double(out.size()) << std::endl;
+
+    BENCHMARK_ADVANCED( "a*b + c*d (temporaries)" )(Catch::Benchmark::Chronometer meter) {
+        meter.measure([&](){ update_with_temporaries(out, a, b, c, d); });
+    };
+
+    BENCHMARK_ADVANCED( "a*b + c*d (fmpz_fmma)" )(Catch::Benchmark::Chronometer meter) {
+        meter.measure([&](){ update_fused(out, a, b, c, d); });
+    };
+
+    BENCHMARK_ADVANCED( "sum += a*b (temporaries)" )(Catch::Benchmark::Chronometer meter) {
+        Int sum;
+        meter.measure([&](){ dot_with_temporaries(sum, a, b); });
+    };
+
+    BENCHMARK_ADVANCED( "sum += a*b (fmpz_addmul)" )(Catch::Benchmark::Chronometer meter) {
+        Int sum;
+        meter.measure([&](){ dot_fused(sum, a, b); });
+    };
+}
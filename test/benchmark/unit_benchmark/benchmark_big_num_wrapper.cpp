@@ -55,6 +55,22 @@ TEST_CASE("fmpz_init_set_strview (Flint word size x2)") {
     };
 }
 
+TEST_CASE("fmpz_init_set_strview (30 digits)") {
+    const std::string_view str = "123456789012345678901234567890";
+
+    BENCHMARK_ADVANCED( "fmpz_init_set_strview" )(Catch::Benchmark::Chronometer meter) {
+        fmpz_t big_int;
+        meter.measure([&](){fmpz_init_set_strview(big_int, str);});
+        fmpz_clear(big_int);
+    };
+
+    BENCHMARK_ADVANCED( "fmpz_set_str" )(Catch::Benchmark::Chronometer meter) {
+        fmpz_t big_int;
+        meter.measure([&](){fmpz_init(big_int); std::string copy(str); fmpz_set_str(big_int, copy.c_str(), 10);});
+        fmpz_clear(big_int);
+    };
+}
+
 TEST_CASE("fmpz_init_set_strview (Flint word size x3)") {
     const std::string src = std::to_string(std::numeric_limits<size_t>::max())
                           + std::to_string(std::numeric_limits<size_t>::max())
@@ -74,6 +90,23 @@ TEST_CASE("fmpz_init_set_strview (Flint word size x3)") {
     };
 }
 
+TEST_CASE("fmpz_init_set_strview (77 digits)") {
+    const std::string src(77, '9');
+    const std::string_view str(src);
+
+    BENCHMARK_ADVANCED( "fmpz_init_set_strview" )(Catch::Benchmark::Chronometer meter) {
+        fmpz_t big_int;
+        meter.measure([&](){fmpz_init_set_strview(big_int, str);});
+        fmpz_clear(big_int);
+    };
+
+    BENCHMARK_ADVANCED( "fmpz_set_str" )(Catch::Benchmark::Chronometer meter) {
+        fmpz_t big_int;
+        meter.measure([&](){fmpz_init(big_int); std::string copy(str); fmpz_set_str(big_int, copy.c_str(), 10);});
+        fmpz_clear(big_int);
+    };
+}
+
 TEST_CASE("mpz_init_set_strview (tiny)") {
     const std::string_view str = "1337";
 
@@ -124,6 +157,22 @@ TEST_CASE("mpz_init_set_strview (Flint word size x2)") {
     };
 }
 
+TEST_CASE("mpz_init_set_strview (30 digits)") {
+    const std::string_view str = "123456789012345678901234567890";
+
+    BENCHMARK_ADVANCED( "mpz_init_set_strview" )(Catch::Benchmark::Chronometer meter) {
+        mpz_t big_int;
+        meter.measure([&](){mpz_init_set_strview(big_int, str);});
+        mpz_clear(big_int);
+    };
+
+    BENCHMARK_ADVANCED( "mpz_set_str" )(Catch::Benchmark::Chronometer meter) {
+        mpz_t big_int;
+        meter.measure([&](){mpz_init(big_int); std::string copy(str); mpz_set_str(big_int, copy.c_str(), 10);});
+        mpz_clear(big_int);
+    };
+}
+
 TEST_CASE("mpz_init_set_strview (Flint word size x3)") {
     const std::string src = std::to_string(std::numeric_limits<size_t>::max())
                           + std::to_string(std::numeric_limits<size_t>::max())
@@ -0,0 +1,75 @@
+#include <catch2/catch_test_macros.hpp>
+#include <catch2/benchmark/catch_benchmark.hpp>
+
+#include "ki_cas_binary_format.h"
+
+#include "ki_cas_big_num_owner.h"
+#include "ki_cas_big_num_wrapper.h"
+#include <iostream>
+#include <random>
+#include <string>
+#include <vector>
+
+using namespace KiCAS2;
+
+/// Scientific strings with 20 to 150 significant digits, as stored in snapshots
+static std::vector<std::string> scientific_strings() {
+    std::mt19937 generator(42);
+    std::uniform_int_distribution<int> digits(0, 9);
+    std::uniform_int_distribution<int> lengths(20, 150);
+    std::uniform_int_distribution<int> exponents(-40, 40);
+
+    std::vector<std::string> strings;
+    for(size_t i = 0; i < 1000; i++){
+        std::string str(1, static_cast<char>('1' + digits(generator) % 9));
+        str += '.';
+        const int length = lengths(generator);
+        for(int j = 1; j < length; j++) str += static_cast<char>('0' + digits(generator));
+        str += 'e';
+        str += std::to_string(exponents(generator));
+        strings.push_back(str);
+    }
+
+    return strings;
+}
+
+TEST_CASE("Snapshot load of 1000 rationals (20-150 digits)") {
+    const std::vector<std::string> strings = scientific_strings();
+
+    std::vector<Rat> vals;
+    std::string text;
+    for(const std::string& str : strings){
+        vals.push_back(rat_from_scientific_str(str));
+        text += str;
+        text += '\n';
+    }
+
+    std::string binary;
+    StringSink sink(binary);
+    write_binary_big_rationals(sink, vals.front().get(), vals.size());
+    std::cout << "Text bytes: " << text.size() << ", binary bytes: " << binary.size() << std::endl;
+
+    std::vector<Rat> loaded(vals.size());
+
+    BENCHMARK_ADVANCED( "fmpq_from_scientific_str" )(Catch::Benchmark::Chronometer meter) {
+        meter.measure([&](){
+            for(size_t i = 0; i < strings.size(); i++) loaded[i] = rat_from_scientific_str(strings[i]);
+        });
+    };
+
+    BENCHMARK_ADVANCED( "read_binary_big_rationals" )(Catch::Benchmark::Chronometer meter) {
+        meter.measure([&](){
+            std::string_view bytes = binary;
+            return read_binary_big_rationals(loaded.front().get(), loaded.size(), bytes);
+        });
+    };
+
+    BENCHMARK_ADVANCED( "write_binary_big_rationals" )(Catch::Benchmark::Chronometer meter) {
+        std::string out;
+        meter.measure([&](){
+            out.clear();
+            StringSink out_sink(out);
+            write_binary_big_rationals(out_sink, vals.front().get(), vals.size());
+        });
+    };
+}
@@ -0,0 +1,55 @@
+#include <catch2/catch_test_macros.hpp>
+#include <catch2/benchmark/catch_benchmark.hpp>
+
+#include "ki_cas_constant_table.h"
+
+#include "ki_cas_binary_format.h"
+#include <string>
+#include <vector>
+
+using namespace KiCAS2;
+
+TEST_CASE("Startup with a table of factorials 0! to 2999!") {
+    std::vector<Int> factorials;
+    factorials.emplace_back(1);
+    for(ulong i = 1; i < 3000; i++){
+        Int val;
+        fmpz_mul_ui(val.get(), factorials.back().get(), i);
+        factorials.push_back(std::move(val));
+    }
+
+    std::string binary;
+    StringSink binary_sink(binary);
+    write_binary_big_ints(binary_sink, factorials.front().get(), factorials.size());
+
+    std::string table_bytes;
+    StringSink table_sink(table_bytes);
+    write_constant_table(table_sink, factorials.front().get(), factorials.size());
+
+    std::vector<Int> loaded(factorials.size());
+
+    BENCHMARK_ADVANCED( "read_binary_big_ints" )(Catch::Benchmark::Chronometer meter) {
+        meter.measure([&](){
+            std::string_view bytes = binary;
+            return read_binary_big_ints(loaded.front().get(), loaded.size(), bytes);
+        });
+    };
+
+    BENCHMARK_ADVANCED( "ConstantTable::view" )(Catch::Benchmark::Chronometer meter) {
+        ConstantTable table;
+        meter.measure([&](){ return table.view(table_bytes); });
+    };
+
+    BENCHMARK_ADVANCED( "ConstantTable::entry of every factorial" )(Catch::Benchmark::Chronometer meter) {
+        ConstantTable table;
+        table.view(table_bytes);
+        meter.measure([&](){
+            size_t num_limbs = 0;
+            for(size_t i = 0; i < table.size(); i++){
+                const MP_INT entry = table.entry(i);
+                num_limbs += mpz_size(&entry);
+            }
+            return num_limbs;
+        });
+    };
+}
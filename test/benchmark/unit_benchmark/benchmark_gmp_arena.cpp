@@ -0,0 +1,91 @@
+#include <catch2/catch_test_macros.hpp>
+#include <catch2/benchmark/catch_benchmark.hpp>
+
+#include "ki_cas_gmp_arena.h"
+
+#include "ki_cas_big_num_wrapper.h"
+#include "ki_cas_numeric_allocator.h"
+#include <iostream>
+#include <random>
+#include <string>
+#include <thread>
+#include <vector>
+
+using namespace KiCAS2;
+
+static constexpr size_t NUM_THREADS = 4;
+
+/// Literals too large for the native fast path, so every parse allocates temporaries
+static std::vector<std::string> big_literals() {
+    std::mt19937 generator(42);
+    std::uniform_int_distribution<int> digits(0, 9);
+    std::uniform_int_distribution<int> lengths(25, 60);
+    std::uniform_int_distribution<int> exponents(-40, 40);
+
+    std::vector<std::string> literals;
+    for(size_t i = 0; i < 100; i++){
+        std::string str;
+        const int length = lengths(generator);
+        for(int j = 0; j < length; j++) str += static_cast<char>('1' + digits(generator) % 9);
+        str.insert(str.size() / 3, ".");
+        str += 'e' + std::to_string(exponents(generator));
+        literals.push_back(str);
+    }
+
+    return literals;
+}
+
+static void parse_all(const std::vector<std::string>& literals, bool use_arena) {
+    for(const std::string& str : literals){
+        fmpq val;
+        if(use_arena){
+            GmpArenaScope scope;
+            val = fmpq_from_scientific_str(str);
+        }else{
+            val = fmpq_from_scientific_str(str);
+        }
+        fmpq_clear(&val);
+    }
+}
+
+static void parse_all_threaded(const std::vector<std::string>& literals, bool use_arena) {
+    std::vector<std::thread> threads;
+    for(size_t i = 0; i < NUM_THREADS; i++)
+        threads.emplace_back([&literals, use_arena](){ for(size_t j = 0; j < 10; j++) parse_all(literals, use_arena); });
+    for(std::thread& thread : threads) thread.join();
+}
+
+TEST_CASE("fmpq_from_scientific_str in a GmpArenaScope (100 big literals)") {
+    NumericAllocatorScope allocator_scope;
+    install_gmp_arena();
+    const std::vector<std::string> literals = big_literals();
+
+    const GmpArenaStats before = gmp_arena_stats();
+    parse_all(literals, false);
+    const GmpArenaStats heap = gmp_arena_stats();
+    parse_all(literals, true);
+    const GmpArenaStats arena = gmp_arena_stats();
+
+    std::cout << "Heap allocations per parse without arena: "
+              << (heap.heap_allocations - before.heap_allocations) / double(literals.size()) << std::endl;
+    std::cout << "Heap allocations per parse with arena: "
+              << (arena.heap_allocations - heap.heap_allocations) / double(literals.size())
+              << " (" << (arena.arena_allocations - heap.arena_allocations) / double(literals.size())
+              << " from the arena)" << std::endl;
+
+    BENCHMARK_ADVANCED( "fmpq_from_scientific_str" )(Catch::Benchmark::Chronometer meter) {
+        meter.measure([&](){ parse_all(literals, false); });
+    };
+
+    BENCHMARK_ADVANCED( "fmpq_from_scientific_str (GmpArenaScope)" )(Catch::Benchmark::Chronometer meter) {
+        meter.measure([&](){ parse_all(literals, true); });
+    };
+
+    BENCHMARK_ADVANCED( "fmpq_from_scientific_str (4 threads)" )(Catch::Benchmark::Chronometer meter) {
+        meter.measure([&](){ parse_all_threaded(literals, false); });
+    };
+
+    BENCHMARK_ADVANCED( "fmpq_from_scientific_str (4 threads, GmpArenaScope)" )(Catch::Benchmark::Chronometer meter) {
+        meter.measure([&](){ parse_all_threaded(literals, true); });
+    };
+}
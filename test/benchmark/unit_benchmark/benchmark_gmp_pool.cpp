@@ -0,0 +1,63 @@
+#include <catch2/catch_test_macros.hpp>
+#include <catch2/benchmark/catch_benchmark.hpp>
+
+#include "ki_cas_gmp_pool.h"
+
+#include "ki_cas_big_num_wrapper.h"
+#include "ki_cas_numeric_allocator.h"
+#include <iostream>
+#include <random>
+#include <string>
+#include <vector>
+
+using namespace KiCAS2;
+
+/// Integers of 20 to 150 digits, which promote to Flint integers of 2 to 8 limbs
+static std::vector<std::string> big_integers() {
+    std::mt19937 generator(42);
+    std::uniform_int_distribution<int> digits(0, 9);
+    std::uniform_int_distribution<int> lengths(20, 150);
+
+    std::vector<std::string> integers;
+    for(size_t i = 0; i < 1000; i++){
+        std::string str(1, static_cast<char>('1' + digits(generator) % 9));
+        const int length = lengths(generator);
+        for(int j = 1; j < length; j++) str += static_cast<char>('0' + digits(generator));
+        integers.push_back(str);
+    }
+
+    return integers;
+}
+
+static void churn(const std::vector<std::string>& integers) {
+    for(const std::string& str : integers){
+        fmpz val = fmpz_from_strview(str);
+        fmpz_clear(&val);
+    }
+}
+
+TEST_CASE("fmpz_from_strview churn with GmpPool (1000 integers of 20-150 digits)") {
+    NumericAllocatorScope allocator_scope;
+    REQUIRE_FALSE(install_gmp_pool());
+    const std::vector<std::string> integers = big_integers();
+
+    churn(integers);
+    const GmpPoolStats before = gmp_pool_stats();
+    churn(integers);
+    const GmpPoolStats after = gmp_pool_stats();
+
+    std::cout << "Pool hits per parse: "
+              << (after.thread_hits + after.reclaim_hits - before.thread_hits - before.reclaim_hits) / double(integers.size())
+              << ", misses per parse: " << (after.misses - before.misses) / double(integers.size())
+              << ", unpooled per parse: " << (after.unpooled - before.unpooled) / double(integers.size())
+              << ", lifetime hit rate: " << after.hitRate() << std::endl;
+
+    BENCHMARK_ADVANCED( "fmpz_from_strview (GmpPoolBypass)" )(Catch::Benchmark::Chronometer meter) {
+        GmpPoolBypass bypass;
+        meter.measure([&](){ churn(integers); });
+    };
+
+    BENCHMARK_ADVANCED( "fmpz_from_strview (GmpPool)" )(Catch::Benchmark::Chronometer meter) {
+        meter.measure([&](){ churn(integers); });
+    };
+}
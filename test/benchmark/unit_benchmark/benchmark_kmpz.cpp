@@ -0,0 +1,70 @@
+#include <catch2/catch_test_macros.hpp>
+#include <catch2/benchmark/catch_benchmark.hpp>
+
+#include "ki_cas_kmpz.h"
+
+#include <random>
+#include <vector>
+
+using namespace KiCAS2;
+
+/// 1000 values of 129 to 256 bits
+static std::vector<uint256_t> random_uint256s() {
+    std::mt19937_64 generator(42);
+    std::vector<uint256_t> vals;
+    for(size_t i = 0; i < 1000; i++){
+        const uint256_t val(generator(), generator(), generator(), generator());
+        vals.push_back((val >> (generator() % 128)) | (uint256_t(1) << 128));
+    }
+
+    return vals;
+}
+
+TEST_CASE("Reading 1000 uint256 values with GMP") {
+    const std::vector<uint256_t> vals = random_uint256s();
+
+    BENCHMARK_ADVANCED( "mpz_init_set_uint256" )(Catch::Benchmark::Chronometer meter) {
+        meter.measure([&](){
+            unsigned long sum = 0;
+            for(const uint256_t& val : vals){
+                mpz_t z;
+                mpz_init_set_uint256(z, val);
+                sum += mpz_fdiv_ui(z, 1000003);
+                mpz_clear(z);
+            }
+            return sum;
+        });
+    };
+
+    BENCHMARK_ADVANCED( "mpz_view" )(Catch::Benchmark::Chronometer meter) {
+        meter.measure([&](){
+            unsigned long sum = 0;
+            for(const uint256_t& val : vals) sum += mpz_fdiv_ui(mpz_view(val).get(), 1000003);
+            return sum;
+        });
+    };
+
+    BENCHMARK_ADVANCED( "mpz_init_set_uint256 compare" )(Catch::Benchmark::Chronometer meter) {
+        meter.measure([&](){
+            int count = 0;
+            for(size_t i = 1; i < vals.size(); i++){
+                mpz_t lhs, rhs;
+                mpz_init_set_uint256(lhs, vals[i-1]);
+                mpz_init_set_uint256(rhs, vals[i]);
+                count += mpz_cmp(lhs, rhs) < 0;
+                mpz_clear(lhs);
+                mpz_clear(rhs);
+            }
+            return count;
+        });
+    };
+
+    BENCHMARK_ADVANCED( "mpz_view compare" )(Catch::Benchmark::Chronometer meter) {
+        meter.measure([&](){
+            int count = 0;
+            for(size_t i = 1; i < vals.size(); i++)
+                count += mpz_cmp(mpz_view(vals[i-1]).get(), mpz_view(vals[i]).get()) < 0;
+            return count;
+        });
+    };
+}
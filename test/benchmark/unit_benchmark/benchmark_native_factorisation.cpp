@@ -0,0 +1,84 @@
+#include <catch2/catch_test_macros.hpp>
+#include <catch2/benchmark/catch_benchmark.hpp>
+
+#include "ki_cas_native_factorisation.h"
+
+#include <flint/ulong_extras.h>
+#include <random>
+#include <vector>
+
+using namespace KiCAS2;
+
+TEST_CASE("square_free_part (1000 small values)") {
+    std::mt19937_64 generator(42);
+    std::vector<size_t> args;
+    for(size_t i = 0; i < 1000; i++) args.push_back(static_cast<size_t>(generator() % 100000) + 1);
+
+    BENCHMARK_ADVANCED( "square_free_part" )(Catch::Benchmark::Chronometer meter) {
+        meter.measure([&](){
+            size_t total = 0;
+            for(const size_t n : args){
+                size_t k;
+                total += square_free_part(n, &k);
+            }
+            return total;
+        });
+    };
+
+    BENCHMARK_ADVANCED( "n_factor" )(Catch::Benchmark::Chronometer meter) {
+        meter.measure([&](){
+            size_t total = 0;
+            for(const size_t n : args){
+                n_factor_t factors;
+                n_factor_init(&factors);
+                n_factor(&factors, n, 1);
+                total += static_cast<size_t>(factors.num);
+            }
+            return total;
+        });
+    };
+}
+
+TEST_CASE("factorise (1000 values up to 50 bits)") {
+    std::mt19937_64 generator(42);
+    std::vector<size_t> args;
+    for(size_t i = 0; i < 1000; i++) args.push_back(static_cast<size_t>(generator() >> (14 + generator() % 8)));
+
+    BENCHMARK_ADVANCED( "factorise (uncached)" )(Catch::Benchmark::Chronometer meter) {
+        meter.measure([&](){
+            clear_native_factor_cache();
+            size_t total = 0;
+            for(const size_t n : args){
+                NativeFactorisation factors;
+                factorise(&factors, n);
+                total += factors.num_factors;
+            }
+            return total;
+        });
+    };
+
+    BENCHMARK_ADVANCED( "factorise (cached)" )(Catch::Benchmark::Chronometer meter) {
+        meter.measure([&](){
+            size_t total = 0;
+            for(const size_t n : args){
+                NativeFactorisation factors;
+                factorise(&factors, n);
+                total += factors.num_factors;
+            }
+            return total;
+        });
+    };
+
+    BENCHMARK_ADVANCED( "n_factor" )(Catch::Benchmark::Chronometer meter) {
+        meter.measure([&](){
+            size_t total = 0;
+            for(const size_t n : args){
+                n_factor_t factors;
+                n_factor_init(&factors);
+                n_factor(&factors, n, 1);
+                total += static_cast<size_t>(factors.num);
+            }
+            return total;
+        });
+    };
+}
@@ -0,0 +1,157 @@
+#include <catch2/catch_test_macros.hpp>
+#include <catch2/benchmark/catch_benchmark.hpp>
+
+#include "ki_cas_native_float.h"
+
+#include <charconv>
+#include <iostream>
+#include <limits>
+#include <random>
+#include <vector>
+
+using namespace KiCAS2;
+
+static std::vector<FloatingPoint> typical_values() {
+    std::mt19937 generator(42);
+    std::uniform_int_distribution<int> integers(-100000, 100000);
+    std::uniform_real_distribution<double> reals(-1e6, 1e6);
+
+    std::vector<FloatingPoint> values;
+    for(size_t i = 0; i < 1000; i++){
+        switch(i % 3){
+            case 0: values.push_back(integers(generator)); break;
+            case 1: values.push_back(integers(generator) / FloatingPoint(100)); break;
+            case 2: values.push_back(reals(generator)); break;
+        }
+    }
+
+    return values;
+}
+
+TEST_CASE("write_float round-trip (1000 values)") {
+    const std::vector<FloatingPoint> values = typical_values();
+    const FloatFormat round_trip_precision{std::numeric_limits<FloatingPoint>::max_digits10, FloatStyle::General};
+
+    std::string precision_out;
+    for(const FloatingPoint val : values){ write_float(precision_out, val, round_trip_precision); precision_out += ' '; }
+    std::string shortest_out;
+    for(const FloatingPoint val : values){ write_float_shortest(shortest_out, val); shortest_out += ' '; }
+    std::cout << "Bytes per value with precision " << round_trip_precision.precision << ": "
+              << precision_out.size() / double(values.size()) << std::endl;
+    std::cout << "Bytes per value with shortest: "
+              << shortest_out.size() / double(values.size()) << std::endl;
+
+    BENCHMARK_ADVANCED( "write_float (max_digits10)" )(Catch::Benchmark::Chronometer meter) {
+        std::string str;
+        str.reserve(64 * values.size());
+        meter.measure([&](){
+            str.clear();
+            for(const FloatingPoint val : values) write_float(str, val, round_trip_precision);
+            return str.size();
+        });
+    };
+
+    BENCHMARK_ADVANCED( "std::to_chars (shortest)" )(Catch::Benchmark::Chronometer meter) {
+        std::string str;
+        str.reserve(64 * values.size());
+        meter.measure([&](){
+            str.clear();
+            char buffer[64];
+            for(const FloatingPoint val : values){
+                const auto result = std::to_chars(buffer, buffer + sizeof(buffer), val);
+                str.append(buffer, result.ptr);
+            }
+            return str.size();
+        });
+    };
+
+    BENCHMARK_ADVANCED( "write_float_shortest" )(Catch::Benchmark::Chronometer meter) {
+        std::string str;
+        str.reserve(64 * values.size());
+        meter.measure([&](){
+            str.clear();
+            for(const FloatingPoint val : values) write_float_shortest(str, val);
+            return str.size();
+        });
+    };
+}
+
+TEST_CASE("write_float_shortest (double)") {
+    const std::vector<FloatingPoint> long_values = typical_values();
+    const std::vector<double> values(long_values.begin(), long_values.end());
+
+    BENCHMARK_ADVANCED( "std::to_chars (shortest)" )(Catch::Benchmark::Chronometer meter) {
+        std::string str;
+        str.reserve(64 * values.size());
+        meter.measure([&](){
+            str.clear();
+            char buffer[64];
+            for(const double val : values){
+                const auto result = std::to_chars(buffer, buffer + sizeof(buffer), val);
+                str.append(buffer, result.ptr);
+            }
+            return str.size();
+        });
+    };
+
+    BENCHMARK_ADVANCED( "write_float_shortest" )(Catch::Benchmark::Chronometer meter) {
+        std::string str;
+        str.reserve(64 * values.size());
+        meter.measure([&](){
+            str.clear();
+            for(const double val : values) write_float_shortest(str, val);
+            return str.size();
+        });
+    };
+}
+
+TEST_CASE("strscientific2double (1000 values)") {
+    const std::vector<FloatingPoint> long_values = typical_values();
+
+    std::vector<std::string> strings;
+    for(const FloatingPoint val : long_values){
+        char buffer[64];
+        const auto result = std::to_chars(buffer, buffer + sizeof(buffer), static_cast<double>(val), std::chars_format::scientific);
+        strings.emplace_back(buffer, result.ptr);
+    }
+
+    BENCHMARK_ADVANCED( "std::from_chars (long double)" )(Catch::Benchmark::Chronometer meter) {
+        meter.measure([&](){
+            long double sum = 0;
+            for(const std::string& str : strings){
+                long double val;
+                std::from_chars(str.data(), str.data() + str.size(), val, std::chars_format::scientific);
+                sum += val;
+            }
+            return sum;
+        });
+    };
+
+    BENCHMARK_ADVANCED( "std::from_chars (double)" )(Catch::Benchmark::Chronometer meter) {
+        meter.measure([&](){
+            double sum = 0;
+            for(const std::string& str : strings){
+                double val;
+                std::from_chars(str.data(), str.data() + str.size(), val, std::chars_format::scientific);
+                sum += val;
+            }
+            return sum;
+        });
+    };
+
+    BENCHMARK_ADVANCED( "strscientific2floatingpoint" )(Catch::Benchmark::Chronometer meter) {
+        meter.measure([&](){
+            FloatingPoint sum = 0;
+            for(const std::string& str : strings) sum += strscientific2floatingpoint(str);
+            return sum;
+        });
+    };
+
+    BENCHMARK_ADVANCED( "strscientific2double" )(Catch::Benchmark::Chronometer meter) {
+        meter.measure([&](){
+            double sum = 0;
+            for(const std::string& str : strings) sum += strscientific2double(str);
+            return sum;
+        });
+    };
+}
@@ -3,6 +3,9 @@
 
 #include "ki_cas_native_integer.h"
 #include "ki_cas_big_num_wrapper.h"
+#include <memory>
+#include <random>
+#include <vector>
 
 using namespace KiCAS2;
 
@@ -58,8 +61,81 @@ TEST_CASE("ckd_nrt") {
     };
 }
 
+TEST_CASE("ckd_sqrt (non-square)") {
+    constexpr size_t arg = 1013 * 1013 + 1;
+
+    BENCHMARK_ADVANCED( "ckd_sqrt" )(Catch::Benchmark::Chronometer meter) {
+        size_t ans;
+        meter.measure([&](){return ckd_sqrt(&ans, arg);});
+    };
+
+    BENCHMARK_ADVANCED( "n_sqrt" )(Catch::Benchmark::Chronometer meter) {
+        size_t ans;
+        meter.measure([&](){ans = n_sqrt(arg); return ans*ans != arg;});
+    };
+}
+
+TEST_CASE("ckd_sqrt (1000 values)") {
+    std::mt19937_64 generator(42);
+    std::vector<size_t> args;
+    for(size_t i = 0; i < 1000; i++) args.push_back(static_cast<size_t>(generator() >> (generator() % 48)));
+    std::vector<size_t> results(args.size());
+    std::unique_ptr<bool[]> is_inexact(new bool[args.size()]);
+
+    BENCHMARK_ADVANCED( "ckd_sqrt (batch)" )(Catch::Benchmark::Chronometer meter) {
+        meter.measure([&](){return ckd_sqrt(results.data(), is_inexact.get(), args.data(), args.size());});
+    };
+
+    BENCHMARK_ADVANCED( "ckd_sqrt" )(Catch::Benchmark::Chronometer meter) {
+        meter.measure([&](){
+            for(size_t i = 0; i < args.size(); i++) is_inexact[i] = ckd_sqrt(&results[i], args[i]);
+        });
+    };
+
+    BENCHMARK_ADVANCED( "ckd_cbrt (batch)" )(Catch::Benchmark::Chronometer meter) {
+        meter.measure([&](){return ckd_cbrt(results.data(), is_inexact.get(), args.data(), args.size());});
+    };
+
+    BENCHMARK_ADVANCED( "ckd_cbrt" )(Catch::Benchmark::Chronometer meter) {
+        meter.measure([&](){
+            for(size_t i = 0; i < args.size(); i++) is_inexact[i] = ckd_cbrt(&results[i], args[i]);
+        });
+    };
+
+    BENCHMARK_ADVANCED( "n_sqrt" )(Catch::Benchmark::Chronometer meter) {
+        meter.measure([&](){
+            for(size_t i = 0; i < args.size(); i++){
+                results[i] = n_sqrt(args[i]);
+                is_inexact[i] = results[i]*results[i] != args[i];
+            }
+        });
+    };
+}
+
+TEST_CASE("is_perfect_power (1000 values)") {
+    std::mt19937_64 generator(42);
+    std::vector<size_t> args;
+    for(size_t i = 0; i < 1000; i++) args.push_back(static_cast<size_t>(generator() >> (generator() % 48)));
+    std::vector<size_t> exponents(args.size());
+    std::vector<size_t> roots(args.size());
+
+    BENCHMARK_ADVANCED( "is_perfect_power" )(Catch::Benchmark::Chronometer meter) {
+        meter.measure([&](){is_perfect_power(exponents.data(), roots.data(), args.data(), args.size());});
+    };
+
+    BENCHMARK_ADVANCED( "n_is_perfect_power" )(Catch::Benchmark::Chronometer meter) {
+        meter.measure([&](){
+            for(size_t i = 0; i < args.size(); i++){
+                ulong root;
+                exponents[i] = n_is_perfect_power(&root, args[i]);
+                roots[i] = root;
+            }
+        });
+    };
+}
+
 TEST_CASE("knownfit_pow") {
-    BENCHMARK_ADVANCED( "ckd_pow_helper" )(Catch::Benchmark::Chronometer meter) {
+    BENCHMARK_ADVANCED( "ckd_pow" )(Catch::Benchmark::Chronometer meter) {
         size_t ans;
         bool overflowed;
         meter.measure([&](){overflowed = ckd_pow(&ans, 7, 11);});
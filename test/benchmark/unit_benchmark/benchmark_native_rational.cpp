@@ -99,3 +99,27 @@ TEST_CASE("delayed normalisation") {
         });
     };
 }
+
+TEST_CASE("ckd_pow (NativeRational)") {
+    const NativeRational base(8, 27);
+
+    BENCHMARK_ADVANCED( "ckd_pow" )(Catch::Benchmark::Chronometer meter) {
+        NativeRational result;
+        meter.measure([&](){return ckd_pow(&result, base, 7);});
+    };
+
+    BENCHMARK_ADVANCED( "ckd_mul (repeated)" )(Catch::Benchmark::Chronometer meter) {
+        NativeRational result;
+        meter.measure([&](){
+            result = base;
+            bool overflowed = false;
+            for(size_t i = 1; i < 7 && !overflowed; i++) overflowed = ckd_mul(&result, result, base);
+            return overflowed;
+        });
+    };
+
+    BENCHMARK_ADVANCED( "ckd_pow (rational exponent)" )(Catch::Benchmark::Chronometer meter) {
+        NativeRational result;
+        meter.measure([&](){return ckd_pow(&result, base, NativeRational(2, 3));});
+    };
+}
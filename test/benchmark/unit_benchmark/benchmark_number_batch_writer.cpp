@@ -0,0 +1,88 @@
+#include <catch2/catch_test_macros.hpp>
+#include <catch2/benchmark/catch_benchmark.hpp>
+
+#include "ki_cas_number_batch_writer.h"
+
+#include "ki_cas_big_num_wrapper.h"
+#include "ki_cas_native_integer.h"
+#include <vector>
+
+using namespace KiCAS2;
+
+TEST_CASE("Write 50k-term sum") {
+    constexpr size_t num_terms = 50'000;
+
+    std::vector<fmpq> coefficients(num_terms);
+    for(size_t i = 0; i < num_terms; i++){
+        fmpq_init(&coefficients[i]);
+        fmpq_set_si(&coefficients[i], (i%2 == 0) ? slong(i+1) : -slong(i+1), 2*i+3);
+        if(i%10 == 0) fmpz_mul_2exp(fmpq_numref(&coefficients[i]), fmpq_numref(&coefficients[i]), 100);
+    }
+
+    BENCHMARK_ADVANCED( "write_big_rational_term" )(Catch::Benchmark::Chronometer meter) {
+        meter.measure([&](){
+            std::string str;
+            write_big_rational(str, coefficients[0]);
+            for(size_t i = 1; i < num_terms; i++){
+                str += " + ";
+                write_big_rational_term(str, coefficients[i]);
+            }
+            return str.size();
+        });
+    };
+
+    BENCHMARK_ADVANCED( "NumberBatchWriter" )(Catch::Benchmark::Chronometer meter) {
+        NumberBatchWriter writer;
+        writer.reserve(num_terms);
+        for(const fmpq& coeff : coefficients) writer.addTerm(&coeff);
+
+        meter.measure([&](){
+            std::string str;
+            writer.write(str);
+            return str.size();
+        });
+    };
+
+    std::string expected;
+    write_big_rational(expected, coefficients[0]);
+    for(size_t i = 1; i < num_terms; i++){
+        expected += " + ";
+        write_big_rational_term(expected, coefficients[i]);
+    }
+
+    NumberBatchWriter writer;
+    for(const fmpq& coeff : coefficients) writer.addTerm(&coeff);
+    std::string str;
+    writer.write(str);
+    REQUIRE(str == expected);
+
+    for(fmpq& coeff : coefficients) fmpq_clear(&coeff);
+}
+
+TEST_CASE("Write 50k native integers") {
+    constexpr size_t num_terms = 50'000;
+
+    BENCHMARK_ADVANCED( "write_native_int" )(Catch::Benchmark::Chronometer meter) {
+        meter.measure([&](){
+            std::string str;
+            write_native_int(str, 0);
+            for(size_t i = 1; i < num_terms; i++){
+                str += " + ";
+                write_native_int(str, i*i);
+            }
+            return str.size();
+        });
+    };
+
+    BENCHMARK_ADVANCED( "NumberBatchWriter" )(Catch::Benchmark::Chronometer meter) {
+        NumberBatchWriter writer;
+        writer.reserve(num_terms);
+        for(size_t i = 0; i < num_terms; i++) writer.addTerm(i*i);
+
+        meter.measure([&](){
+            std::string str;
+            writer.write(str);
+            return str.size();
+        });
+    };
+}
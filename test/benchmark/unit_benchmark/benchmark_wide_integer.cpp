@@ -0,0 +1,43 @@
+#include <catch2/catch_test_macros.hpp>
+#include <catch2/benchmark/catch_benchmark.hpp>
+
+#include "ki_cas_wide_integer.h"
+
+#include "ki_cas_big_num_owner.h"
+#include <random>
+#include <vector>
+
+using namespace KiCAS2;
+
+TEST_CASE("Dot product of 1000 pairs of 100-bit integers") {
+    std::mt19937_64 generator(42);
+    std::vector<uint256_t> lhs, rhs;
+    std::vector<Int> lhs_big, rhs_big;
+    for(size_t i = 0; i < 1000; i++){
+        lhs.push_back(uint256_t(generator(), generator() >> 28));
+        rhs.push_back(uint256_t(generator(), generator() >> 28));
+        lhs_big.push_back(u256_to_int(lhs.back()));
+        rhs_big.push_back(u256_to_int(rhs.back()));
+    }
+
+    BENCHMARK_ADVANCED( "fmpz_addmul" )(Catch::Benchmark::Chronometer meter) {
+        meter.measure([&](){
+            Int sum;
+            for(size_t i = 0; i < lhs_big.size(); i++) fmpz_addmul(sum.get(), lhs_big[i].get(), rhs_big[i].get());
+            return fmpz_size(sum.get());
+        });
+    };
+
+    BENCHMARK_ADVANCED( "uint256_t ckd_mul ckd_add" )(Catch::Benchmark::Chronometer meter) {
+        meter.measure([&](){
+            uint256_t sum = 0;
+            bool overflowed = false;
+            for(size_t i = 0; i < lhs.size(); i++){
+                uint256_t product;
+                overflowed |= ckd_mul(&product, lhs[i], rhs[i]);
+                overflowed |= ckd_add(&sum, sum, product);
+            }
+            return overflowed ? Int() : u256_to_int(sum);
+        });
+    };
+}
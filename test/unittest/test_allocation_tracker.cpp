@@ -0,0 +1,94 @@
+#include <catch2/catch_test_macros.hpp>
+
+#include "ki_cas_allocation_tracker.h"
+
+#include "ki_cas_big_num_wrapper.h"
+#include <numeric>
+#include <thread>
+#include <vector>
+
+using namespace KiCAS2;
+
+static size_t histogram_total(const AllocationStats& stats) {
+    return std::accumulate(stats.size_histogram.begin(), stats.size_histogram.end(), size_t(0));
+}
+
+TEST_CASE( "Allocation tracker counts" ){
+    NumericAllocatorScope allocator_scope;
+    install_allocation_tracker();
+    REQUIRE(is_allocation_tracker_installed());
+
+    const AllocationStats before = allocation_stats();
+
+    mpz_t big;
+    mpz_init_set_str(big, "123456789012345678901234567890123456789012345678901234567890", 10);
+    const AllocationStats allocated = allocation_stats();
+    REQUIRE(allocated.num_allocations + allocated.num_reallocations
+            > before.num_allocations + before.num_reallocations);
+    REQUIRE(allocated.live_bytes > before.live_bytes);
+    REQUIRE(allocated.liveAllocations() == before.liveAllocations() + 1);
+    REQUIRE(histogram_total(allocated) - histogram_total(before)
+            == (allocated.num_allocations - before.num_allocations)
+             + (allocated.num_reallocations - before.num_reallocations));
+
+    mpz_clear(big);
+    const AllocationStats freed = allocation_stats();
+    REQUIRE(freed.live_bytes == before.live_bytes);
+    REQUIRE(freed.liveAllocations() == before.liveAllocations());
+    REQUIRE(freed.num_frees == before.num_frees + 1);
+
+    SECTION("Peak"){
+        static constexpr size_t LARGE_BYTES = 1 << 20;
+        mpz_t large;
+        mpz_init2(large, 8*LARGE_BYTES);
+        mpz_clear(large);
+
+        const AllocationStats after = allocation_stats();
+        REQUIRE(after.peak_bytes >= before.live_bytes + static_cast<int64_t>(LARGE_BYTES));
+        REQUIRE(after.live_bytes == before.live_bytes);
+    }
+
+    LEAK_CHECK_REQUIRE(isAllGmpMemoryFreed_resetIfNot());
+}
+
+TEST_CASE( "Allocation tracker threads" ){
+    NumericAllocatorScope allocator_scope;
+    install_allocation_tracker();
+
+    static constexpr size_t NUM_THREADS = 4;
+    static constexpr size_t NUM_ITERATIONS = 1000;
+
+    const AllocationStats before = allocation_stats();
+
+    // Values allocated on one thread and freed on another
+    std::vector<__mpz_struct> handoff(NUM_THREADS*NUM_ITERATIONS);
+
+    std::vector<std::thread> threads;
+    for(size_t i = 0; i < NUM_THREADS; i++){
+        threads.emplace_back([&handoff, i](){
+            for(size_t j = 0; j < NUM_ITERATIONS; j++){
+                mpz_t val;
+                mpz_init(val);
+                mpz_ui_pow_ui(val, 3, 100 + j % 50);
+                mpz_clear(val);
+
+                mpz_init(&handoff[i*NUM_ITERATIONS + j]);
+                mpz_ui_pow_ui(&handoff[i*NUM_ITERATIONS + j], 7, 100);
+            }
+        });
+    }
+    for(std::thread& thread : threads) thread.join();
+
+    const AllocationStats during = allocation_stats();
+    REQUIRE((during.num_allocations + during.num_reallocations) - (before.num_allocations + before.num_reallocations)
+            >= 2*NUM_THREADS*NUM_ITERATIONS);
+    REQUIRE(during.liveAllocations() - before.liveAllocations() == static_cast<int64_t>(NUM_THREADS*NUM_ITERATIONS));
+
+    for(__mpz_struct& val : handoff) mpz_clear(&val);
+
+    const AllocationStats after = allocation_stats();
+    REQUIRE(after.live_bytes == before.live_bytes);
+    REQUIRE(after.liveAllocations() == before.liveAllocations());
+
+    LEAK_CHECK_REQUIRE(isAllGmpMemoryFreed_resetIfNot());
+}
@@ -0,0 +1,115 @@
+#include <catch2/catch_test_macros.hpp>
+
+#include "ki_cas_big_num_expr.h"
+
+#include "ki_cas_big_num_wrapper.h"
+#include <string>
+
+using namespace KiCAS2;
+
+static std::string to_string(const Int& val) {
+    std::string str;
+    write_big_int(str, val.get());
+    return str;
+}
+
+static std::string to_string(const Rat& val) {
+    std::string str;
+    write_big_rational(str, val.get());
+    return str;
+}
+
+TEST_CASE( "Int expressions" ){
+    {
+        const Int a = int_from_strview("123456789012345678901234567890");
+        const Int b = int_from_strview("987654321098765432109876543210");
+        const Int c = int_from_strview("111111111111111111111111111111");
+        const Int d(-7);
+
+        REQUIRE(to_string(Int(a + b)) == "1111111110111111111011111111100");
+        REQUIRE(to_string(Int(a - b)) == "-864197532086419753208641975320");
+        REQUIRE(to_string(Int(a * d)) == "-864197523086419752308641975230");
+        REQUIRE(to_string(Int(a * 3u)) == "370370367037037036703703703670");
+        REQUIRE(to_string(Int(c + a*b)) == "121932631137021795226185032733734034443348574912222374638011");
+        REQUIRE(to_string(Int(a*b + c)) == "121932631137021795226185032733734034443348574912222374638011");
+        REQUIRE(to_string(Int(c - a*b)) == "-121932631137021795226185032733511812221126352690000152415789");
+        REQUIRE(to_string(Int(a*b - c)) == "121932631137021795226185032733511812221126352690000152415789");
+        REQUIRE(to_string(Int(c + a*2u)) == "358024689135802468913580246891");
+        REQUIRE(to_string(Int(a*b + c*d)) == "121932631137021795226185032732845145554459686023333485749123");
+        REQUIRE(to_string(Int(a*b - c*d)) == "121932631137021795226185032734400701110015241578889041304677");
+
+        SECTION("Assignment reuses storage"){
+            Int x = a.clone();
+            const mpz_srcptr storage = COEFF_TO_PTR(*x.get());
+            x = c + b*d;
+            REQUIRE(COEFF_TO_PTR(*x.get()) == storage);
+            REQUIRE(to_string(x) == "-6802469136580246913658024691359");
+            x = a*b + c*d;
+            REQUIRE(COEFF_TO_PTR(*x.get()) == storage);
+        }
+
+        SECTION("Accumulation"){
+            Int x(5);
+            x += a*b;
+            x -= c*d;
+            x += a*4u;
+            x -= a + b;
+            x += c - a*b;
+            x -= a*b - c*d;
+            REQUIRE(to_string(x) == "-121932631137021795226185032734129096175188081085406325255324");
+        }
+
+        SECTION("Destination aliases an operand"){
+            Int x = a.clone();
+            x = x*b + c;
+            REQUIRE(to_string(x) == "121932631137021795226185032733734034443348574912222374638011");
+
+            Int y = b.clone();
+            y = a*y - y;
+            REQUIRE(to_string(y) == "121932631137021795226185032732635269011138698369001386983690");
+
+            Int z = c.clone();
+            z = z + a*b;
+            z += z*d;
+            z -= z + a;
+            REQUIRE(to_string(z) == "-123456789012345678901234567890");
+
+            Int w = a.clone();
+            w += w*w + w*b;
+            w += w - c;
+            REQUIRE(to_string(w) == "274348419780521263953360768592454046706392318248663923182669");
+        }
+    }
+
+    LEAK_CHECK_REQUIRE(isAllGmpMemoryFreed_resetIfNot());
+}
+
+TEST_CASE( "Rat expressions" ){
+    {
+        const Rat a = rat_from_decimal_str("0.25");
+        const Rat b = rat_from_scientific_str("1.5e30");
+        const Rat c = rat_from_decimal_str("1234567890123456789012345.0625", 25);
+        const Int n = int_from_strview("12345678901234567890");
+
+        REQUIRE(to_string(Rat(a + b)) == "6000000000000000000000000000001/4");
+        REQUIRE(to_string(Rat(a - c)) == "-19753086241975308624197517/16");
+        REQUIRE(to_string(Rat(a + n)) == "49382715604938271561/4");
+        REQUIRE(to_string(Rat(n + a)) == "49382715604938271561/4");
+        REQUIRE(to_string(Rat(a - n)) == "-49382715604938271559/4");
+        REQUIRE(to_string(Rat(a * c)) == "19753086241975308624197521/64");
+        REQUIRE(to_string(Rat(a * n)) == "6172839450617283945/2");
+        REQUIRE(to_string(Rat(c + a*b)) == "6000019753086241975308624197521/16");
+        REQUIRE(to_string(Rat(a*b - c)) == "5999980246913758024691375802479/16");
+
+        SECTION("Accumulation and aliasing"){
+            Rat x = a.clone();
+            x += a*c;
+            x -= x*a;
+            x = x*c + x;
+            x += n*x;
+            REQUIRE(to_string(x) == "14451274539676091694184828675079402042057263287303672969303254955473337/4096");
+        }
+    }
+
+    LEAK_CHECK_REQUIRE(isAllGmpMemoryFreed_resetIfNot());
+}
@@ -0,0 +1,131 @@
+#include <catch2/catch_test_macros.hpp>
+
+#include "ki_cas_big_num_owner.h"
+
+#include "ki_cas_big_num_wrapper.h"
+#include "ki_cas_kmpz.h"
+#include <string>
+#include <type_traits>
+#include <vector>
+
+using namespace KiCAS2;
+
+static_assert(std::is_nothrow_move_constructible_v<Int> && std::is_nothrow_move_assignable_v<Int>);
+static_assert(std::is_nothrow_move_constructible_v<Rat> && std::is_nothrow_move_assignable_v<Rat>);
+static_assert(!std::is_copy_constructible_v<Int> && !std::is_copy_assignable_v<Int>);
+static_assert(!std::is_copy_constructible_v<Rat> && !std::is_copy_assignable_v<Rat>);
+
+static std::string to_string(const Int& val) {
+    std::string str;
+    write_big_int(str, val.get());
+    return str;
+}
+
+static std::string to_string(const Rat& val) {
+    std::string str;
+    write_big_rational(str, val.get());
+    return str;
+}
+
+TEST_CASE( "Int" ){
+    SECTION("Small values stay in the word"){
+        Int val(-42);
+        REQUIRE(val.isSmall());
+        REQUIRE(to_string(val) == "-42");
+
+        Int min(COEFF_MIN);
+        REQUIRE(min.isSmall());
+        Int below_min(COEFF_MIN - 1);
+        REQUIRE_FALSE(below_min.isSmall());
+        REQUIRE(fmpz_cmp_si(below_min.get(), COEFF_MIN - 1) == 0);
+    }
+
+    SECTION("Moves transfer ownership"){
+        Int big = int_from_strview("123456789012345678901234567890");
+        REQUIRE_FALSE(big.isSmall());
+        const mpz_srcptr limbs_owner = COEFF_TO_PTR(*big.get());
+
+        Int moved(std::move(big));
+        REQUIRE(fmpz_is_zero(big.get()));
+        REQUIRE(COEFF_TO_PTR(*moved.get()) == limbs_owner);
+
+        Int assigned(7);
+        assigned = std::move(moved);
+        REQUIRE(to_string(assigned) == "123456789012345678901234567890");
+        REQUIRE(COEFF_TO_PTR(*assigned.get()) == limbs_owner);
+        REQUIRE(fmpz_is_zero(moved.get()));
+
+        // Assigning over a big value clears it rather than handing it to the source
+        Int overwritten = int_from_strview("987654321098765432109876543210");
+        overwritten = std::move(assigned);
+        REQUIRE(to_string(overwritten) == "123456789012345678901234567890");
+        REQUIRE(fmpz_is_zero(assigned.get()));
+        assigned = std::move(overwritten);
+
+        Int copy = assigned.clone();
+        REQUIRE(fmpz_equal(copy.get(), assigned.get()));
+        REQUIRE(COEFF_TO_PTR(*copy.get()) != limbs_owner);
+    }
+
+    SECTION("Release and adopt"){
+        Int val = int_from_scientific_str("3e25");
+        fmpz raw = val.release();
+        REQUIRE(fmpz_is_zero(val.get()));
+        Int adopted = Int::adopt(raw);
+        REQUIRE(to_string(adopted) == "30000000000000000000000000");
+    }
+
+    SECTION("Containers relocate without copying limbs"){
+        std::vector<Int> vals;
+        std::vector<mpz_srcptr> limbs_owners;
+        for(size_t i = 0; i < 100; i++){
+            vals.push_back(u128_to_int(uint128_t(i+1) << 100));
+            limbs_owners.push_back(COEFF_TO_PTR(*vals.back().get()));
+        }
+        vals.push_back(u256_to_int<true>(uint256_t(1) << 200));
+        REQUIRE(fmpz_sgn(vals.back().get()) == -1);
+        vals.pop_back();
+
+        for(size_t i = 0; i < vals.size(); i++){
+            REQUIRE(COEFF_TO_PTR(*vals[i].get()) == limbs_owners[i]);
+            REQUIRE(fmpz_equal(vals[i].get(), u128_to_int(uint128_t(i+1) << 100).get()));
+        }
+    }
+
+    LEAK_CHECK_REQUIRE(isAllGmpMemoryFreed_resetIfNot());
+}
+
+TEST_CASE( "Rat" ){
+    // Owners are cleared at the end of the block, before checking for leaks
+    {
+        Rat val = rat_from_decimal_str("0.25");
+        REQUIRE(val.isSmall());
+        REQUIRE(to_string(val) == "1/4");
+
+        Rat big = rat_from_scientific_str("1.2345678901234567890123456789e-30");
+        REQUIRE_FALSE(big.isSmall());
+        Rat moved(std::move(val));
+        REQUIRE(fmpz_cmp_ui(moved.denominator(), 4) == 0);
+        REQUIRE(fmpz_is_zero(val.numerator()));
+        REQUIRE(fmpz_is_one(val.denominator()));
+
+        Rat overwritten = big.clone();
+        overwritten = std::move(moved);
+        REQUIRE(to_string(overwritten) == "1/4");
+        REQUIRE(fmpz_is_zero(moved.numerator()));
+        REQUIRE(fmpz_is_one(moved.denominator()));
+
+        val = big.clone();
+        REQUIRE(fmpq_equal(val.get(), big.get()));
+
+        std::vector<Rat> vals;
+        for(size_t i = 0; i < 20; i++) vals.push_back(rat_from_decimal_str("1234567890123456789012345.0625", 25));
+        for(const Rat& v : vals) REQUIRE(to_string(v) == "19753086241975308624197521/16");
+
+        fmpq raw = vals.back().release();
+        REQUIRE(fmpq_is_zero(vals.back().get()));
+        fmpq_clear(&raw);
+    }
+
+    LEAK_CHECK_REQUIRE(isAllGmpMemoryFreed_resetIfNot());
+}
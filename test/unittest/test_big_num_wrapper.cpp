@@ -149,6 +149,96 @@ TEST_CASE( "fmpq_abs_inplace" ) {
     LEAK_CHECK_REQUIRE(isAllGmpMemoryFreed_resetIfNot());
 }
 
+TEST_CASE( "fmpq_pow_ui" ) {
+    {
+        std::string str;
+        Rat val;
+
+        const Rat neg_two_thirds = Rat::adopt({-2, 3});
+        fmpq_pow_ui(val.get(), neg_two_thirds.get(), 3);
+        write_big_rational(str, val.get());
+        REQUIRE(str == "-8/27");
+
+        fmpq_pow_ui(val.get(), neg_two_thirds.get(), 0);
+        REQUIRE(fmpq_is_one(val.get()));
+
+        // Results which do not fit in words fall back to Flint, and agree with it at the boundary
+        for(const slong base : {slong(1) << (sizeof(size_t)*4), (slong(1) << (sizeof(size_t)*4)) - 1, slong(-3)}){
+            const Rat rat = Rat::adopt({base, 7});
+            for(ulong power : {1, 2, 3, 22, 23, 100}){
+                Rat expected;
+                fmpq_pow_si(expected.get(), rat.get(), static_cast<slong>(power));
+                fmpq_pow_ui(val.get(), rat.get(), power);
+                REQUIRE(fmpq_equal(val.get(), expected.get()));
+            }
+        }
+
+        fmpq_pow_ui(val.get(), neg_two_thirds.get(), 2);
+        fmpq_pow_ui(val.get(), val.get(), 50);
+        REQUIRE(fmpz_bits(fmpq_numref(val.get())) == 101);
+
+        // Powers beyond the signed range keep their parity
+        const ulong huge_odd_power = (ulong(1) << (sizeof(ulong)*8 - 1)) + 1;
+        const Rat neg_one = Rat::adopt({-1, 1});
+        fmpq_pow_ui(val.get(), neg_one.get(), huge_odd_power);
+        REQUIRE(fmpz_cmp_si(fmpq_numref(val.get()), -1) == 0);
+        REQUIRE(fmpz_is_one(fmpq_denref(val.get())));
+        fmpq_pow_ui(val.get(), neg_one.get(), huge_odd_power - 1);
+        REQUIRE(fmpq_is_one(val.get()));
+    }
+
+    LEAK_CHECK_REQUIRE(isAllGmpMemoryFreed_resetIfNot());
+}
+
+TEST_CASE( "ckd_root (fmpq)" ) {
+    {
+        std::string str;
+        Rat val;
+
+        const Rat eight_27ths = Rat::adopt({8, 27});
+        REQUIRE_FALSE(ckd_root(val.get(), eight_27ths.get(), 3));
+        write_big_rational(str, val.get());
+        REQUIRE(str == "2/3");
+
+        const Rat neg_eight_27ths = Rat::adopt({-8, 27});
+        REQUIRE_FALSE(ckd_root(val.get(), neg_eight_27ths.get(), 3));
+        str.clear();
+        write_big_rational(str, val.get());
+        REQUIRE(str == "-2/3");
+
+        REQUIRE(true == ckd_root(val.get(), neg_eight_27ths.get(), 2));
+        REQUIRE(true == ckd_root(val.get(), eight_27ths.get(), 2));
+        str.clear();
+        write_big_rational(str, val.get());
+        REQUIRE(str == "-2/3");
+
+        // Roots of rationals which do not fit in words are taken by Flint
+        const Rat root = Rat::adopt({-5, 3});
+        Rat big;
+        fmpq_pow_ui(big.get(), root.get(), 45);
+        REQUIRE(!fmpz_fits_si(fmpq_numref(big.get())));
+        REQUIRE_FALSE(ckd_root(val.get(), big.get(), 15));
+        str.clear();
+        write_big_rational(str, val.get());
+        REQUIRE(str == "-125/27");
+        REQUIRE(true == ckd_root(val.get(), big.get(), 2));
+        REQUIRE(true == ckd_root(val.get(), big.get(), 7));
+        REQUIRE(true == ckd_root(val.get(), big.get(), (ulong(1) << (sizeof(ulong)*8 - 1)) + 1));
+
+        REQUIRE_FALSE(ckd_pow(val.get(), eight_27ths.get(), NativeRational(2, 3)));
+        str.clear();
+        write_big_rational(str, val.get());
+        REQUIRE(str == "4/9");
+
+        REQUIRE_FALSE(ckd_pow(val.get(), big.get(), NativeRational(10, 15)));
+        Rat expected;
+        fmpq_pow_ui(expected.get(), root.get(), 30);
+        REQUIRE(fmpq_equal(val.get(), expected.get()));
+    }
+
+    LEAK_CHECK_REQUIRE(isAllGmpMemoryFreed_resetIfNot());
+}
+
 TEST_CASE( "mpz_init_set_strview" ) {
     mpz_t big_int;
 
@@ -177,6 +267,26 @@ TEST_CASE( "mpz_init_set_strview" ) {
     mpz_clear(big_int);
     mpz_clear(factorial_of_30);
     LEAK_CHECK_REQUIRE(isAllGmpMemoryFreed_resetIfNot());
+
+    // Either side of the 38 digits which fit in 128 bits and the 77 digits which fit in 256 bits
+    const std::pair<ulong, std::string_view> factorials[] = {
+        {22, "1124000727777607680000"},
+        {33, "8683317618811886495518194401280000000"},
+        {34, "295232799039604140847618609643520000000"},
+        {50, "30414093201713378043612608166064768844377641568960512000000000000"},
+        {57, "40526919504877216755680601905432322134980384796226602145184481280000000000000"},
+        {60, "8320987112741390144276341183223364380754172606361245952449277696409600000000000000"},
+    };
+    for(const auto& [n, str] : factorials){
+        mpz_t factorial;
+        mpz_init(factorial);
+        mpz_fac_ui(factorial, n);
+        mpz_init_set_strview(big_int, str);
+        REQUIRE(mpz_cmp(big_int, factorial) == 0);
+        mpz_clear(big_int);
+        mpz_clear(factorial);
+    }
+    LEAK_CHECK_REQUIRE(isAllGmpMemoryFreed_resetIfNot());
 }
 
 TEST_CASE( "fmpz_init_set_strview" ) {
@@ -206,6 +316,26 @@ TEST_CASE( "fmpz_init_set_strview" ) {
     fmpz_clear(big_int);
     fmpz_clear(factorial_of_30);
     LEAK_CHECK_REQUIRE(isAllGmpMemoryFreed_resetIfNot());
+
+    // Either side of the 38 digits which fit in 128 bits and the 77 digits which fit in 256 bits
+    const std::pair<ulong, std::string_view> factorials[] = {
+        {22, "1124000727777607680000"},
+        {33, "8683317618811886495518194401280000000"},
+        {34, "295232799039604140847618609643520000000"},
+        {50, "30414093201713378043612608166064768844377641568960512000000000000"},
+        {57, "40526919504877216755680601905432322134980384796226602145184481280000000000000"},
+        {60, "8320987112741390144276341183223364380754172606361245952449277696409600000000000000"},
+    };
+    for(const auto& [n, str] : factorials){
+        fmpz_t factorial;
+        fmpz_init(factorial);
+        fmpz_fac_ui(factorial, n);
+        fmpz_init_set_strview(big_int, str);
+        REQUIRE(fmpz_cmp(big_int, factorial) == 0);
+        fmpz_clear(big_int);
+        fmpz_clear(factorial);
+    }
+    LEAK_CHECK_REQUIRE(isAllGmpMemoryFreed_resetIfNot());
 }
 
 TEST_CASE( "write_big_int (mpz_t)" ) {
@@ -463,6 +593,18 @@ TEST_CASE( "fmpq_from_decimal_str" ) {
     REQUIRE(fmpz_get_ui(fmpq_denref(big_rat)) == 2);
     fmpq_clear(big_rat);
 
+    std::string str;
+    *big_rat = fmpq_from_decimal_str("265252859812191058636308480000000.5");
+    write_big_rational(str, big_rat);
+    REQUIRE(str == "530505719624382117272616960000001/2");
+    fmpq_clear(big_rat);
+
+    str.clear();
+    *big_rat = fmpq_from_decimal_str("0.00000000000000000000000000000000000000001000");
+    write_big_rational(str, big_rat);
+    REQUIRE(str == "1/100000000000000000000000000000000000000000");
+    fmpq_clear(big_rat);
+
     LEAK_CHECK_REQUIRE(isAllGmpMemoryFreed_resetIfNot());
 }
 
@@ -616,5 +758,32 @@ TEST_CASE( "fmpq_from_scientific_str" ){
         fmpq_clear(big_rat);
     }
 
+    SECTION("Big"){
+        std::string str;
+
+        *big_rat = fmpq_from_scientific_str("1.2345678901234567890123456789e5");
+        write_big_rational(str, big_rat);
+        REQUIRE(str == "12345678901234567890123456789/100000000000000000000000");
+        fmpq_clear(big_rat);
+
+        str.clear();
+        *big_rat = fmpq_from_scientific_str("123456789012345678901234567890e-3");
+        write_big_rational(str, big_rat);
+        REQUIRE(str == "12345678901234567890123456789/100");
+        fmpq_clear(big_rat);
+
+        str.clear();
+        *big_rat = fmpq_from_scientific_str("0.5e-30");
+        write_big_rational(str, big_rat);
+        REQUIRE(str == "1/2000000000000000000000000000000");
+        fmpq_clear(big_rat);
+
+        str.clear();
+        *big_rat = fmpq_from_scientific_str("1.5e+25");
+        write_big_rational(str, big_rat);
+        REQUIRE(str == "15000000000000000000000000");
+        fmpq_clear(big_rat);
+    }
+
     LEAK_CHECK_REQUIRE(isAllGmpMemoryFreed_resetIfNot());
 }
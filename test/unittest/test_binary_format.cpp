@@ -0,0 +1,145 @@
+#include <catch2/catch_test_macros.hpp>
+
+#include "ki_cas_binary_format.h"
+
+#include "ki_cas_big_num_owner.h"
+#include "ki_cas_big_num_wrapper.h"
+#include <random>
+#include <string>
+#include <vector>
+
+using namespace KiCAS2;
+
+TEST_CASE( "Binary encoding is the same on every target" ){
+    std::string str;
+    StringSink sink(str);
+
+    write_binary_native_int(sink, 300);
+    REQUIRE(str == std::string("\xac\x02", 2));
+
+    str.clear();
+    write_binary_native_rational(sink, NativeRational(1, 300));
+    REQUIRE(str == std::string("\x01\xac\x02", 3));
+
+    str.clear();
+    {
+        const Int val(-300);
+        write_binary_big_int(sink, val.get());
+        REQUIRE(str == std::string("\x05\x2c\x01", 3));
+
+        str.clear();
+        const Int big = int_from_strview("18446744073709551617");  // 2^64 + 1
+        write_binary_big_int(sink, big.get());
+        REQUIRE(str == std::string("\x12\x01\x00\x00\x00\x00\x00\x00\x00\x01", 10));
+        REQUIRE(binary_size(big.get()) == str.size());
+
+        str.clear();
+        const Rat half = Rat::adopt({-1, 2});
+        write_binary_big_rational(sink, half.get());
+        REQUIRE(str == std::string("\x03\x01\x02\x02", 4));
+    }
+
+    LEAK_CHECK_REQUIRE(isAllGmpMemoryFreed_resetIfNot());
+}
+
+TEST_CASE( "Binary round trip" ){
+    std::mt19937_64 generator(7);
+
+    SECTION("Native"){
+        std::vector<size_t> ints = {0, 1, 127, 128, 16383, 16384, std::numeric_limits<size_t>::max()};
+        for(size_t i = 0; i < 100; i++) ints.push_back(static_cast<size_t>(generator()) >> (generator() % 64));
+        std::vector<NativeRational> rats;
+        for(size_t i = 0; i < 100; i++) rats.emplace_back(static_cast<size_t>(generator()), static_cast<size_t>(generator()) | 1);
+
+        std::string str;
+        StringSink sink(str);
+        write_binary_native_ints(sink, ints.data(), ints.size());
+        write_binary_native_rationals(sink, rats.data(), rats.size());
+
+        std::vector<size_t> read_ints(ints.size());
+        std::vector<NativeRational> read_rats(rats.size());
+        std::string_view bytes = str;
+        REQUIRE(!read_binary_native_ints(read_ints.data(), read_ints.size(), bytes));
+        REQUIRE(!read_binary_native_rationals(read_rats.data(), read_rats.size(), bytes));
+        REQUIRE(bytes.empty());
+        REQUIRE(read_ints == ints);
+        for(size_t i = 0; i < rats.size(); i++){
+            REQUIRE(read_rats[i].num == rats[i].num);
+            REQUIRE(read_rats[i].den == rats[i].den);
+        }
+    }
+
+    SECTION("Big"){
+        {
+            std::vector<Int> ints;
+            ints.emplace_back(0);
+            ints.emplace_back(COEFF_MAX);
+            ints.emplace_back(COEFF_MIN);
+            for(size_t i = 0; i < 100; i++){
+                Int val(static_cast<slong>(generator() >> 2));
+                fmpz_mul_2exp(val.get(), val.get(), generator() % 300);
+                if(i % 3 == 0) fmpz_neg(val.get(), val.get());
+                ints.push_back(std::move(val));
+            }
+
+            std::vector<Rat> rats;
+            for(size_t i = 0; i < 50; i++){
+                Rat val;
+                fmpz_set(fmpq_numref(val.get()), ints[i].get());
+                fmpz_set_ui(fmpq_denref(val.get()), generator() | 1);
+                fmpz_mul_2exp(fmpq_denref(val.get()), fmpq_denref(val.get()), generator() % 100);
+                fmpq_canonicalise(val.get());
+                rats.push_back(std::move(val));
+            }
+
+            std::string str;
+            StringSink sink(str);
+            write_binary_big_ints(sink, ints.front().get(), ints.size());
+            write_binary_big_rationals(sink, rats.front().get(), rats.size());
+
+            std::vector<Int> read_ints(ints.size());
+            std::vector<Rat> read_rats(rats.size());
+            read_ints[5] = int_from_strview("123456789012345678901234567890123456789012345678901234567890");
+            std::string_view bytes = str;
+            REQUIRE(!read_binary_big_ints(read_ints.front().get(), read_ints.size(), bytes));
+            REQUIRE(!read_binary_big_rationals(read_rats.front().get(), read_rats.size(), bytes));
+            REQUIRE(bytes.empty());
+            for(size_t i = 0; i < ints.size(); i++) REQUIRE(fmpz_equal(read_ints[i].get(), ints[i].get()));
+            for(size_t i = 0; i < rats.size(); i++) REQUIRE(fmpq_equal(read_rats[i].get(), rats[i].get()));
+            REQUIRE(read_ints[1].isSmall());
+        }
+
+        LEAK_CHECK_REQUIRE(isAllGmpMemoryFreed_resetIfNot());
+    }
+}
+
+TEST_CASE( "Binary readers reject malformed input" ){
+    size_t val;
+    std::string_view truncated_varint("\x80\x80", 2);
+    REQUIRE(read_binary_native_int(&val, truncated_varint));
+
+    std::string_view overlong_varint("\xff\xff\xff\xff\xff\xff\xff\xff\xff\xff\x01", 11);
+    REQUIRE(read_binary_native_int(&val, overlong_varint));
+
+    std::string_view too_large_varint("\xff\xff\xff\xff\xff\xff\xff\xff\xff\x02", 10);
+    REQUIRE(read_binary_native_int(&val, too_large_varint));
+
+    NativeRational rat;
+    std::string_view zero_den("\x01\x00", 2);
+    REQUIRE(read_binary_native_rational(&rat, zero_den));
+
+    {
+        Int big;
+        std::string_view truncated_limbs("\x12\x01\x00", 3);
+        REQUIRE(read_binary_big_int(big.get(), truncated_limbs));
+
+        std::string_view negative_zero("\x01", 1);
+        REQUIRE(read_binary_big_int(big.get(), negative_zero));
+
+        Rat big_rat;
+        std::string_view negative_den("\x02\x01\x03\x01", 4);
+        REQUIRE(read_binary_big_rational(big_rat.get(), negative_den));
+    }
+
+    LEAK_CHECK_REQUIRE(isAllGmpMemoryFreed_resetIfNot());
+}
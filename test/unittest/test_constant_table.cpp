@@ -0,0 +1,125 @@
+#include <catch2/catch_test_macros.hpp>
+
+#include "ki_cas_constant_table.h"
+
+#include "ki_cas_big_num_wrapper.h"
+#include <cstdint>
+#include <cstdio>
+#include <cstring>
+#include <filesystem>
+#include <limits>
+#include <string>
+#include <vector>
+
+using namespace KiCAS2;
+
+/// 0!, 1!, ..., 59!, with alternating signs
+static std::vector<Int> signed_factorials() {
+    std::vector<Int> factorials;
+    factorials.emplace_back(1);
+    for(ulong i = 1; i < 60; i++){
+        Int val;
+        fmpz_mul_ui(val.get(), factorials.back().get(), i);
+        factorials.push_back(std::move(val));
+    }
+    for(size_t i = 1; i < factorials.size(); i += 2) fmpz_neg(factorials[i].get(), factorials[i].get());
+    factorials.emplace_back(0);
+
+    return factorials;
+}
+
+static bool equals(const Int& val, const MP_INT& entry) {
+    mpz_t expected;
+    mpz_init(expected);
+    fmpz_get_mpz(expected, val.get());
+    const bool is_equal = mpz_cmp(expected, &entry) == 0;
+    mpz_clear(expected);
+    return is_equal;
+}
+
+TEST_CASE( "ConstantTable views entries in place" ){
+    {
+        const std::vector<Int> vals = signed_factorials();
+        std::string bytes;
+        StringSink sink(bytes);
+        write_constant_table(sink, vals.front().get(), vals.size());
+
+        ConstantTable table;
+        REQUIRE(!table.view(bytes));
+        REQUIRE(table.size() == vals.size());
+
+        for(size_t i = 0; i < vals.size(); i++){
+            const MP_INT entry = table.entry(i);
+            REQUIRE(equals(vals[i], entry));
+        }
+
+        const MP_INT big = table.entry(50);
+        REQUIRE(mpz_size(&big) > 1);
+        REQUIRE(mpz_limbs_read(&big) >= reinterpret_cast<const mp_limb_t*>(bytes.data()));
+        REQUIRE(mpz_limbs_read(&big) < reinterpret_cast<const mp_limb_t*>(bytes.data() + bytes.size()));
+
+        SECTION("Materialised entries are owned"){
+            Int val = table.materialise(50);
+            fmpz_add_ui(val.get(), val.get(), 1);
+            REQUIRE(equals(vals[50], big));
+            REQUIRE(fmpz_cmp(val.get(), vals[50].get()) > 0);
+            REQUIRE(table.materialise(3).isSmall());
+        }
+
+        SECTION("Invalid tables are rejected"){
+            std::string corrupt = bytes;
+            corrupt[0] = 'X';
+            REQUIRE(table.view(corrupt));
+            REQUIRE(table.size() == 0);
+
+            std::string truncated = bytes.substr(0, bytes.size() - sizeof(mp_limb_t));
+            REQUIRE(table.view(truncated));
+
+            REQUIRE(table.view(std::string_view(bytes.data(), 8)));
+
+            // The header is 24 bytes, followed by index entries of a 64-bit limb offset and a 64-bit signed size
+            static constexpr size_t FIRST_ENTRY_SIZE_OFFSET = 24 + sizeof(uint64_t);
+            std::string corrupt_size = bytes;
+            for(const int64_t size : {std::numeric_limits<int64_t>::min(), std::numeric_limits<int64_t>::max()}){
+                std::memcpy(corrupt_size.data() + FIRST_ENTRY_SIZE_OFFSET, &size, sizeof(size));
+                REQUIRE(table.view(corrupt_size));
+                REQUIRE(table.size() == 0);
+            }
+        }
+    }
+
+    LEAK_CHECK_REQUIRE(isAllGmpMemoryFreed_resetIfNot());
+}
+
+TEST_CASE( "ConstantTable maps files" ){
+    const std::filesystem::path path = std::filesystem::temp_directory_path() / "ki_cas_constant_table_test.bin";
+
+    {
+        const std::vector<Int> vals = signed_factorials();
+        std::FILE* file = std::fopen(path.string().c_str(), "wb");
+        REQUIRE(file != nullptr);
+        {
+            FileDescriptorSink sink(fileno(file));
+            write_constant_table(sink, vals.front().get(), vals.size());
+            REQUIRE(!sink.flush());
+        }
+        std::fclose(file);
+
+        ConstantTable table;
+        REQUIRE(!table.map(path.string().c_str()));
+        REQUIRE(table.size() == vals.size());
+        for(size_t i = 0; i < vals.size(); i++){
+            const MP_INT entry = table.entry(i);
+            REQUIRE(equals(vals[i], entry));
+        }
+
+        ConstantTable moved = std::move(table);
+        REQUIRE(table.size() == 0);
+        REQUIRE(fmpz_equal(moved.materialise(59).get(), vals[59].get()));
+
+        REQUIRE(table.map((path.string() + ".missing").c_str()));
+    }
+
+    std::filesystem::remove(path);
+    LEAK_CHECK_REQUIRE(isAllGmpMemoryFreed_resetIfNot());
+}
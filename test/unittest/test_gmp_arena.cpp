@@ -0,0 +1,108 @@
+#include <catch2/catch_test_macros.hpp>
+
+#include "ki_cas_gmp_arena.h"
+
+#include "ki_cas_big_num_wrapper.h"
+#include "ki_cas_numeric_allocator.h"
+#include <string>
+
+using namespace KiCAS2;
+
+static std::string to_string(const fmpq& val) {
+    std::string str;
+    write_big_rational(str, val);
+    return str;
+}
+
+TEST_CASE( "GmpArenaScope" ){
+    NumericAllocatorScope allocator_scope;
+    install_gmp_arena();
+    REQUIRE(is_gmp_arena_installed());
+
+    mpz_t escaped;
+    {
+        GmpArenaScope scope;
+        const GmpArenaStats before = gmp_arena_stats();
+
+        mpz_t temporary;
+        mpz_init_set_str(temporary, "123456789012345678901234567890123456789012345678901234567890", 10);
+        mpz_mul(temporary, temporary, temporary);
+
+        const GmpArenaStats during = gmp_arena_stats();
+        REQUIRE(during.arena_allocations > before.arena_allocations);
+        REQUIRE(during.heap_allocations == before.heap_allocations);
+        REQUIRE(during.reserved_bytes > 0);
+
+        {
+            GmpArenaBypass bypass;
+            mpz_init_set(escaped, temporary);
+        }
+        REQUIRE(gmp_arena_stats().heap_allocations > during.heap_allocations);
+
+        SECTION("Nested"){
+            GmpArenaScope inner;
+            mpz_t inner_temporary;
+            mpz_init_set(inner_temporary, temporary);
+            mpz_add_ui(inner_temporary, inner_temporary, 1);
+            REQUIRE(mpz_cmp(inner_temporary, temporary) > 0);
+            mpz_clear(inner_temporary);
+        }
+
+        mpz_clear(temporary);
+    }
+
+    // Allocations outside of a scope pass through
+    const GmpArenaStats after = gmp_arena_stats();
+    mpz_mul(escaped, escaped, escaped);
+    REQUIRE(gmp_arena_stats().heap_allocations > after.heap_allocations);
+    REQUIRE(gmp_arena_stats().arena_allocations == after.arena_allocations);
+
+    mpz_t expected;
+    mpz_init_set_str(expected, "123456789012345678901234567890123456789012345678901234567890", 10);
+    mpz_pow_ui(expected, expected, 4);
+    REQUIRE(mpz_cmp(escaped, expected) == 0);
+    mpz_clear(expected);
+    mpz_clear(escaped);
+
+    LEAK_CHECK_REQUIRE(isAllGmpMemoryFreed_resetIfNot());
+}
+
+TEST_CASE( "fmpq parsing in a GmpArenaScope" ){
+    NumericAllocatorScope allocator_scope;
+    install_gmp_arena();
+
+    const std::string decimal = "1234567890123456789012345678901234567890.0625";
+    const std::string scientific = "1.2345678901234567890123456789e-30";
+    const std::string large_exponent = "3.25e40";
+
+    fmpq decimal_result, scientific_result, large_exponent_result;
+    {
+        GmpArenaScope scope;
+        const GmpArenaStats before = gmp_arena_stats();
+
+        decimal_result = fmpq_from_decimal_str(decimal);
+        scientific_result = fmpq_from_scientific_str(scientific);
+        large_exponent_result = fmpq_from_scientific_str(large_exponent);
+
+        REQUIRE(gmp_arena_stats().arena_allocations > before.arena_allocations);
+    }
+
+    // Results outlive the scope, and are reused after the arena is rewound
+    {
+        GmpArenaScope scope;
+        mpz_t overwrite;
+        mpz_init_set_str(overwrite, "999999999999999999999999999999999999999999999999999999999999999999999999", 10);
+        mpz_clear(overwrite);
+    }
+
+    REQUIRE(to_string(decimal_result) == "19753086241975308624197530862419753086241/16");
+    REQUIRE(to_string(scientific_result) ==
+            "12345678901234567890123456789/10000000000000000000000000000000000000000000000000000000000");
+    REQUIRE(to_string(large_exponent_result) == "32500000000000000000000000000000000000000");
+
+    fmpq_clear(&decimal_result);
+    fmpq_clear(&scientific_result);
+    fmpq_clear(&large_exponent_result);
+
+    LEAK_CHECK_REQUIRE(isAllGmpMemoryFreed_resetIfNot());
+}
@@ -0,0 +1,126 @@
+#include <catch2/catch_test_macros.hpp>
+
+#include "ki_cas_gmp_pool.h"
+
+#include "ki_cas_big_num_wrapper.h"
+#include "ki_cas_gmp_arena.h"
+#include "ki_cas_numeric_allocator.h"
+#include <thread>
+#include <vector>
+
+using namespace KiCAS2;
+
+TEST_CASE( "GmpPool reuses limb buffers" ){
+    {
+        NumericAllocatorScope allocator_scope;
+        REQUIRE_FALSE(install_gmp_pool());
+        REQUIRE(is_gmp_pool_installed());
+        REQUIRE_FALSE(install_gmp_pool());
+
+        mpz_t val;
+        mpz_init2(val, 4*GMP_NUMB_BITS);
+        mpz_set_str(val, "1234567890123456789012345678901234567890", 10);
+        mpz_clear(val);
+
+        const GmpPoolStats before = gmp_pool_stats();
+        for(size_t i = 0; i < 100; i++){
+            mpz_init2(val, 4*GMP_NUMB_BITS);
+            mpz_set_str(val, "1234567890123456789012345678901234567890", 10);
+            REQUIRE(mpz_sizeinbase(val, 10) == 40);
+            mpz_clear(val);
+        }
+        const GmpPoolStats after = gmp_pool_stats();
+
+        REQUIRE(after.thread_hits - before.thread_hits >= 100);
+        REQUIRE(after.misses == before.misses);
+        REQUIRE(after.hitRate() > 0);
+
+        SECTION("Reallocation between size classes keeps the value"){
+            mpz_t grown;
+            mpz_init_set_ui(grown, 7);
+            for(size_t i = 0; i < 40; i++) mpz_mul_ui(grown, grown, 1000003);
+            mpz_t expected;
+            mpz_init(expected);
+            mpz_ui_pow_ui(expected, 1000003, 40);
+            mpz_mul_ui(expected, expected, 7);
+            REQUIRE(mpz_cmp(grown, expected) == 0);
+
+            mpz_realloc2(grown, GMP_NUMB_BITS*GMP_POOL_MAX_LIMBS*4);
+            REQUIRE(mpz_cmp(grown, expected) == 0);
+            mpz_clear(grown);
+            mpz_clear(expected);
+        }
+
+        SECTION("Bypass"){
+            const GmpPoolStats bypass_before = gmp_pool_stats();
+            {
+                GmpPoolBypass bypass;
+                mpz_init2(val, 4*GMP_NUMB_BITS);
+                mpz_clear(val);
+            }
+            const GmpPoolStats bypass_after = gmp_pool_stats();
+            REQUIRE(bypass_after.thread_hits == bypass_before.thread_hits);
+            REQUIRE(bypass_after.unpooled > bypass_before.unpooled);
+        }
+    }
+
+    // Removing the pool returns its free blocks to the allocator beneath
+    LEAK_CHECK_REQUIRE(isAllGmpMemoryFreed_resetIfNot());
+}
+
+TEST_CASE( "GmpPool is beneath the arena" ){
+    {
+        NumericAllocatorScope allocator_scope;
+        REQUIRE_FALSE(install_gmp_pool());
+        install_gmp_arena();
+        REQUIRE(is_gmp_pool_installed());
+
+        // Allocations within a scope are served by the arena before reaching the pool
+        const GmpPoolStats before = gmp_pool_stats();
+        {
+            GmpArenaScope scope;
+            mpz_t val;
+            mpz_init2(val, 4*GMP_NUMB_BITS);
+            mpz_clear(val);
+        }
+        const GmpPoolStats after = gmp_pool_stats();
+        REQUIRE(after.thread_hits + after.reclaim_hits == before.thread_hits + before.reclaim_hits);
+        REQUIRE(after.misses == before.misses);
+        REQUIRE(after.unpooled == before.unpooled);
+    }
+
+    LEAK_CHECK_REQUIRE(isAllGmpMemoryFreed_resetIfNot());
+}
+
+TEST_CASE( "GmpPool is not installed over the arena" ){
+    NumericAllocatorScope allocator_scope;
+    install_gmp_arena();
+    REQUIRE(install_gmp_pool());
+    REQUIRE_FALSE(is_gmp_pool_installed());
+}
+
+TEST_CASE( "GmpPool reclaims blocks across threads" ){
+    static constexpr size_t NUM_BLOCKS = 4*GMP_POOL_THREAD_CACHE_BLOCKS;
+    {
+        NumericAllocatorScope allocator_scope;
+        REQUIRE_FALSE(install_gmp_pool());
+
+        // Allocate on one thread and free on another, so freed blocks exceed the cache of the freeing thread
+        std::vector<__mpz_struct> handoff(NUM_BLOCKS);
+        for(__mpz_struct& val : handoff) mpz_init2(&val, 3*GMP_NUMB_BITS);
+        std::thread([&handoff](){ for(__mpz_struct& val : handoff) mpz_clear(&val); }).join();
+
+        size_t reclaim_hits = 0;
+        std::thread([&reclaim_hits](){
+            const GmpPoolStats before = gmp_pool_stats();
+            mpz_t val;
+            mpz_init2(val, 3*GMP_NUMB_BITS);
+            mpz_clear(val);
+            reclaim_hits = gmp_pool_stats().reclaim_hits - before.reclaim_hits;
+        }).join();
+
+        REQUIRE(reclaim_hits == 1);
+    }
+
+    LEAK_CHECK_REQUIRE(isAllGmpMemoryFreed_resetIfNot());
+}
@@ -0,0 +1,116 @@
+#include <catch2/catch_test_macros.hpp>
+
+#include "ki_cas_intern_table.h"
+
+#include "ki_cas_big_num_wrapper.h"
+#include <thread>
+#include <vector>
+
+using namespace KiCAS2;
+
+TEST_CASE( "InternTable shares equal values" ){
+    {
+        InternTable table;
+
+        const Int big = int_from_strview("123456789012345678901234567890");
+        const InternedNumber a = table.intern(big.get());
+        const InternedNumber b = table.intern(int_from_strview("123456789012345678901234567890"));
+        REQUIRE(a == b);
+        REQUIRE(a.isInteger());
+        REQUIRE(fmpz_equal(a.numerator(), big.get()));
+        REQUIRE(a.hash() == b.hash());
+
+        const InternedNumber c = table.intern(int_from_strview("123456789012345678901234567891"));
+        REQUIRE(a != c);
+
+        SECTION("Representations of equal values intern to the same instance"){
+            const Int three(3);
+            const InternedNumber from_fmpz = table.intern(three.get());
+            const InternedNumber from_native = table.intern(NativeRational(6, 2));
+            const Rat rat = rat_from_decimal_str("3.0");
+            const InternedNumber from_fmpq = table.intern(rat.get());
+            REQUIRE(from_fmpz == from_native);
+            REQUIRE(from_fmpz == from_fmpq);
+            REQUIRE(from_native.isInteger());
+
+            const InternedNumber quarter = table.intern(NativeRational(2, 8));
+            REQUIRE(quarter == table.intern(rat_from_decimal_str("0.25")));
+            REQUIRE(!quarter.isInteger());
+            REQUIRE(quarter != from_native);
+        }
+
+        SECTION("Statistics report memory saved"){
+            const InternStats before = table.stats();
+            REQUIRE(before.values == 2);
+            REQUIRE(before.references == 3);
+            REQUIRE(before.bytes_saved > 0);
+
+            std::vector<InternedNumber> copies(10, a);
+            const InternStats after = table.stats();
+            REQUIRE(after.values == 2);
+            REQUIRE(after.references == 13);
+            REQUIRE(after.bytes_saved == 11*before.bytes_saved);
+        }
+
+        SECTION("Values without handles are reclaimed"){
+            const size_t hash = c.hash();
+            {
+                InternedNumber d = table.intern(int_from_strview("999999999999999999999999999999"));
+                REQUIRE(table.stats().values == 3);
+            }
+            REQUIRE(table.stats().values == 2);
+            table.collect();
+            REQUIRE(table.stats().values == 2);
+            REQUIRE(table.intern(int_from_strview("123456789012345678901234567891")).hash() == hash);
+        }
+
+        SECTION("Growth keeps values interned"){
+            std::vector<InternedNumber> handles;
+            for(slong i = 0; i < 10000; i++) handles.push_back(table.intern(Int(i)));
+            for(slong i = 0; i < 10000; i++) REQUIRE(table.intern(NativeRational(size_t(i), 1)) == handles[size_t(i)]);
+            REQUIRE(table.intern(big.get()) == a);
+            REQUIRE(table.stats().values == 10002);
+        }
+    }
+
+    LEAK_CHECK_REQUIRE(isAllGmpMemoryFreed_resetIfNot());
+}
+
+TEST_CASE( "InternTable is consistent across threads" ){
+    static constexpr size_t NUM_THREADS = 4;
+    static constexpr size_t NUM_VALUES = 2000;
+
+    {
+        InternTable table;
+        std::vector<std::vector<InternedNumber>> handles(NUM_THREADS);
+
+        // Every thread interns the same values, while dropping and reinterning some to exercise reclamation
+        std::vector<std::thread> threads;
+        for(size_t t = 0; t < NUM_THREADS; t++){
+            threads.emplace_back([&table, &handles, t](){
+                for(size_t i = 0; i < NUM_VALUES; i++){
+                    Int val(static_cast<slong>(i));
+                    fmpz_mul_2exp(val.get(), val.get(), 100);
+                    handles[t].push_back(table.intern(std::move(val)));
+                    if(i % 7 == t){
+                        handles[t].back() = InternedNumber();
+                        table.collect();
+                        handles[t].back() = table.intern(NativeRational(i, 1));
+                    }
+                }
+            });
+        }
+        for(std::thread& thread : threads) thread.join();
+
+        for(size_t i = 0; i < NUM_VALUES; i++){
+            if(i % 7 < NUM_THREADS) continue;
+            for(size_t t = 1; t < NUM_THREADS; t++) REQUIRE(handles[t][i] == handles[0][i]);
+        }
+
+        handles.clear();
+        table.collect();
+        REQUIRE(table.stats().values == 0);
+    }
+
+    LEAK_CHECK_REQUIRE(isAllGmpMemoryFreed_resetIfNot());
+}
@@ -2,6 +2,7 @@
 
 #include "ki_cas_kmpz.h"
 
+#include "ki_cas_allocation_tracker.h"
 #include "ki_cas_big_num_wrapper.h"
 #include <bit>
 #include <iostream>
@@ -97,6 +98,56 @@ TEST_CASE( "mpz_init_set_x" ){
     LEAK_CHECK_REQUIRE(isAllGmpMemoryFreed_resetIfNot());
 }
 
+TEST_CASE( "mpz_init_set_x negative" ){
+    char buffer[256u] = { 0 };
+
+    mpz_t val;
+    mpz_init_set_uint256<true>(val, uint256_t(1) << 100);
+    REQUIRE(mpz_get_str(buffer, 10, val) == std::string("-1267650600228229401496703205376"));
+    mpz_clear(val);
+
+    mpz_init_set_uint128<true>(val, 0);
+    REQUIRE(mpz_sgn(val) == 0);
+    mpz_clear(val);
+
+    LEAK_CHECK_REQUIRE(isAllGmpMemoryFreed_resetIfNot());
+}
+
+TEST_CASE( "mpz_view" ){
+    char buffer[256u] = { 0 };
+
+    REQUIRE(mpz_sgn(mpz_view(uint128_t(0)).get()) == 0);
+    REQUIRE(mpz_sgn(mpz_view(uint512_t(0), true).get()) == 0);
+    REQUIRE(mpz_get_str(buffer, 10, mpz_view(uint128_t(42)).get()) == std::string("42"));
+
+    const auto big = mpz_view(uint128_t(1) << 100);
+    REQUIRE(mpz_size(big.get()) == 16/sizeof(mp_limb_t));
+    REQUIRE(mpz_get_str(buffer, 10, big.get()) == std::string("1267650600228229401496703205376"));
+
+    const auto negative = mpz_view(uint256_t(1) << 100, true);
+    REQUIRE(mpz_get_str(buffer, 10, negative.get()) == std::string("-1267650600228229401496703205376"));
+
+    const uint512_t max = std::numeric_limits<uint512_t>::max();
+    const auto wide = mpz_view(max);
+    REQUIRE(mpz_sizeinbase(wide.get(), 2) == 512);
+    REQUIRE(mpz_get_str(buffer, 10, wide.get()) == intx::to_string(max));
+
+    SECTION("Views do not allocate"){
+        NumericAllocatorScope allocator_scope;
+        install_allocation_tracker();
+        const uint256_t val = intx::from_string<uint256_t>("123456789012345678901234567890123456789012345678901234567890");
+        const size_t num_allocations = allocation_stats().num_allocations;
+        const auto view = mpz_view(val, true);
+        const unsigned long rem = mpz_fdiv_ui(view.get(), 1000003);
+        const int cmp = mpz_cmp(view.get(), negative.get());
+        REQUIRE(allocation_stats().num_allocations == num_allocations);
+        REQUIRE(rem == (1000003 - (val % 1000003)[0]) % 1000003);
+        REQUIRE(cmp < 0);
+    }
+
+    LEAK_CHECK_REQUIRE(isAllGmpMemoryFreed_resetIfNot());
+}
+
 TEST_CASE( "to_fmpz" ){
     char buffer[256u] = { 0 };
     fmpz val;
@@ -132,6 +183,121 @@ TEST_CASE( "to_fmpz" ){
     LEAK_CHECK_REQUIRE(isAllGmpMemoryFreed_resetIfNot());
 }
 
+TEST_CASE( "uintN_to_fmpz" ){
+    char buffer[256u] = { 0 };
+    fmpz val;
+
+    val = uintN_to_fmpz<512>(uint512_t(COEFF_MAX));
+    REQUIRE(!COEFF_IS_MPZ(val));
+    REQUIRE(val == COEFF_MAX);
+
+    val = uintN_to_fmpz<512, true>(uint512_t(COEFF_MAX));
+    REQUIRE(val == -COEFF_MAX);
+
+    val = uintN_to_fmpz<128>(uint128_t(COEFF_MAX) + 1);
+    REQUIRE(COEFF_IS_MPZ(val));
+    REQUIRE(fmpz_get_str(buffer, 10, &val) == intx::to_string(uint128_t(COEFF_MAX) + 1));
+    fmpz_clear(&val);
+
+    val = uintN_to_fmpz<256, true>(uint256_t(1) << 64);
+    REQUIRE(fmpz_get_str(buffer, 10, &val) == std::string("-18446744073709551616"));
+    REQUIRE(fmpz_size(&val) == 8/sizeof(mp_limb_t) + 1);
+    fmpz_clear(&val);
+
+    const uint512_t max = std::numeric_limits<uint512_t>::max();
+    val = u512_to_fmpz<true>(max);
+    REQUIRE(fmpz_get_str(buffer, 10, &val) == "-" + intx::to_string(max));
+    REQUIRE(fmpz_bits(&val) == 512);
+    fmpz_clear(&val);
+
+    {
+        const Int big = u512_to_int(max >> 1);
+        REQUIRE(fmpz_bits(big.get()) == 511);
+    }
+
+    LEAK_CHECK_REQUIRE(isAllGmpMemoryFreed_resetIfNot());
+}
+
+TEST_CASE( "fmpz_get_uintx" ){
+    uint128_t u128 = 7;
+    uint256_t u256 = 7;
+    uint512_t u512 = 7;
+    bool is_negative = true;
+
+    {
+        const Int zero;
+        REQUIRE(!fmpz_get_uint128(&u128, &is_negative, zero.get()));
+        REQUIRE(u128 == 0);
+        REQUIRE(!is_negative);
+
+        const Int small(COEFF_MIN);
+        REQUIRE(!fmpz_get_uint256(&u256, &is_negative, small.get()));
+        REQUIRE(u256 == -static_cast<ulong>(COEFF_MIN));
+        REQUIRE(is_negative);
+
+        const Int big = u128_to_int<true>(std::numeric_limits<uint128_t>::max());
+        REQUIRE(!fmpz_get_uint128(&u128, &is_negative, big.get()));
+        REQUIRE(u128 == std::numeric_limits<uint128_t>::max());
+        REQUIRE(is_negative);
+        REQUIRE(!fmpz_get_uint512(&u512, &is_negative, big.get()));
+        REQUIRE(u512 == std::numeric_limits<uint128_t>::max());
+
+        Int too_big;
+        fmpz_one(too_big.get());
+        fmpz_mul_2exp(too_big.get(), too_big.get(), 128);
+        u128 = 7;
+        is_negative = false;
+        REQUIRE(fmpz_get_uint128(&u128, &is_negative, too_big.get()));
+        REQUIRE(u128 == 7);
+        REQUIRE(!is_negative);
+        REQUIRE(!fmpz_get_uint256(&u256, &is_negative, too_big.get()));
+        REQUIRE(u256 == uint256_t(1) << 128);
+    }
+
+    SECTION("Round trip through mpz"){
+        const uint512_t vals[] = {
+            1,
+            uint512_t(1) << 64,
+            intx::from_string<uint512_t>("123456789012345678901234567890123456789012345678901234567890123456789"),
+            std::numeric_limits<uint512_t>::max(),
+        };
+        for(const uint512_t& val : vals){
+            mpz_t z;
+            mpz_init_set_uint512<true>(z, val);
+            REQUIRE(!mpz_get_uint512(&u512, &is_negative, z));
+            REQUIRE(u512 == val);
+            REQUIRE(is_negative);
+            REQUIRE(mpz_get_uint256(&u256, &is_negative, z) == (val > std::numeric_limits<uint256_t>::max()));
+            mpz_clear(z);
+        }
+    }
+
+    LEAK_CHECK_REQUIRE(isAllGmpMemoryFreed_resetIfNot());
+}
+
+TEST_CASE( "knownfit_str2uintx" ){
+    const std::string nines_38(38, '9');
+    const std::string nines_77(77, '9');
+    const std::string strs[] = {
+        "0",
+        "7",
+        "1234567890123456789",
+        "12345678901234567890",
+        "00000000000000000000000000001",
+        "340282366920938463463374607431768211455",
+        nines_38,
+        "10000000000000000000000000000000000000000000000000000000000000000000000000001",
+        nines_77,
+    };
+
+    for(const std::string& str : strs){
+        if(str.size() <= 38) REQUIRE(knownfit_str2uint128(str) == intx::from_string<uint128_t>(str));
+        REQUIRE(knownfit_str2uint256(str) == intx::from_string<uint256_t>(str));
+    }
+
+    REQUIRE(knownfit_str2uint256(std::string_view(nines_77).substr(0, 40)) == intx::from_string<uint256_t>(nines_77.substr(0, 40)));
+}
+
 TEST_CASE( "write_uint128" ){
     std::string str = "x + ";
 
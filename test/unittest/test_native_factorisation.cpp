@@ -0,0 +1,197 @@
+#include <catch2/catch_test_macros.hpp>
+
+#include "ki_cas_native_factorisation.h"
+
+#include "ki_cas_native_integer.h"
+#include <limits>
+#include <random>
+#include <thread>
+#include <vector>
+
+using namespace KiCAS2;
+
+static constexpr size_t MAX = std::numeric_limits<size_t>::max();
+
+static bool is_prime_by_trial_division(size_t n) {
+    if(n < 2) return false;
+    for(size_t d = 2; d <= n / d; d++)
+        if(n % d == 0) return false;
+    return true;
+}
+
+/// Check the primes are increasing, are prime, and multiply back to the word
+static bool is_factorisation_of(const NativeFactorisation& factors, size_t n) {
+    size_t product = 1;
+    for(size_t i = 0; i < factors.num_factors; i++){
+        if(i > 0 && factors.primes[i] <= factors.primes[i - 1]) return false;
+        if(factors.exponents[i] == 0 || !is_prime(factors.primes[i])) return false;
+        if(ckd_mul(&product, product, knownfit_pow(factors.primes[i], factors.exponents[i]))) return false;
+    }
+    return product == n;
+}
+
+TEST_CASE( "is_prime" ) {
+    for(size_t n = 0; n < 300000; n++) REQUIRE(is_prime(n) == is_prime_by_trial_division(n));
+    for(size_t n = 1000000; n < 1010000; n++) REQUIRE(is_prime(n) == is_prime_by_trial_division(n));
+
+    REQUIRE(is_prime(4294967291u));  // Largest 32-bit prime
+    REQUIRE_FALSE(is_prime(4294967295u));
+    REQUIRE_FALSE(is_prime(3215031751u));  // Strong pseudoprime to bases 2, 3, 5 and 7
+    REQUIRE_FALSE(is_prime(MAX));
+
+    if constexpr(sizeof(size_t) == 8){
+        REQUIRE(is_prime(static_cast<size_t>(18446744073709551557ull)));  // Largest 64-bit prime
+        REQUIRE(is_prime(static_cast<size_t>((1ull << 61) - 1)));
+        REQUIRE_FALSE(is_prime(static_cast<size_t>(3825123056546413051ull)));  // Strong pseudoprime to the first 9 primes
+        REQUIRE_FALSE(is_prime(static_cast<size_t>(4294967291ull * 4294967279ull)));
+    }
+}
+
+TEST_CASE( "factorise" ) {
+    NativeFactorisation factors;
+
+    factorise(&factors, 1);
+    REQUIRE(factors.num_factors == 0);
+
+    factorise(&factors, 360);
+    REQUIRE(factors.num_factors == 3);
+    REQUIRE(factors.primes[0] == 2);
+    REQUIRE(factors.exponents[0] == 3);
+    REQUIRE(factors.primes[1] == 3);
+    REQUIRE(factors.exponents[1] == 2);
+    REQUIRE(factors.primes[2] == 5);
+    REQUIRE(factors.exponents[2] == 1);
+
+    for(size_t n = 1; n < 300000; n++){
+        factorise(&factors, n);
+        REQUIRE(is_factorisation_of(factors, n));
+    }
+
+    // Words with large prime factors, prime powers, and the most distinct prime factors
+    std::vector<size_t> args = {MAX, MAX - 1, size_t(1) << (sizeof(size_t)*8 - 1), 4294967291u, 65521u * 65519u};
+    if constexpr(sizeof(size_t) == 8){
+        args.push_back(static_cast<size_t>(4294967291ull * 4294967279ull));
+        args.push_back(static_cast<size_t>(4294967291ull * 4294967291ull));
+        args.push_back(static_cast<size_t>(2642243ull * 2642243ull * 2642243ull));
+        args.push_back(static_cast<size_t>(1031ull * 1031ull * 4294967291ull * 3ull));
+        args.push_back(static_cast<size_t>(614889782588491410ull));  // Product of the first 15 primes
+        args.push_back(static_cast<size_t>(18446744073709551557ull));
+        args.push_back(static_cast<size_t>(3825123056546413051ull));
+    }
+    for(const size_t n : args){
+        factorise(&factors, n);
+        REQUIRE(is_factorisation_of(factors, n));
+    }
+
+    if constexpr(sizeof(size_t) == 8){
+        factorise(&factors, static_cast<size_t>(614889782588491410ull));
+        REQUIRE(factors.num_factors == NativeFactorisation::MAX_FACTORS);
+
+        factorise(&factors, static_cast<size_t>(4294967291ull * 4294967291ull));
+        REQUIRE(factors.num_factors == 1);
+        REQUIRE(factors.primes[0] == 4294967291u);
+        REQUIRE(factors.exponents[0] == 2);
+    }
+
+    std::mt19937_64 generator(13);
+    for(size_t i = 0; i < 2000; i++){
+        const size_t n = static_cast<size_t>(generator() >> (generator() % 40)) | 1;
+        factorise(&factors, n);
+        REQUIRE(is_factorisation_of(factors, n));
+    }
+}
+
+TEST_CASE( "square_free_part" ) {
+    size_t k;
+
+    REQUIRE(square_free_part(0, &k) == 0);
+    REQUIRE(k == 1);
+
+    REQUIRE(square_free_part(1, &k) == 1);
+    REQUIRE(k == 1);
+
+    REQUIRE(square_free_part(72, &k) == 2);
+    REQUIRE(k == 6);
+
+    REQUIRE(square_free_part(30, &k) == 30);
+    REQUIRE(k == 1);
+
+    constexpr size_t max_squarable_number = MAX >> (sizeof(size_t)*8/2);
+    REQUIRE(square_free_part(max_squarable_number * max_squarable_number, &k) == 1);
+    REQUIRE(k == max_squarable_number);
+
+    for(size_t n = 1; n < 5000; n++){
+        const size_t m = square_free_part(n, &k);
+        REQUIRE(k*k*m == n);
+        NativeFactorisation factors;
+        factorise(&factors, m);
+        for(size_t i = 0; i < factors.num_factors; i++) REQUIRE(factors.exponents[i] == 1);
+    }
+}
+
+TEST_CASE( "power_free_part" ) {
+    size_t k;
+
+    REQUIRE(power_free_part(1024 * 81 * 5, 3, &k) == 2 * 3 * 5);
+    REQUIRE(k == 8 * 3);
+
+    REQUIRE(power_free_part(1024 * 81 * 5, 1, &k) == 1);
+    REQUIRE(k == 1024 * 81 * 5);
+
+    REQUIRE(power_free_part(size_t(1) << (sizeof(size_t)*8 - 1), sizeof(size_t)*8 - 1, &k) == 1);
+    REQUIRE(k == 2);
+
+    REQUIRE(power_free_part(MAX, 2, &k) == MAX);
+    REQUIRE(k == 1);
+
+    REQUIRE(power_free_part(0, 5, &k) == 0);
+    REQUIRE(k == 1);
+}
+
+TEST_CASE( "Factorisation cache" ) {
+    const size_t n = MAX - 2;
+    NativeFactorisation factors;
+
+    clear_native_factor_cache();
+    factorise(&factors, 1000);  // Below the sieve limit, so not cached
+    REQUIRE(native_factor_cache_stats().misses == 0);
+
+    factorise(&factors, n);
+    REQUIRE(native_factor_cache_stats().hits == 0);
+    REQUIRE(native_factor_cache_stats().misses == 1);
+
+    NativeFactorisation cached;
+    factorise(&cached, n);
+    REQUIRE(native_factor_cache_stats().hits == 1);
+    REQUIRE(is_factorisation_of(cached, n));
+    REQUIRE(cached.num_factors == factors.num_factors);
+
+    clear_native_factor_cache();
+    REQUIRE(native_factor_cache_stats().hits == 0);
+    factorise(&cached, n);
+    REQUIRE(native_factor_cache_stats().misses == 1);
+}
+
+TEST_CASE( "Factorisation is consistent across threads" ) {
+    std::mt19937_64 generator(5);
+    std::vector<size_t> args;
+    for(size_t i = 0; i < 500; i++) args.push_back(static_cast<size_t>(generator()) | 1);
+
+    // Threads factorise overlapping words, so that they share cache slots
+    std::vector<std::thread> threads;
+    std::vector<char> is_correct(8, true);
+    for(size_t t = 0; t < is_correct.size(); t++){
+        threads.emplace_back([&args, &is_correct, t](){
+            for(size_t repeat = 0; repeat < 3; repeat++){
+                for(size_t i = t; i < args.size(); i += 2){
+                    NativeFactorisation factors;
+                    factorise(&factors, args[i]);
+                    if(!is_factorisation_of(factors, args[i])) is_correct[t] = false;
+                }
+            }
+        });
+    }
+    for(std::thread& thread : threads) thread.join();
+
+    for(const char thread_is_correct : is_correct) REQUIRE(thread_is_correct);
+}
@@ -2,6 +2,14 @@
 
 #include "ki_cas_native_float.h"
 
+#include "ki_cas_test_hooks.h"
+#include <charconv>
+#include <cmath>
+#include <cstring>
+#include <limits>
+#include <random>
+#include <thread>
+
 using namespace KiCAS2;
 
 #if !defined(__GNUC__) || __GNUC__ > 8
@@ -28,6 +36,146 @@ TEST_CASE( "write_float" ){
         REQUIRE(out == "2.998e+08");
     }
 }
+
+TEST_CASE( "write_float with format" ){
+    std::string out;
+
+    SECTION("General"){
+        write_float(out, 3.14159265, FloatFormat{3, FloatStyle::General});
+        REQUIRE(out == "3.14");
+    }
+
+    SECTION("Fixed"){
+        write_float(out, 2.998e8, FloatFormat{2, FloatStyle::Fixed});
+        REQUIRE(out == "299800000.00");
+    }
+
+    SECTION("Fixed large"){
+        write_float(out, 1e30, FloatFormat{0, FloatStyle::Fixed});
+        REQUIRE(out.size() == 31);
+        REQUIRE(out.substr(0, 3) == "100");
+    }
+
+    SECTION("Scientific"){
+        write_float(out, 1.5, FloatFormat{3, FloatStyle::Scientific});
+        REQUIRE(out == "1.500e+00");
+    }
+
+    SECTION("Shortest"){
+        write_float(out, 0.1L, FloatFormat{0, FloatStyle::Shortest});
+        REQUIRE(out == "0.1");
+    }
+
+    SECTION("High precision"){
+        write_float(out, 1.0L/3, FloatFormat{60, FloatStyle::Fixed});
+        REQUIRE(out.size() == 62);
+        REQUIRE(out.substr(0, 8) == "0.333333");
+    }
+
+    SECTION("Precision beyond the exact digits"){
+        std::string clamped;
+        write_float(clamped, 0.5, FloatFormat{MAX_FLOAT_PRECISION, FloatStyle::Fixed});
+        REQUIRE(clamped.size() == MAX_FLOAT_PRECISION + 2);
+        REQUIRE(clamped.substr(0, 4) == "0.50");
+
+        write_float(out, 0.5, FloatFormat{std::numeric_limits<size_t>::max(), FloatStyle::Fixed});
+        REQUIRE(out == clamped);
+        out.clear();
+        write_float(out, 0.5, FloatFormat{size_t(1) << 32, FloatStyle::Scientific});
+        REQUIRE(out.size() == MAX_FLOAT_PRECISION + 6);
+        REQUIRE(out.substr(out.size() - 4) == "e-01");
+    }
+
+    SECTION("Term"){
+        out = "x + ";
+        write_float_term(out, -1.5, FloatFormat{2, FloatStyle::Fixed});
+        REQUIRE(out == "x - 1.50");
+    }
+}
+
+template<typename T> static std::string std_shortest(T val) {
+    char buffer[64];
+    const auto result = std::to_chars(buffer, buffer + sizeof(buffer), val);
+    return std::string(buffer, result.ptr);
+}
+
+template<typename T> static bool matches_std_shortest(T val) {
+    std::string out;
+    write_float_shortest(out, val);
+    return out == std_shortest(val);
+}
+
+TEST_CASE( "write_float_shortest" ){
+    std::string out;
+
+    SECTION("Integer"){
+        write_float_shortest(out, 42.0);
+        REQUIRE(out == "42");
+    }
+
+    SECTION("Integer in scientific"){
+        write_float_shortest(out, 3e7);
+        REQUIRE(out == "3e+07");
+    }
+
+    SECTION("Short decimal"){
+        write_float_shortest(out, -2.25f);
+        REQUIRE(out == "-2.25");
+    }
+
+    SECTION("Long double"){
+        write_float_shortest(out, 0.1L);
+        REQUIRE(out == "0.1");
+    }
+
+    SECTION("Negative zero"){
+        write_float_shortest(out, -0.0);
+        REQUIRE(out == "-0");
+    }
+
+    SECTION("Thread format"){
+        write_float(out, 0.1L, FloatFormat{0, FloatStyle::Shortest});
+        REQUIRE(out == "0.1");
+    }
+}
+
+TEST_CASE( "write_float_shortest matches std::to_chars" ){
+    for(long long n = -2000; n <= 2000; n += 7){
+        for(double scale : {1.0, 10.0, 100.0, 1e3, 1e4, 1e6, 1e7}){
+            REQUIRE_NO_COUNT(matches_std_shortest(n / scale));
+            REQUIRE_NO_COUNT(matches_std_shortest(n * scale));
+            REQUIRE_NO_COUNT(matches_std_shortest(static_cast<float>(n / scale)));
+            REQUIRE_NO_COUNT(matches_std_shortest(static_cast<long double>(n) / static_cast<long double>(scale)));
+        }
+    }
+
+    for(double val : {1.0/3, 1e-300, 1e300, 4503599627370495.0, 4503599627370496.0, 0.0001, 0.001, 1.5e-5})
+        REQUIRE(matches_std_shortest(val));
+}
+
+TEST_CASE( "Thread-local float format" ){
+    const FloatFormat original = get_float_format();
+    set_float_string_precision(3);
+
+    std::string worker_out;
+    size_t worker_initial_precision;
+    std::thread worker([&worker_out, &worker_initial_precision](){
+        // Each thread starts with the default format
+        worker_initial_precision = get_float_string_precision();
+        set_float_format(FloatFormat{2, FloatStyle::Fixed});
+        write_float(worker_out, 1.0/3);
+    });
+    worker.join();
+
+    std::string out;
+    write_float(out, 1.0/3);
+
+    REQUIRE(worker_initial_precision == 6);
+    REQUIRE(worker_out == "0.33");
+    REQUIRE(out == "0.333");
+
+    set_float_format(original);
+}
 #endif
 
 TEST_CASE( "strdecimal2floatingpoint" ){
@@ -53,3 +201,80 @@ TEST_CASE( "strscientific2floatingpoint_valid_region" ){
 
     REQUIRE( std::abs(strscientific2floatingpoint(view) - 2e3) < 1e-9 );
 }
+
+TEST_CASE( "strdecimal2double" ){
+    REQUIRE( strdecimal2double("0") == 0.0 );
+    REQUIRE( strdecimal2double("000.000") == 0.0 );
+    REQUIRE( strdecimal2double("4.2") == 4.2 );
+    REQUIRE( strdecimal2double(".5") == 0.5 );
+    REQUIRE( strdecimal2double("5.") == 5.0 );
+    REQUIRE( strdecimal2double("0.000000000000000000000000000000123") == 0.000000000000000000000000000000123 );
+    REQUIRE( strdecimal2double("123456789012345678901234567890") == 123456789012345678901234567890.0 );
+
+    SECTION("Halfway between doubles rounds to even"){
+        REQUIRE( strdecimal2double("9007199254740993") == 9007199254740992.0 );
+        REQUIRE( strdecimal2double("9007199254740995") == 9007199254740996.0 );
+    }
+
+    SECTION("Digits past the significand decide ties"){
+        REQUIRE( strdecimal2double("9007199254740993.0000000000000000000000000001") == 9007199254740994.0 );
+        REQUIRE( strdecimal2double("1.00000000000000011102230246251565404236316680908203125") == 1.0 );
+        REQUIRE( strdecimal2double("1.00000000000000011102230246251565404236316680908203126") == 1.0000000000000002 );
+    }
+
+    SECTION("Valid region"){
+        std::string str("1234");
+        std::string_view view(str.data()+1, 2);
+        REQUIRE( strdecimal2double(view) == 23.0 );
+    }
+}
+
+TEST_CASE( "strscientific2double" ){
+    REQUIRE( strscientific2double("0.42e2") == 42.0 );
+    REQUIRE( strscientific2double("12.34e-2") == 12.34e-2 );
+    REQUIRE( strscientific2double("1.7976931348623157e308") == std::numeric_limits<double>::max() );
+    REQUIRE( strscientific2double("2.2250738585072014e-308") == std::numeric_limits<double>::min() );
+    REQUIRE( strscientific2double("4.9406564584124654e-324") == std::numeric_limits<double>::denorm_min() );
+    REQUIRE( strscientific2double("2.4703282292062328e-324") == std::numeric_limits<double>::denorm_min() );
+    REQUIRE( strscientific2double("2.4703282292062327e-324") == 0.0 );
+    REQUIRE( strscientific2double("1e-400") == 0.0 );
+    REQUIRE( strscientific2double("1.7976931348623159e308") == std::numeric_limits<double>::infinity() );
+    REQUIRE( strscientific2double("1e99999999999999999999") == std::numeric_limits<double>::infinity() );
+
+    SECTION("Valid region"){
+        std::string str("12e34");
+        std::string_view view(str.data()+1, 3);
+        REQUIRE( strscientific2double(view) == 2e3 );
+    }
+}
+
+TEST_CASE( "strscientific2floatingpoint correctly rounded" ){
+    REQUIRE( strscientific2floatingpoint("1.2345678901234567891e5") == 1.2345678901234567891e5L );
+    REQUIRE( strscientific2floatingpoint("3e-27") == 3e-27L );
+    REQUIRE( strscientific2floatingpoint("1.000000000000000000000000000001") == 1.000000000000000000000000000001L );
+    REQUIRE( strdecimal2floatingpoint("0.1") == 0.1L );
+}
+
+#if !defined(__GNUC__) || __GNUC__ > 8
+TEST_CASE( "strscientific2double matches std::from_chars" ){
+    std::mt19937_64 generator(42);
+    std::uniform_int_distribution<uint64_t> bit_patterns;
+    std::uniform_int_distribution<int> precisions(0, 40);
+
+    for(size_t i = 0; i < 10000; i++){
+        const uint64_t bits = bit_patterns(generator) & std::numeric_limits<int64_t>::max();
+        double val;
+        std::memcpy(&val, &bits, sizeof(double));
+        if(!std::isfinite(val)) continue;
+
+        // Long outputs exceed the 19 digits held in the significand
+        char buffer[128];
+        const auto written = std::to_chars(buffer, buffer + sizeof(buffer), val, std::chars_format::scientific, precisions(generator));
+        const std::string_view str(buffer, written.ptr - buffer);
+
+        double expected;
+        std::from_chars(str.data(), str.data() + str.size(), expected);
+        REQUIRE( strscientific2double(str) == expected );
+    }
+}
+#endif
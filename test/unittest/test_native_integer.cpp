@@ -3,8 +3,11 @@
 #include "ki_cas_native_integer.h"
 
 #include <cmath>
+#include <iterator>
 #include <limits>
+#include <memory>
 #include <optional>
+#include <vector>
 
 using namespace KiCAS2;
 
@@ -197,6 +200,115 @@ TEST_CASE( "ckd_nrt (Exhaustive)" ) {
     REQUIRE(!failing_nrt.has_value());
 }
 
+TEST_CASE( "ckd_sqrt and ckd_cbrt (batch)" ) {
+    std::vector<size_t> args;
+    for(size_t i = 0; i < 5000; i++) args.push_back(i);
+    constexpr size_t max_squarable_number = MAX >> (sizeof(size_t)*8/2);
+    for(size_t i = max_squarable_number - 300; i <= max_squarable_number; i++){
+        args.push_back(i * i);
+        args.push_back(i * i - 1);
+    }
+    const size_t max_cubeable_number = floor_nrt(MAX, 3);
+    for(size_t i = max_cubeable_number - 300; i <= max_cubeable_number; i++){
+        args.push_back(i * i * i);
+        args.push_back(i * i * i + 1);
+    }
+    args.push_back(MAX);
+
+    std::vector<size_t> results(args.size());
+    std::unique_ptr<bool[]> is_inexact(new bool[args.size()]);
+
+    const size_t num_square_candidates = ckd_sqrt(results.data(), is_inexact.get(), args.data(), args.size());
+    REQUIRE(num_square_candidates < args.size() / 2);
+    for(size_t i = 0; i < args.size(); i++){
+        size_t result;
+        const bool expected = ckd_sqrt(&result, args[i]);
+        REQUIRE(is_inexact[i] == expected);
+        if(!expected) REQUIRE(results[i] == result);
+    }
+
+    const size_t num_cube_candidates = ckd_cbrt(results.data(), is_inexact.get(), args.data(), args.size());
+    REQUIRE(num_cube_candidates < args.size() / 2);
+    for(size_t i = 0; i < args.size(); i++){
+        size_t result;
+        const bool expected = ckd_cbrt(&result, args[i]);
+        REQUIRE(is_inexact[i] == expected);
+        if(!expected) REQUIRE(results[i] == result);
+    }
+
+    REQUIRE(ckd_sqrt(results.data(), is_inexact.get(), args.data(), 0) == 0);
+}
+
+TEST_CASE( "floor_nrt" ) {
+    REQUIRE(floor_nrt(0, 2) == 0);
+    REQUIRE(floor_nrt(1, 5) == 1);
+    REQUIRE(floor_nrt(42, 1) == 42);
+    REQUIRE(floor_nrt(MAX, 2) == MAX >> (sizeof(size_t)*8/2));
+    REQUIRE(floor_nrt(MAX, sizeof(size_t)*8 - 1) == 2);
+    REQUIRE(floor_nrt(MAX, sizeof(size_t)*8) == 1);
+
+    for(size_t power = 2; power <= 8; power++){
+        for(size_t base = 2; base < 60; base++){
+            size_t raised;
+            if(ckd_pow(&raised, base, power)) break;
+            REQUIRE(floor_nrt(raised, power) == base);
+            REQUIRE(floor_nrt(raised - 1, power) == base - 1);
+            if(raised != MAX) REQUIRE(floor_nrt(raised + 1, power) == base);
+        }
+    }
+}
+
+TEST_CASE( "is_perfect_power" ) {
+    size_t root;
+
+    REQUIRE(is_perfect_power(&root, 0) == 0);
+    REQUIRE(is_perfect_power(&root, 1) == 0);
+    REQUIRE(is_perfect_power(&root, 2) == 0);
+    REQUIRE(is_perfect_power(&root, 72) == 0);
+    REQUIRE(is_perfect_power(&root, MAX) == 0);
+
+    REQUIRE(is_perfect_power(&root, 36) == 2);
+    REQUIRE(root == 6);
+
+    REQUIRE(is_perfect_power(&root, 64) == 6);
+    REQUIRE(root == 2);
+
+    REQUIRE(is_perfect_power(&root, 1000000000) == 9);
+    REQUIRE(root == 10);
+
+    REQUIRE(is_perfect_power(&root, size_t(1) << (sizeof(size_t)*8 - 1)) == sizeof(size_t)*8 - 1);
+    REQUIRE(root == 2);
+
+    constexpr size_t max_squarable_number = MAX >> (sizeof(size_t)*8/2);
+    REQUIRE(is_perfect_power(&root, max_squarable_number * max_squarable_number) == 2);
+    REQUIRE(root == max_squarable_number);
+
+    // Bases which are not themselves powers, raised to every exponent which fits
+    for(size_t base = 2; base < 2000; base++){
+        if(is_perfect_power(&root, base) != 0) continue;
+        size_t raised = base;
+        for(size_t exp = 2; !ckd_mul(&raised, raised, base); exp++){
+            REQUIRE(is_perfect_power(&root, raised) == exp);
+            REQUIRE(root == base);
+            REQUIRE(is_perfect_power(&root, raised + 1) == (raised + 1 == 9 ? 2 : 0));
+        }
+    }
+
+    const size_t args[] = {8, 10, 243, 3125, 65536};
+    size_t exponents[std::size(args)];
+    size_t roots[std::size(args)];
+    is_perfect_power(exponents, roots, args, std::size(args));
+    REQUIRE(exponents[0] == 3);
+    REQUIRE(roots[0] == 2);
+    REQUIRE(exponents[1] == 0);
+    REQUIRE(exponents[2] == 5);
+    REQUIRE(roots[2] == 3);
+    REQUIRE(exponents[3] == 5);
+    REQUIRE(roots[3] == 5);
+    REQUIRE(exponents[4] == 16);
+    REQUIRE(roots[4] == 2);
+}
+
 TEST_CASE( "ckd_pow" ) {
     size_t result;
 
@@ -207,6 +319,35 @@ TEST_CASE( "ckd_pow" ) {
     REQUIRE(result == (1uLL << (sizeof(size_t)*8-1)));
 
     REQUIRE(true == ckd_pow(&result, 2, sizeof(size_t)*8));
+
+    REQUIRE_FALSE(ckd_pow(&result, 0, 5));
+    REQUIRE(result == 0);
+    REQUIRE_FALSE(ckd_pow(&result, 1, MAX));
+    REQUIRE(result == 1);
+    REQUIRE_FALSE(ckd_pow(&result, MAX, 1));
+    REQUIRE(result == MAX);
+    REQUIRE_FALSE(ckd_pow(&result, MAX, 0));
+    REQUIRE(result == 1);
+    REQUIRE(true == ckd_pow(&result, 2, MAX));
+}
+
+TEST_CASE( "pow_overflows" ) {
+    // The maximum base of each power is the floor of the root of the maximum
+    for(size_t power = 2; power < sizeof(size_t)*8 + 2; power++){
+        const size_t max_base = floor_nrt(MAX, power);
+        REQUIRE_FALSE(pow_overflows(max_base, power));
+        REQUIRE(pow_overflows(max_base + 1, power));
+
+        size_t raised = 1;
+        bool overflowed = false;
+        for(size_t i = 0; i < power; i++) overflowed |= ckd_mul(&raised, raised, max_base + 1);
+        REQUIRE(overflowed);
+    }
+
+    REQUIRE_FALSE(pow_overflows(MAX, 0));
+    REQUIRE_FALSE(pow_overflows(MAX, 1));
+    REQUIRE_FALSE(pow_overflows(0, MAX));
+    REQUIRE_FALSE(pow_overflows(1, MAX));
 }
 
 TEST_CASE( "ckd_pow (More thorough)" ) {
@@ -286,6 +286,96 @@ TEST_CASE( "ckd_sub (NativeRational - NativeRational)" ) {
     REQUIRE(true == ckd_sub(&result, NativeRational(1, MAX-1), NativeRational(1, MAX)));
 }
 
+TEST_CASE( "ckd_pow (NativeRational ^ size_t)" ) {
+    NativeRational result;
+
+    REQUIRE_FALSE(ckd_pow(&result, NativeRational(2, 3), 4));
+    REQUIRE(result.num == 16);
+    REQUIRE(result.den == 81);
+
+    REQUIRE_FALSE(ckd_pow(&result, NativeRational(2, 3), 0));
+    REQUIRE(result.num == 1);
+    REQUIRE(result.den == 1);
+
+    REQUIRE_FALSE(ckd_pow(&result, NativeRational(0, 7), 3));
+    REQUIRE(result.num == 0);
+
+    // Not reduced when the power fits, reduced when it would not otherwise fit
+    REQUIRE_FALSE(ckd_pow(&result, NativeRational(2, 4), 2));
+    REQUIRE(result.num == 4);
+    REQUIRE(result.den == 16);
+
+    constexpr size_t half_bits = sizeof(size_t)*4;
+    const size_t big = size_t(1) << half_bits;
+    REQUIRE_FALSE(ckd_pow(&result, NativeRational(3*big, 5*big), 2));
+    REQUIRE(result.num == 9);
+    REQUIRE(result.den == 25);
+
+    REQUIRE_FALSE(ckd_pow(&result, NativeRational(1, 2), sizeof(size_t)*8 - 1));
+    REQUIRE(result.num == 1);
+    REQUIRE(result.den == size_t(1) << (sizeof(size_t)*8 - 1));
+
+    REQUIRE(true == ckd_pow(&result, NativeRational(1, 2), sizeof(size_t)*8));
+    REQUIRE(true == ckd_pow(&result, NativeRational(big, 3), 2));
+}
+
+TEST_CASE( "ckd_root (NativeRational)" ) {
+    NativeRational result;
+
+    REQUIRE_FALSE(ckd_root(&result, NativeRational(8, 27), 3));
+    REQUIRE(result.num == 2);
+    REQUIRE(result.den == 3);
+
+    REQUIRE_FALSE(ckd_root(&result, NativeRational(5, 7), 1));
+    REQUIRE(result.num == 5);
+    REQUIRE(result.den == 7);
+
+    REQUIRE_FALSE(ckd_root(&result, NativeRational(0, 7), 2));
+    REQUIRE(result.num == 0);
+
+    REQUIRE_FALSE(ckd_root(&result, NativeRational(1024, 3125), 5));
+    REQUIRE(result.num == 4);
+    REQUIRE(result.den == 5);
+
+    // Not reduced when the parts are already powers, reduced when they are only powers after reduction
+    REQUIRE_FALSE(ckd_root(&result, NativeRational(16, 64), 2));
+    REQUIRE(result.num == 4);
+    REQUIRE(result.den == 8);
+
+    REQUIRE_FALSE(ckd_root(&result, NativeRational(2, 8), 2));
+    REQUIRE(result.num == 1);
+    REQUIRE(result.den == 2);
+
+    REQUIRE(true == ckd_root(&result, NativeRational(2, 3), 2));
+    REQUIRE(true == ckd_root(&result, NativeRational(8, 9), 3));
+    REQUIRE(true == ckd_root(&result, NativeRational(MAX, 1), 2));
+}
+
+TEST_CASE( "ckd_pow (NativeRational ^ NativeRational)" ) {
+    NativeRational result;
+
+    REQUIRE_FALSE(ckd_pow(&result, NativeRational(8, 27), NativeRational(2, 3)));
+    REQUIRE(result.num == 4);
+    REQUIRE(result.den == 9);
+
+    REQUIRE_FALSE(ckd_pow(&result, NativeRational(8, 27), NativeRational(4, 6)));
+    REQUIRE(result.num == 4);
+    REQUIRE(result.den == 9);
+
+    REQUIRE_FALSE(ckd_pow(&result, NativeRational(8, 27), NativeRational(0, 6)));
+    REQUIRE(result.num == 1);
+    REQUIRE(result.den == 1);
+
+    REQUIRE(true == ckd_pow(&result, NativeRational(2, 27), NativeRational(2, 3)));
+
+    constexpr size_t half_bits = sizeof(size_t)*4;
+    REQUIRE_FALSE(ckd_pow(&result, NativeRational(1, size_t(1) << half_bits), NativeRational(3, 2)));
+    REQUIRE(result.num == 1);
+    REQUIRE(result.den == size_t(1) << (half_bits + half_bits/2));
+
+    REQUIRE(true == ckd_pow(&result, NativeRational(1, 4), NativeRational(sizeof(size_t)*8, 1)));
+}
+
 TEST_CASE( "write_native_rational" ) {
     std::string str = "x + ";
     NativeRational num(3,2);
@@ -0,0 +1,100 @@
+#include <catch2/catch_test_macros.hpp>
+
+#include "ki_cas_number_batch_writer.h"
+
+#include "ki_cas_big_num_wrapper.h"
+
+using namespace KiCAS2;
+
+TEST_CASE( "NumberBatchWriter" ){
+    std::string str = "f = ";
+    NumberBatchWriter writer;
+
+    SECTION("Empty"){
+        writer.write(str);
+        REQUIRE(str == "f = ");
+    }
+
+    SECTION("Native"){
+        writer.add(42);
+        writer.addText(", ");
+        writer.add(NativeRational(1, 3));
+        writer.write(str);
+        REQUIRE(str == "f = 42, 1/3");
+    }
+
+    SECTION("Sum"){
+        fmpz_t big;
+        fmpz_init(big);
+        fmpz_fac_ui(big, 30);
+        fmpz_neg(big, big);
+
+        fmpq_t rat;
+        fmpq_init(rat);
+        fmpq_set_si(rat, -1, 7);
+
+        fmpz_t small;
+        fmpz_init_set_si(small, -5);
+
+        writer.addTerm(big);
+        writer.addTerm(7);
+        writer.addTerm(rat);
+        writer.addTerm(small);
+        writer.addTerm(NativeRational(2, 9));
+        writer.write(str);
+        REQUIRE(str == "f = -265252859812191058636308480000000 + 7 - 1/7 - 5 + 2/9");
+
+        fmpz_clear(big);
+        fmpq_clear(rat);
+        fmpz_clear(small);
+    }
+
+    SECTION("Single allocation"){
+        fmpz_t vals[100];
+        for(size_t i = 0; i < 100; i++){
+            fmpz_init(vals[i]);
+            fmpz_fac_ui(vals[i], i);
+            writer.addTerm(vals[i]);
+        }
+
+        std::string expected = "f = ";
+        for(size_t i = 0; i < 100; i++){
+            if(i != 0) expected += " + ";
+            write_big_int(expected, vals[i]);
+        }
+
+        const size_t upper_bound = writer.sizeUpperBound();
+        str.reserve(str.size() + upper_bound);
+        const auto capacity = str.capacity();
+        writer.write(str);
+        REQUIRE(str == expected);
+        REQUIRE(str.capacity() == capacity);
+
+        for(size_t i = 0; i < 100; i++) fmpz_clear(vals[i]);
+    }
+
+    SECTION("Zero"){
+        fmpz_t zero;
+        fmpz_init(zero);
+        fmpq_t rat_zero;
+        fmpq_init(rat_zero);
+
+        writer.add(zero);
+        writer.addTerm(rat_zero);
+        writer.write(str);
+        REQUIRE(str == "f = 0 + 0");
+
+        fmpq_clear(rat_zero);
+        fmpz_clear(zero);
+    }
+
+    SECTION("Span overflow"){
+        writer.add(1234);
+        char buffer[8];
+        SpanSink sink(buffer, sizeof(buffer));
+        writer.write(sink);
+        REQUIRE(sink.overflowed());
+    }
+
+    LEAK_CHECK_REQUIRE(isAllGmpMemoryFreed_resetIfNot());
+}
@@ -0,0 +1,98 @@
+#include <catch2/catch_test_macros.hpp>
+
+#include "ki_cas_numeric_allocator.h"
+
+#include "ki_cas_allocation_tracker.h"
+#include "ki_cas_big_num_wrapper.h"
+#include "ki_cas_gmp_arena.h"
+#include <atomic>
+#include <cstring>
+
+using namespace KiCAS2;
+
+static std::atomic<size_t> gmp_calls = 0;
+static std::atomic<size_t> flint_calls = 0;
+static NumericAllocator beneath_counting = {};
+
+static void count(AllocationSource source) noexcept {
+    (source == AllocationSource::Gmp ? gmp_calls : flint_calls).fetch_add(1, std::memory_order_relaxed);
+}
+
+static void* countingAllocate(size_t n, AllocationSource source) {
+    count(source);
+    return beneath_counting.allocate(n, source);
+}
+
+static void* countingReallocate(void* p, size_t old, size_t n, AllocationSource source) {
+    count(source);
+    return beneath_counting.reallocate(p, old, n, source);
+}
+
+static void countingDeallocate(void* p, size_t old, AllocationSource source) noexcept {
+    count(source);
+    beneath_counting.deallocate(p, old, source);
+}
+
+static constexpr NumericAllocator COUNTING_ALLOCATOR = {countingAllocate, countingReallocate, countingDeallocate};
+
+TEST_CASE( "Numeric allocator routes GMP and Flint" ){
+    NumericAllocatorScope allocator_scope;
+    beneath_counting = layer_numeric_allocator(COUNTING_ALLOCATOR);
+    REQUIRE(is_numeric_allocator_installed(COUNTING_ALLOCATOR));
+
+    const size_t gmp_before = gmp_calls.load();
+    mpz_t val;
+    mpz_init_set_str(val, "123456789012345678901234567890123456789012345678901234567890", 10);
+    mpz_clear(val);
+    REQUIRE(gmp_calls.load() > gmp_before);
+
+    const size_t flint_before = flint_calls.load();
+    char* str = static_cast<char*>(flint_malloc(16));
+    std::strcpy(str, "allocated");
+    str = static_cast<char*>(flint_realloc(str, 4096));
+    REQUIRE(std::strcmp(str, "allocated") == 0);
+    flint_free(str);
+
+    unsigned char* zeroed = static_cast<unsigned char*>(flint_calloc(64, 2));
+    for(size_t i = 0; i < 128; i++) REQUIRE(zeroed[i] == 0);
+    flint_free(zeroed);
+    REQUIRE(flint_calls.load() == flint_before + 5);
+
+    SECTION("Scope removes the layer"){
+        const NumericAllocator installed = numeric_allocator();
+        {
+            NumericAllocatorScope inner_scope;
+            install_gmp_arena();
+            REQUIRE(is_gmp_arena_installed());
+        }
+        REQUIRE(!is_gmp_arena_installed());
+        REQUIRE(numeric_allocator() == installed);
+        REQUIRE(is_numeric_allocator_installed(COUNTING_ALLOCATOR));
+    }
+
+    LEAK_CHECK_REQUIRE(isAllGmpMemoryFreed_resetIfNot());
+}
+
+TEST_CASE( "Allocation tracker counts Flint" ){
+    NumericAllocatorScope allocator_scope;
+    install_allocation_tracker();
+    REQUIRE(is_allocation_tracker_installed());
+
+    const AllocationStats before = allocation_stats(AllocationSource::Flint);
+    void* p = flint_malloc(100);
+    p = flint_realloc(p, 200);
+    const AllocationStats during = allocation_stats(AllocationSource::Flint);
+    flint_free(p);
+    const AllocationStats after = allocation_stats(AllocationSource::Flint);
+
+    REQUIRE(during.num_allocations == before.num_allocations + 1);
+    REQUIRE(during.num_reallocations == before.num_reallocations + 1);
+    REQUIRE(during.liveAllocations() == before.liveAllocations() + 1);
+    REQUIRE(after.liveAllocations() == before.liveAllocations());
+
+    // Flint does not report freed sizes, so bytes are not counted
+    REQUIRE(after.live_bytes == 0);
+    REQUIRE(after.peak_bytes == 0);
+
+    LEAK_CHECK_REQUIRE(isAllGmpMemoryFreed_resetIfNot());
+}
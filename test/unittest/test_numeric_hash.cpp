@@ -0,0 +1,107 @@
+#include <catch2/catch_test_macros.hpp>
+
+#include "ki_cas_numeric_hash.h"
+
+#include "ki_cas_big_num_wrapper.h"
+#include "ki_cas_intern_table.h"
+#include <unordered_set>
+
+using namespace KiCAS2;
+
+TEST_CASE( "numeric_hash is equal across tiers" ){
+    {
+        const size_t three = numeric_hash(size_t(3));
+        REQUIRE(numeric_hash(3) == three);
+        REQUIRE(numeric_hash(NativeRational(3, 1)) == three);
+        REQUIRE(numeric_hash(NativeRational(6, 2)) == three);
+        REQUIRE(numeric_hash(Int(3)) == three);
+        REQUIRE(numeric_hash(rat_from_decimal_str("3.00")) == three);
+        REQUIRE(numeric_hash(uint128_t(3)) == three);
+        REQUIRE(numeric_hash(uint256_t(3)) == three);
+        REQUIRE(numeric_hash(uint512_t(3)) == three);
+        REQUIRE(numeric_hash(Int(-3)) == numeric_hash(-3));
+        REQUIRE(numeric_hash(Int(-3)) != three);
+        REQUIRE(numeric_hash(Int(0)) == numeric_hash(uint256_t(0)));
+
+        const size_t quarter = numeric_hash(NativeRational(1, 4));
+        REQUIRE(numeric_hash(NativeRational(3, 12)) == quarter);
+        REQUIRE(numeric_hash(rat_from_decimal_str("0.25")) == quarter);
+        REQUIRE(numeric_hash(NativeRational(4, 1)) != quarter);
+
+        // Beyond the range of a small fmpz but within a word
+        const size_t max_word = numeric_hash(std::numeric_limits<uint64_t>::max());
+        const Int max_word_int = int_from_strview("18446744073709551615");
+        REQUIRE(!max_word_int.isSmall());
+        REQUIRE(numeric_hash(max_word_int) == max_word);
+        REQUIRE(numeric_hash(uint128_t(std::numeric_limits<uint64_t>::max())) == max_word);
+        REQUIRE(numeric_hash(COEFF_TO_PTR(*max_word_int.get())) == max_word);
+
+        const uint256_t big = uint256_t(1) << 200;
+        const Int big_int = int_from_strview("1606938044258990275541962092341162602522202993782792835301376");
+        REQUIRE(numeric_hash(big_int) == numeric_hash(big));
+        REQUIRE(numeric_hash(uint512_t(big)) == numeric_hash(big));
+        REQUIRE(numeric_hash(u256_to_int<true>(big)) == numeric_hash(big, true));
+        REQUIRE(numeric_hash(big, true) != numeric_hash(big));
+
+        const Rat big_rat = rat_from_scientific_str("1.5e-30");
+        REQUIRE(numeric_hash(big_rat) != numeric_hash(rat_from_scientific_str("1.5e30")));
+        REQUIRE(numeric_hash(big_rat) == numeric_hash(rat_from_scientific_str("15e-31")));
+
+        SECTION("Interned values cache the same hash"){
+            InternTable table;
+            REQUIRE(numeric_hash(table.intern(NativeRational(6, 2))) == three);
+            REQUIRE(numeric_hash(table.intern(big_rat.get())) == numeric_hash(big_rat));
+        }
+    }
+
+    LEAK_CHECK_REQUIRE(isAllGmpMemoryFreed_resetIfNot());
+}
+
+TEST_CASE( "NumericHash with cached hashes" ){
+    {
+        std::unordered_set<Hashed<Int>, NumericHash> memo;
+        memo.insert(Hashed<Int>(int_from_strview("123456789012345678901234567890")));
+        memo.insert(Hashed<Int>(Int(7)));
+        REQUIRE(memo.size() == 2);
+        REQUIRE(memo.contains(Hashed<Int>(int_from_strview("123456789012345678901234567890"))));
+        REQUIRE(!memo.contains(Hashed<Int>(Int(8))));
+        REQUIRE(NumericHash()(Hashed<Int>(Int(7))) == NumericHash()(size_t(7)));
+    }
+
+    LEAK_CHECK_REQUIRE(isAllGmpMemoryFreed_resetIfNot());
+}
+
+TEST_CASE( "NumericEqual for heterogeneous lookup" ){
+    {
+        std::unordered_set<Int, NumericHash, NumericEqual> ints;
+        ints.insert(int_from_strview("123456789012345678901234567890"));
+        ints.insert(Int(-7));
+        ints.insert(Int(0));
+
+        const Int big = int_from_strview("123456789012345678901234567890");
+        REQUIRE(ints.contains(big));
+        REQUIRE(ints.contains(big.get()));
+        REQUIRE(ints.contains(-7));
+        REQUIRE(ints.contains(size_t(0)));
+        REQUIRE(ints.contains(NativeRational(0, 5)));
+        REQUIRE(!ints.contains(7));
+        REQUIRE(!ints.contains(size_t(-7)));
+
+        std::unordered_set<Hashed<Rat>, NumericHash, NumericEqual> rats;
+        rats.insert(Hashed<Rat>(rat_from_decimal_str("1.5")));
+        rats.insert(Hashed<Rat>(Rat::adopt({-4, 1})));
+        REQUIRE(rats.contains(NativeRational(6, 4)));
+        REQUIRE(rats.contains(Hashed<Rat>(rat_from_decimal_str("1.50"))));
+        REQUIRE(rats.contains(-4));
+        REQUIRE(rats.contains(Int(-4)));
+        REQUIRE(!rats.contains(NativeRational(3, 1)));
+        REQUIRE(!rats.contains(4));
+
+        // Either operand may be the container key
+        REQUIRE(NumericEqual()(NativeRational(12, 4), Int(3)));
+        REQUIRE(NumericEqual()(Int(3), Rat::adopt({3, 1})));
+        REQUIRE(!NumericEqual()(Rat::adopt({3, 2}), Int(3)));
+    }
+
+    LEAK_CHECK_REQUIRE(isAllGmpMemoryFreed_resetIfNot());
+}
@@ -0,0 +1,236 @@
+#include <catch2/catch_test_macros.hpp>
+
+#include "ki_cas_output_sink.h"
+
+#include "ki_cas_big_num_wrapper.h"
+#include "ki_cas_kmpz.h"
+#include "ki_cas_native_float.h"
+#include "ki_cas_native_integer.h"
+#include "ki_cas_native_rational.h"
+#include <algorithm>
+#include <cstdio>
+
+#ifdef _WIN32
+#include <io.h>
+#define fileno _fileno
+#else
+#include <chrono>
+#include <csignal>
+#include <fcntl.h>
+#include <pthread.h>
+#include <thread>
+#include <unistd.h>
+#endif
+
+using namespace KiCAS2;
+
+TEST_CASE( "StringSink" ){
+    std::string str = "x + ";
+    StringSink sink(str);
+
+    write_native_int(sink, 42);
+    REQUIRE(str == "x + 42");
+
+    sink_append(sink, " + ");
+    write_native_rational(sink, NativeRational(1, 3));
+    REQUIRE(str == "x + 42 + 1/3");
+
+    sink_append(sink, " + ");
+    write_native_rational<TYPESET_OUTPUT>(sink, NativeRational(2, 5));
+    REQUIRE(str == "x + 42 + 1/3 + ⁜f⏴2⏵⏴5⏵");
+}
+
+TEST_CASE( "SpanSink" ){
+    char buffer[64];
+
+    SECTION("Fits"){
+        SpanSink sink(buffer, sizeof(buffer));
+        write_native_int(sink, 1234);
+        sink_append(sink, ", ");
+        write_uint128(sink, uint128_t(1) << 100);
+        REQUIRE_FALSE(sink.overflowed());
+        REQUIRE(sink.view() == "1234, 1267650600228229401496703205376");
+    }
+
+    SECTION("Overflow"){
+        SpanSink sink(buffer, 8);
+        write_native_int(sink, 1234);
+        REQUIRE(sink.overflowed());
+        REQUIRE(sink.view().empty());
+
+        // Output stops after the first overflow
+        sink_append(sink, "1");
+        REQUIRE(sink.view().empty());
+    }
+}
+
+TEST_CASE( "ArenaSink" ){
+    ArenaSink sink(32);
+
+    std::string expected;
+    for(size_t i = 0; i < 100; i++){
+        write_native_int(sink, i);
+        sink_append(sink, " ");
+        expected += std::to_string(i) + ' ';
+    }
+
+    REQUIRE(sink.size() == expected.size());
+    REQUIRE(sink.numBlocks() > 1);
+    REQUIRE(sink.str() == expected);
+
+    sink.clear();
+    REQUIRE(sink.size() == 0);
+}
+
+TEST_CASE( "FileDescriptorSink" ){
+    std::FILE* file = std::tmpfile();
+    REQUIRE(file != nullptr);
+
+    {
+        FileDescriptorSink sink(fileno(file), 16);
+        for(size_t i = 0; i < 10; i++){
+            write_native_int(sink, 1000 + i);
+            sink_append(sink, ";");
+        }
+
+        // A single number larger than the buffer
+        fmpz_t val;
+        fmpz_init(val);
+        fmpz_fac_ui(val, 30);
+        sink_append(sink, "30! = ");
+        write_big_int(sink, val);
+        fmpz_clear(val);
+
+        REQUIRE_FALSE(sink.flush());
+        REQUIRE_FALSE(sink.failed());
+    }
+
+    std::rewind(file);
+    char buffer[256] = { 0 };
+    const size_t num_read = std::fread(buffer, 1, sizeof(buffer), file);
+    std::fclose(file);
+
+    REQUIRE(std::string(buffer, num_read) ==
+            "1000;1001;1002;1003;1004;1005;1006;1007;1008;1009;30! = 265252859812191058636308480000000");
+
+    LEAK_CHECK_REQUIRE(isAllGmpMemoryFreed_resetIfNot());
+}
+
+#ifndef _WIN32
+static void ignore_signal(int) {}
+
+TEST_CASE( "FileDescriptorSink retries interrupted writes" ){
+    int fds[2];
+    REQUIRE(pipe(fds) == 0);
+
+    // Fill the pipe, so that the next write blocks until the reader drains it
+    fcntl(fds[1], F_SETFL, O_NONBLOCK);
+    const std::string filler(4096, 'x');
+    size_t num_filled = 0;
+    for(ssize_t written; (written = write(fds[1], filler.data(), filler.size())) > 0;) num_filled += written;
+    fcntl(fds[1], F_SETFL, 0);
+
+    // Without SA_RESTART, a signal arriving while write blocks makes it fail with EINTR
+    struct sigaction action = {};
+    action.sa_handler = ignore_signal;
+    struct sigaction previous;
+    sigaction(SIGUSR1, &action, &previous);
+
+    bool failed = true;
+    std::thread writer([&failed, fd = fds[1]](){
+        FileDescriptorSink sink(fd, 16);
+        sink_append(sink, "done");
+        failed = sink.flush();
+    });
+    std::this_thread::sleep_for(std::chrono::milliseconds(50));
+    pthread_kill(writer.native_handle(), SIGUSR1);
+    std::this_thread::sleep_for(std::chrono::milliseconds(50));
+
+    // Drain the filler to unblock the writer, then collect whatever it wrote
+    std::string drained;
+    char buffer[4096];
+    while(drained.size() < num_filled){
+        const ssize_t num_read = read(fds[0], buffer, std::min(sizeof(buffer), num_filled - drained.size()));
+        REQUIRE(num_read > 0);
+        drained.append(buffer, num_read);
+    }
+    writer.join();
+    fcntl(fds[0], F_SETFL, O_NONBLOCK);
+    for(ssize_t num_read; (num_read = read(fds[0], buffer, sizeof(buffer))) > 0;) drained.append(buffer, num_read);
+    sigaction(SIGUSR1, &previous, nullptr);
+    close(fds[0]);
+    close(fds[1]);
+
+    REQUIRE_FALSE(failed);
+    REQUIRE(drained.substr(num_filled) == "done");
+}
+#endif
+
+TEST_CASE( "Big number sinks" ){
+    std::string str;
+    StringSink sink(str);
+
+    fmpq_t val;
+    fmpq_init(val);
+    fmpq_set_si(val, -31, 3);
+    fmpz_fac_ui(fmpq_denref(val), 30);
+
+    write_big_rational(sink, val);
+    REQUIRE(str == "-31/265252859812191058636308480000000");
+
+    str.clear();
+    write_big_rational<TYPESET_OUTPUT>(sink, val);
+    REQUIRE(str == "-⁜f⏴31⏵⏴265252859812191058636308480000000⏵");
+    fmpq_clear(val);
+
+    mpz_t big;
+    mpz_init_set_str(big, "-123456789012345678901234567890", 10);
+    str.clear();
+    write_big_int(sink, big);
+    REQUIRE(str == "-123456789012345678901234567890");
+    mpz_clear(big);
+
+    LEAK_CHECK_REQUIRE(isAllGmpMemoryFreed_resetIfNot());
+}
+
+/// A sink defined outside the library, which counts the bytes written to a fixed buffer
+class CountingSink {
+public:
+    char* prepare(size_t n) {
+        buffer.resize(std::max(buffer.size(), n));
+        return buffer.data();
+    }
+    void commit(char* end) noexcept { num_bytes += end - buffer.data(); }
+
+    size_t num_bytes = 0;
+
+private:
+    std::string buffer;
+};
+
+TEST_CASE( "User-defined sink" ){
+    static_assert(OutputSink<CountingSink>);
+    CountingSink sink;
+
+    write_native_int(sink, 1234);
+    write_native_rational<TYPESET_OUTPUT>(sink, NativeRational(2, 5));
+    fmpz_t big;
+    fmpz_init(big);
+    fmpz_fac_ui(big, 30);
+    write_big_int(sink, big);
+    fmpz_clear(big);
+    write_uint128(sink, uint128_t(1) << 100);
+
+    REQUIRE(sink.num_bytes == 4 + std::string("⁜f⏴2⏵⏴5⏵").size() + 33 + 31);
+
+    LEAK_CHECK_REQUIRE(isAllGmpMemoryFreed_resetIfNot());
+}
+
+#if !defined(__GNUC__) || __GNUC__ > 8
+TEST_CASE( "Float sink" ){
+    char buffer[32];
+    SpanSink sink(buffer, sizeof(buffer));
+    write_float(sink, 1.5);
+    REQUIRE(sink.view() == "1.5");
+}
+#endif
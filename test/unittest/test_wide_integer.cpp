@@ -0,0 +1,101 @@
+#include <catch2/catch_test_macros.hpp>
+
+#include "ki_cas_wide_integer.h"
+
+#include "ki_cas_big_num_wrapper.h"
+#include <limits>
+
+using namespace KiCAS2;
+
+static bool equals(const Int& val, const std::string& expected) {
+    char buffer[512u];
+    return fmpz_get_str(buffer, 10, val.get()) == expected;
+}
+
+TEST_CASE( "ckd_add wide" ){
+    const uint256_t max = std::numeric_limits<uint256_t>::max();
+    uint256_t result;
+    REQUIRE(!ckd_add(&result, max - 1, uint256_t(1)));
+    REQUIRE(result == max);
+    REQUIRE(ckd_add(&result, max, uint256_t(1)));
+
+    uint512_t wide;
+    REQUIRE(!ckd_add(&wide, uint512_t(max), uint512_t(1)));
+    REQUIRE(wide == uint512_t(1) << 256);
+    REQUIRE(ckd_add(&wide, std::numeric_limits<uint512_t>::max(), uint512_t(1)));
+}
+
+TEST_CASE( "ckd_mul wide" ){
+    uint256_t result;
+    REQUIRE(!ckd_mul(&result, uint256_t(0), std::numeric_limits<uint256_t>::max()));
+    REQUIRE(result == 0);
+
+    const uint256_t two_128 = uint256_t(1) << 128;
+    REQUIRE(!ckd_mul(&result, two_128 - 1, two_128 - 1));
+    REQUIRE(result == ((two_128 - 1) << 128) - (two_128 - 1));
+    REQUIRE(ckd_mul(&result, two_128, two_128));
+
+    // 129 and 128 bits, the boundary case where the product may or may not fit
+    REQUIRE(!ckd_mul(&result, two_128 + 1, two_128 - 1));
+    REQUIRE(result == std::numeric_limits<uint256_t>::max());
+    REQUIRE(ckd_mul(&result, two_128 + 2, two_128 - 1));
+
+    uint512_t wide;
+    REQUIRE(!ckd_mul(&wide, uint512_t(1) << 255, uint512_t(1) << 256));
+    REQUIRE(wide == uint512_t(1) << 511);
+    REQUIRE(ckd_mul(&wide, uint512_t(1) << 256, uint512_t(1) << 256));
+}
+
+TEST_CASE( "ckd_pow wide" ){
+    uint256_t result;
+    REQUIRE(!ckd_pow(&result, uint256_t(3), 161));
+    REQUIRE(intx::to_string(result) ==
+            "65542350158517637872691969508970705427701150314738255642438471845988797065603");
+    REQUIRE(ckd_pow(&result, uint256_t(3), 162));
+    REQUIRE(!ckd_pow(&result, uint256_t(2), 255));
+    REQUIRE(ckd_pow(&result, uint256_t(2), 256));
+    REQUIRE(!ckd_pow(&result, uint256_t(12345), 0));
+    REQUIRE(result == 1);
+
+    uint512_t wide;
+    REQUIRE(!ckd_pow(&wide, uint512_t(1) << 64, 7));
+    REQUIRE(wide == uint512_t(1) << 448);
+    REQUIRE(ckd_pow(&wide, uint512_t(1) << 64, 8));
+}
+
+TEST_CASE( "ckd_div wide" ){
+    uint256_t result;
+    const uint256_t big = intx::from_string<uint256_t>("1000000000000000000000000000000000000000000000000000000000000");
+    REQUIRE(!ckd_div(&result, big, uint256_t(1) << 60));
+    REQUIRE(result == intx::from_string<uint256_t>("867361737988403547205962240695953369140625"));
+    REQUIRE(ckd_div(&result, big, uint256_t(3)));
+
+    uint512_t wide;
+    REQUIRE(!ckd_div(&wide, uint512_t(big) * big, uint512_t(big)));
+    REQUIRE(wide == big);
+}
+
+TEST_CASE( "promote wide" ){
+    {
+        const uint256_t max = std::numeric_limits<uint256_t>::max();
+        REQUIRE(promote_add(uint256_t(2), uint256_t(3)).isSmall());
+        REQUIRE(equals(promote_add(max, max), "231584178474632390847141970017375815706539969331281128078915168015826259279870"));
+        REQUIRE(equals(promote_add(std::numeric_limits<uint512_t>::max(), uint512_t(1)), "13407807929942597099574024998205846127479365820592393377723561443721764030073546976801874298166903427690031858186486050853753882811946569946433649006084096"));
+
+        REQUIRE(promote_mul(uint256_t(1) << 20, uint256_t(1) << 20).isSmall());
+        REQUIRE(equals(promote_mul(max, max), intx::to_string(intx::umul(max, max))));
+
+        const uint512_t wide_max = std::numeric_limits<uint512_t>::max();
+        REQUIRE(equals(promote_mul(wide_max, uint512_t(2)), intx::to_string(intx::umul(wide_max, uint512_t(2)))));
+        REQUIRE(equals(promote_mul(uint512_t(max), uint512_t(max)), intx::to_string(intx::umul(max, max))));
+
+        REQUIRE(equals(promote_pow(uint256_t(10), 30), "1000000000000000000000000000000"));
+        Int expected;
+        fmpz_set_ui(expected.get(), 10);
+        fmpz_pow_ui(expected.get(), expected.get(), 200);
+        const Int power = promote_pow(uint512_t(10), 200);
+        REQUIRE(fmpz_equal(power.get(), expected.get()));
+    }
+
+    LEAK_CHECK_REQUIRE(isAllGmpMemoryFreed_resetIfNot());
+}